@@ -0,0 +1,235 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+// Editor benchmark, built once per plugin against its shared code. The
+// editor is created off-screen, without a window, and the main thread acts
+// as the message thread:
+//
+// - paint: the whole editor, children included, is rendered into an image
+//   at several sizes within its resize limits;
+// - resized: every channel is selected in turn, each selection laying the
+//   editor out again (skipped by editors without a channel selector);
+// - sweep: another thread sets every parameter, then measures how long the
+//   message thread takes to bring all the attachments up to date, while the
+//   automation goes on.
+//
+// Usage: <Plugin>EditorBenchmark [--repetitions N]
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// Component ID of the channel selector of the editors
+constexpr const char* channelSelectorID = "selectChannel";
+constexpr int numSizes = 4;
+
+void printTimes(const juce::String& what, std::vector<double> times)
+{
+    if (times.empty())
+    {
+        return;
+    }
+
+    std::sort(times.begin(), times.end());
+    std::printf("%-24s median %8.3f ms, min %8.3f ms, max %8.3f ms\n", what.toRawUTF8(), times[times.size() / 2], times.front(), times.back());
+}
+
+template <typename Function>
+double timeMilliseconds(Function&& function)
+{
+    const auto start = Clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Sizes from the smallest to the largest allowed, keeping the aspect ratio
+// when the editor fixes one
+std::vector<juce::Rectangle<int>> chooseSizes(juce::AudioProcessorEditor& editor)
+{
+    std::vector<juce::Rectangle<int>> sizes;
+    const auto* constrainer = editor.getConstrainer();
+
+    if (constrainer == nullptr)
+    {
+        sizes.push_back(editor.getLocalBounds());
+        return sizes;
+    }
+
+    const double aspectRatio = constrainer->getFixedAspectRatio();
+
+    for (int i = 0; i < numSizes; ++i)
+    {
+        const double position = (double)i / (double)(numSizes - 1);
+        const int width = juce::roundToInt(juce::jmap(position, (double)constrainer->getMinimumWidth(), (double)constrainer->getMaximumWidth()));
+        const int height = aspectRatio > 0.0 ? juce::roundToInt((double)width / aspectRatio)
+                                             : juce::roundToInt(juce::jmap(position, (double)constrainer->getMinimumHeight(), (double)constrainer->getMaximumHeight()));
+        sizes.emplace_back(width, height);
+    }
+
+    return sizes;
+}
+
+void benchmarkPaint(juce::AudioProcessorEditor& editor, int repetitions)
+{
+    const auto initialBounds = editor.getLocalBounds();
+
+    for (const auto& size : chooseSizes(editor))
+    {
+        editor.setSize(size.getWidth(), size.getHeight());
+
+        juce::Image image(juce::Image::ARGB, size.getWidth(), size.getHeight(), true);
+        std::vector<double> times;
+
+        for (int i = 0; i < repetitions; ++i)
+        {
+            image.clear(image.getBounds());
+
+            times.push_back(timeMilliseconds([&]
+            {
+                juce::Graphics g(image);
+                editor.paintEntireComponent(g, true);
+            }));
+        }
+
+        printTimes("paint " + juce::String(size.getWidth()) + "x" + juce::String(size.getHeight()), times);
+    }
+
+    editor.setSize(initialBounds.getWidth(), initialBounds.getHeight());
+}
+
+void benchmarkResized(juce::AudioProcessorEditor& editor, int repetitions)
+{
+    auto* selector = dynamic_cast<juce::ComboBox*>(editor.findChildWithID(channelSelectorID));
+
+    if (selector == nullptr)
+    {
+        std::printf("%-24s no channel selector\n", "resized");
+        return;
+    }
+
+    const int initialId = selector->getSelectedId();
+    std::vector<double> times;
+
+    for (int i = 0; i < repetitions; ++i)
+    {
+        for (int item = 0; item < selector->getNumItems(); ++item)
+        {
+            const int id = selector->getItemId(item);
+            times.push_back(timeMilliseconds([&] { selector->setSelectedId(id, juce::sendNotificationSync); }));
+        }
+    }
+
+    selector->setSelectedId(initialId, juce::sendNotificationSync);
+    printTimes("resized per channel", times);
+}
+
+// The automation thread sets all the parameters, then posts a message behind
+// the attachment updates and waits for it; the time until it is delivered is
+// the time taken by the message thread to catch up. The main thread runs the
+// dispatch loop meanwhile.
+void benchmarkSweep(juce::AudioProcessor& processor, int repetitions)
+{
+    const auto& parameters = processor.getParameters();
+    std::vector<double> times;
+
+    std::thread automation([&]
+    {
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> value(0.0f, 1.0f);
+
+        for (int i = 0; i < repetitions; ++i)
+        {
+            juce::WaitableEvent delivered;
+
+            for (auto* parameter : parameters)
+            {
+                parameter->setValueNotifyingHost(value(rng));
+            }
+
+            const auto start = Clock::now();
+            juce::MessageManager::callAsync([&]
+            {
+                times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+                delivered.signal();
+            });
+
+            delivered.wait();
+        }
+
+        juce::MessageManager::getInstance()->stopDispatchLoop();
+    });
+
+    juce::MessageManager::getInstance()->runDispatchLoop();
+    automation.join();
+
+    printTimes("sweep of " + juce::String(parameters.size()) + " parameters", times);
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int repetitions = 20;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc)
+        {
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        }
+        else
+        {
+            std::printf("Usage: %s [--repetitions N]\n", argv[0]);
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    std::unique_ptr<juce::AudioProcessor> processor(createPluginFilter());
+    std::unique_ptr<juce::AudioProcessorEditor> editor(processor->createEditorIfNeeded());
+
+    if (editor == nullptr)
+    {
+        std::printf("%s has no editor\n", processor->getName().toRawUTF8());
+        return 1;
+    }
+
+    std::printf("%s editor, %d repetitions\n", processor->getName().toRawUTF8(), repetitions);
+
+    benchmarkPaint(*editor, repetitions);
+    benchmarkResized(*editor, repetitions);
+    benchmarkSweep(*processor, repetitions);
+
+    editor.reset();
+    return 0;
+}
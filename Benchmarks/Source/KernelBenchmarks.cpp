@@ -0,0 +1,510 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <juce_dsp/juce_dsp.h>
+#include "soutel/include/soutel/ringmod.h"
+#include "CpuDispatch.h"
+#include "DelayLine.h"
+#include "HalfBandOversampler.h"
+#include "LadderBank.h"
+#include "Mixing.h"
+#include "PerfCounters.h"
+#include "RingOscillator.h"
+#include "SmootherBank.h"
+
+// Microbenchmarks of the primitives the engines are built on, each run in
+// isolation on a single channel: the calling thread is pinned to one core,
+// the kernel is warmed up, then the median of several measurements is
+// reported per sample, with the hardware counters when perf_event is
+// available. The kernels run through CpuDispatch, with the level selected
+// for this machine unless another one is given with --isa.
+//
+// Usage: Plug64KernelBenchmarks [--core N] [--filter text] [--repetitions N] [--isa level]
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 512;
+constexpr int warmupBlocks = 500;
+constexpr int measuredBlocks = 200;
+
+CpuDispatch::Level kernelLevel = CpuDispatch::Level::baseline;
+
+struct KernelBenchmark
+{
+    std::string name;
+
+    // Processes blockSize samples from input to output
+    std::function<void(const float*, float*)> process;
+};
+
+std::vector<float> makeNoise(std::uint32_t seed)
+{
+    std::vector<float> noise(blockSize);
+
+    for (auto& sample : noise)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        sample = (float)((double)seed / 4294967295.0 - 0.5);
+    }
+
+    return noise;
+}
+
+void addDelayBenchmarks(std::vector<KernelBenchmark>& benchmarks)
+{
+    struct Modulation
+    {
+        const char* name;
+        float rate;
+        float depth;
+    };
+
+    const Modulation modulations[] = {
+        {"static time", 0.0f, 0.0f},
+        {"slow time modulation", 0.5f, 5.0f},
+        {"fast time modulation", 50.0f, 1.0f}};
+
+    // Linear for Eco and Standard, cubic for High
+    const std::pair<DelayLine::Interpolation, const char*> interpolations[] = {
+        {DelayLine::Interpolation::linear, "linear"},
+        {DelayLine::Interpolation::cubic, "cubic"}};
+
+    // Time in ms, set on every sample as DelayEngine does
+    for (const auto& [interpolation, interpolationName] : interpolations)
+    {
+        for (const auto& modulation : modulations)
+        {
+            auto delay = std::make_shared<DelayLine>();
+            delay->prepare(sampleRate, 5000.0f);
+            delay->setFeedback(0.5f);
+            delay->setInterpolation(interpolation);
+
+            auto times = std::make_shared<std::vector<float>>(blockSize);
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const double phase = 2.0 * juce::MathConstants<double>::pi * modulation.rate * (double)i / sampleRate;
+                times->at((size_t)i) = 250.0f + modulation.depth * (float)std::sin(phase);
+            }
+
+            benchmarks.push_back({std::string("DelayLine::run, ") + interpolationName + ", " + modulation.name, [delay, times](const float* input, float* output)
+            {
+                CpuDispatch::run(kernelLevel, [&]
+                {
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        delay->setTime((*times)[(size_t)i]);
+                        output[i] = delay->run(input[i]);
+                    }
+                });
+            }});
+        }
+    }
+}
+
+void addLadderBenchmarks(std::vector<KernelBenchmark>& benchmarks)
+{
+    const std::pair<LadderBank::Mode, const char*> modes[] = {
+        {LadderBank::Mode::lpf12, "LPF12"},
+        {LadderBank::Mode::hpf12, "HPF12"},
+        {LadderBank::Mode::bpf12, "BPF12"},
+        {LadderBank::Mode::lpf24, "LPF24"},
+        {LadderBank::Mode::hpf24, "HPF24"},
+        {LadderBank::Mode::bpf24, "BPF24"}};
+
+    for (const auto& [mode, name] : modes)
+    {
+        auto ladders = std::make_shared<LadderBank>();
+        ladders->setMode(0, mode);
+        ladders->setCutoff(0, 1000.0f);
+        ladders->setResonance(0, 0.5f);
+        ladders->setDrive(0, 2.0f);
+        ladders->setEnabled(0, true);
+        ladders->prepare(sampleRate);
+
+        benchmarks.push_back({std::string("LadderBank, ") + name, [ladders](const float* input, float* output)
+        {
+            CpuDispatch::run(kernelLevel, [&]
+            {
+                std::copy(input, input + blockSize, output);
+                ladders->processChannel(0, output, blockSize);
+            });
+        }});
+    }
+
+    // A whole group of channels side by side, as FilterEngine runs them
+    auto ladders = std::make_shared<LadderBank>();
+    auto frames = std::make_shared<std::vector<float>>((size_t)(blockSize * LadderBank::lanes));
+
+    for (int ch = 0; ch < LadderBank::lanes; ++ch)
+    {
+        ladders->setMode(ch, LadderBank::Mode::lpf24);
+        ladders->setCutoff(ch, 1000.0f);
+        ladders->setResonance(ch, 0.5f);
+        ladders->setDrive(ch, 2.0f);
+        ladders->setEnabled(ch, true);
+    }
+
+    ladders->prepare(sampleRate);
+
+    benchmarks.push_back({"LadderBank, LPF24, group of " + std::to_string(LadderBank::lanes) + " channels", [ladders, frames](const float* input, float* output)
+    {
+        CpuDispatch::run(kernelLevel, [&]
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                std::fill_n(frames->data() + i * LadderBank::lanes, LadderBank::lanes, input[i]);
+            }
+
+            ladders->processGroup(0, frames->data(), blockSize, LadderBank::lanes);
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                output[i] = (*frames)[(size_t)(i * LadderBank::lanes)];
+            }
+        });
+    }});
+}
+
+void addRingBenchmarks(std::vector<KernelBenchmark>& benchmarks)
+{
+    struct Modulator
+    {
+        const char* name;
+        soutel::RModulators modulator;
+        soutel::BLWaveforms waveform;
+        bool am;
+    };
+
+    // Same modes as the Ring64 MOD parameter
+    const Modulator modulators[] = {
+        {"sine", soutel::RModulators::oscillator, soutel::BLWaveforms::sine, false},
+        {"triangle", soutel::RModulators::oscillator, soutel::BLWaveforms::triangle, false},
+        {"sine AM", soutel::RModulators::oscillator, soutel::BLWaveforms::sine, true},
+        {"triangle AM", soutel::RModulators::oscillator, soutel::BLWaveforms::triangle, true},
+        {"input", soutel::RModulators::input, soutel::BLWaveforms::sine, false}};
+
+    auto modulation = std::make_shared<std::vector<float>>(makeNoise(0x12345678u));
+
+    for (const auto& modulator : modulators)
+    {
+        auto ring = std::make_shared<soutel::RingMod<float>>();
+        ring->set_sample_rate((float)sampleRate);
+        ring->set_modulator(modulator.modulator);
+        ring->set_modulator_wave(modulator.waveform);
+        ring->set_am(modulator.am);
+        ring->set_frequency(440.0f);
+
+        benchmarks.push_back({std::string("RingMod::run, ") + modulator.name, [ring, modulation](const float* input, float* output)
+        {
+            CpuDispatch::run(kernelLevel, [&]
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    output[i] = ring->run(input[i], (*modulation)[(size_t)i]);
+                }
+            });
+        }});
+    }
+
+    // The oscillators of the High tier
+    for (const auto& [waveform, name] : {std::pair{RingOscillator::Waveform::sine, "sine"},
+                                         std::pair{RingOscillator::Waveform::triangle, "triangle"}})
+    {
+        auto oscillator = std::make_shared<RingOscillator>();
+        oscillator->setSampleRate(sampleRate);
+        oscillator->setWaveform(waveform);
+        oscillator->setFrequency(440.0f);
+
+        benchmarks.push_back({std::string("RingOscillator, ") + name, [oscillator](const float* input, float* output)
+        {
+            CpuDispatch::run(kernelLevel, [&] { oscillator->process(input, output, blockSize); });
+        }});
+    }
+}
+
+void addGainBenchmarks(std::vector<KernelBenchmark>& benchmarks)
+{
+    // Channel and master gain as in GainEngine, either settled or always ramping
+    for (const bool ramping : {false, true})
+    {
+        auto smoothers = std::make_shared<SmootherBank>();
+        smoothers->prepare(2, blockSize, sampleRate, 0.05);
+        smoothers->setCurrentAndTarget(0, 2.0f);
+        smoothers->setCurrentAndTarget(1, 0.5f);
+        auto flip = std::make_shared<bool>(false);
+
+        benchmarks.push_back({ramping ? "Gain, ramping" : "Gain, settled", [smoothers, flip, ramping](const float* input, float* output)
+        {
+            if (ramping)
+            {
+                *flip = !*flip;
+                smoothers->setTarget(0, *flip ? 1.0f : 2.0f);
+                smoothers->setTarget(1, *flip ? 0.7f : 0.5f);
+            }
+
+            CpuDispatch::run(kernelLevel, [&]
+            {
+                smoothers->render(2, blockSize);
+                const float* chGains = smoothers->getRamp(0);
+                const float* masterGains = smoothers->getRamp(1);
+
+                // Both gains are updated together, so they ramp or settle together
+                if (chGains == nullptr || masterGains == nullptr)
+                {
+                    const float gain = smoothers->getCurrentValue(0) * smoothers->getCurrentValue(1);
+
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        output[i] = input[i] * gain;
+                    }
+
+                    return;
+                }
+
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    output[i] = input[i] * chGains[i] * masterGains[i];
+                }
+            });
+        }});
+    }
+
+    // Ramps of every channel rendered at once, per sample of one channel
+    auto smoothers = std::make_shared<SmootherBank>();
+    smoothers->prepare(MAX_CHANS, blockSize, sampleRate, 0.05);
+    auto flip = std::make_shared<bool>(false);
+
+    benchmarks.push_back({"SmootherBank::render, all ramping", [smoothers, flip](const float*, float* output)
+    {
+        *flip = !*flip;
+
+        for (int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            smoothers->setTarget(ch, *flip ? 1.0f : (float)ch);
+        }
+
+        CpuDispatch::run(kernelLevel, [&]
+        {
+            smoothers->render(MAX_CHANS, blockSize);
+        });
+
+        std::copy(smoothers->getRamp(0), smoothers->getRamp(0) + blockSize, output);
+    }});
+}
+
+void addMixingBenchmarks(std::vector<KernelBenchmark>& benchmarks)
+{
+    // Wet signal and mix ramp as the engines feed them
+    auto wet = std::make_shared<std::vector<float>>(makeNoise(0x2545f491u));
+    auto mixes = std::make_shared<std::vector<float>>(blockSize);
+    for (int i = 0; i < blockSize; ++i)
+    {
+        mixes->at((size_t)i) = (float)i / (float)blockSize;
+    }
+
+    benchmarks.push_back({"Crossfade, constant", [wet](const float* input, float* output)
+    {
+        CpuDispatch::run(kernelLevel, [&] { Mixing::crossfade(output, input, wet->data(), 0.3f, blockSize); });
+    }});
+
+    benchmarks.push_back({"Crossfade, ramped", [wet, mixes](const float* input, float* output)
+    {
+        CpuDispatch::run(kernelLevel, [&] { Mixing::crossfade(output, input, wet->data(), mixes->data(), blockSize); });
+    }});
+
+    benchmarks.push_back({"Equal-power crossfade, constant", [wet](const float* input, float* output)
+    {
+        CpuDispatch::run(kernelLevel, [&] { Mixing::equalPowerCrossfade(output, input, wet->data(), 0.3f, blockSize); });
+    }});
+
+    benchmarks.push_back({"Equal-power crossfade, ramped", [wet, mixes](const float* input, float* output)
+    {
+        CpuDispatch::run(kernelLevel, [&] { Mixing::equalPowerCrossfade(output, input, wet->data(), mixes->data(), blockSize); });
+    }});
+}
+
+void addOversamplingBenchmarks(std::vector<KernelBenchmark>& benchmarks)
+{
+    // A whole group of channels, up and back down, as FilterEngine runs it
+    for (const int factor : {2, 4})
+    {
+        auto oversampler = std::make_shared<HalfBandOversampler>();
+        oversampler->prepare(blockSize);
+        oversampler->setFactor(factor);
+
+        auto group = std::make_shared<std::vector<float>>((size_t)(blockSize * HalfBandOversampler::lanes));
+
+        benchmarks.push_back({"HalfBandOversampler " + std::to_string(factor) + "x, group of " + std::to_string(HalfBandOversampler::lanes) + " channels",
+                              [oversampler, group](const float* input, float* output)
+        {
+            CpuDispatch::run(kernelLevel, [&]
+            {
+                std::array<float*, HalfBandOversampler::lanes> channels{};
+                for (int lane = 0; lane < HalfBandOversampler::lanes; ++lane)
+                {
+                    channels.at((size_t)lane) = group->data() + lane * blockSize;
+                    std::copy(input, input + blockSize, channels.at((size_t)lane));
+                }
+
+                oversampler->upsample(channels.data(), HalfBandOversampler::lanes, 0, blockSize);
+                oversampler->downsample(channels.data(), HalfBandOversampler::lanes, 0, blockSize);
+                std::copy(channels.front(), channels.front() + blockSize, output);
+            });
+        }});
+    }
+}
+
+PerfCounters::Sample measure(KernelBenchmark& benchmark, PerfCounters& counters, const float* input, float* output, int repetitions)
+{
+    for (int block = 0; block < warmupBlocks; ++block)
+    {
+        benchmark.process(input, output);
+    }
+
+    std::vector<PerfCounters::Sample> samples;
+
+    for (int repetition = 0; repetition < repetitions; ++repetition)
+    {
+        counters.start();
+
+        for (int block = 0; block < measuredBlocks; ++block)
+        {
+            benchmark.process(input, output);
+        }
+
+        samples.push_back(counters.stop());
+    }
+
+    // The median run is less sensitive to interrupts and frequency changes
+    std::sort(samples.begin(), samples.end(), [](const auto& a, const auto& b) { return a.nanoseconds < b.nanoseconds; });
+    return samples.at(samples.size() / 2);
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int core = 0;
+    int repetitions = 11;
+    std::string filter;
+    kernelLevel = CpuDispatch::select();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--core") == 0 && i + 1 < argc)
+        {
+            core = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc)
+        {
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--isa") == 0 && i + 1 < argc)
+        {
+            const std::string name = argv[++i];
+            bool found = false;
+
+            for (const auto level : {CpuDispatch::Level::baseline, CpuDispatch::Level::avx2, CpuDispatch::Level::avx512})
+            {
+                if (name == CpuDispatch::getName(level))
+                {
+                    kernelLevel = level;
+                    found = true;
+                }
+            }
+
+            if (!found || kernelLevel > CpuDispatch::detect())
+            {
+                std::printf("%s is not a level supported by this CPU (%s at most)\n", name.c_str(), CpuDispatch::getName(CpuDispatch::detect()));
+                return 1;
+            }
+        }
+        else
+        {
+            std::printf("Usage: Plug64KernelBenchmarks [--core N] [--filter text] [--repetitions N] [--isa baseline|avx2|avx512]\n");
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    juce::ScopedNoDenormals noDenormals;
+
+    const bool pinned = PerfCounters::pinToCore(core);
+    PerfCounters counters;
+
+    std::printf("%s, %s, %s kernels\n\n", pinned ? ("pinned to core " + std::to_string(core)).c_str() : "not pinned",
+                counters.isAvailable() ? "perf_event counters" : "perf_event not available, time only",
+                CpuDispatch::getName(kernelLevel));
+
+    std::vector<KernelBenchmark> benchmarks;
+    addDelayBenchmarks(benchmarks);
+    addLadderBenchmarks(benchmarks);
+    addRingBenchmarks(benchmarks);
+    addGainBenchmarks(benchmarks);
+    addMixingBenchmarks(benchmarks);
+    addOversamplingBenchmarks(benchmarks);
+
+    const auto input = makeNoise(0x9e3779b9u);
+    std::vector<float> output(blockSize);
+
+    std::printf("%-36s %10s %10s %10s %8s %12s %12s\n", "KERNEL", "ns/sample", "cyc/sample", "ins/sample", "IPC", "cmiss/ksmp", "bmiss/ksmp");
+
+    for (auto& benchmark : benchmarks)
+    {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        const auto sample = measure(benchmark, counters, input.data(), output.data(), repetitions);
+        const double numSamples = (double)blockSize * (double)measuredBlocks;
+
+        std::printf("%-36s %10.2f", benchmark.name.c_str(), sample.nanoseconds / numSamples);
+
+        if (counters.isAvailable())
+        {
+            const auto& counts = sample.counts;
+            const double cycles = (double)counts.at(PerfCounters::cycles);
+            const double instructions = (double)counts.at(PerfCounters::instructions);
+
+            std::printf(" %10.2f %10.2f %8.2f %12.3f %12.3f", cycles / numSamples, instructions / numSamples,
+                        cycles > 0.0 ? instructions / cycles : 0.0,
+                        (double)counts.at(PerfCounters::cacheMisses) * 1000.0 / numSamples,
+                        (double)counts.at(PerfCounters::branchMisses) * 1000.0 / numSamples);
+        }
+
+        std::printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters of the calling thread through perf_event, grouped so that
+// they are scheduled together. When perf_event is not available (other
+// platforms, containers, perf_event_paranoid too strict) only the wall clock
+// time is measured.
+class PerfCounters
+{
+public:
+    enum Counter
+    {
+        cycles,
+        instructions,
+        cacheMisses,
+        branchMisses,
+        numCounters
+    };
+
+    struct Sample
+    {
+        double nanoseconds = 0.0;
+        std::array<std::uint64_t, numCounters> counts{};
+    };
+
+    PerfCounters()
+    {
+#if defined(__linux__)
+        const std::array<std::uint64_t, numCounters> configs{PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                              PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+        for (int counter = 0; counter < numCounters; ++counter)
+        {
+            perf_event_attr attributes{};
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.size = sizeof(attributes);
+            attributes.config = configs.at((size_t)counter);
+            attributes.disabled = counter == 0 ? 1 : 0;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_GROUP;
+
+            const int groupFd = counter == 0 ? -1 : descriptors.at(0);
+            descriptors.at((size_t)counter) = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, groupFd, 0);
+
+            if (descriptors.at((size_t)counter) < 0)
+            {
+                close();
+                return;
+            }
+        }
+
+        available = true;
+#endif
+    }
+
+    ~PerfCounters()
+    {
+        close();
+    }
+
+    bool isAvailable() const
+    {
+        return available;
+    }
+
+    void start()
+    {
+#if defined(__linux__)
+        if (available)
+        {
+            ioctl(descriptors.at(0), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(descriptors.at(0), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+        startTime = std::chrono::steady_clock::now();
+    }
+
+    Sample stop()
+    {
+        Sample sample;
+        sample.nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+
+#if defined(__linux__)
+        if (available)
+        {
+            ioctl(descriptors.at(0), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+            // Group format: number of counters, then their values
+            std::array<std::uint64_t, numCounters + 1> values{};
+            if (read(descriptors.at(0), values.data(), sizeof(values)) == (ssize_t)sizeof(values))
+            {
+                for (int counter = 0; counter < numCounters; ++counter)
+                {
+                    sample.counts.at((size_t)counter) = values.at((size_t)counter + 1);
+                }
+            }
+        }
+#endif
+
+        return sample;
+    }
+
+    // Pins the calling thread to one core, so that the counters and the caches
+    // warmed up before measuring belong to the same core
+    static bool pinToCore(int core)
+    {
+#if defined(__linux__)
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(core, &cpus);
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+        (void)core;
+        return false;
+#endif
+    }
+
+private:
+    std::array<int, numCounters> descriptors{-1, -1, -1, -1};
+    bool available = false;
+    std::chrono::steady_clock::time_point startTime;
+
+    void close()
+    {
+#if defined(__linux__)
+        for (auto& descriptor : descriptors)
+        {
+            if (descriptor >= 0)
+            {
+                ::close(descriptor);
+                descriptor = -1;
+            }
+        }
+#endif
+        available = false;
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+};
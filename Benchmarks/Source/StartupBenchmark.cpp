@@ -0,0 +1,137 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+// Startup benchmark, built once per plugin against its shared code. It times
+// what a host does when loading a project: constructing many instances of
+// the processor, then opening and closing their editors. The first instance
+// and the first editor are reported apart, since they also pay for what is
+// shared by the whole process (the typeface and the look and feel).
+//
+// Usage: <Plugin>StartupBenchmark [--instances N]
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// Milliseconds taken by each instance, in order
+struct Timings
+{
+    std::vector<double> times;
+
+    void print(const char* what) const
+    {
+        if (times.empty())
+        {
+            return;
+        }
+
+        std::vector<double> others(times.begin() + 1, times.end());
+        std::sort(others.begin(), others.end());
+
+        const double median = others.empty() ? 0.0 : others[others.size() / 2];
+        const double worst = others.empty() ? 0.0 : others.back();
+        double total = 0.0;
+
+        for (const auto time : times)
+        {
+            total += time;
+        }
+
+        std::printf("%-10s first %8.3f ms, then median %8.3f ms, max %8.3f ms, total %9.3f ms\n", what, times.front(), median, worst, total);
+    }
+};
+
+template <typename Function>
+double timeMilliseconds(Function&& function)
+{
+    const auto start = Clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int numInstances = 100;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--instances") == 0 && i + 1 < argc)
+        {
+            numInstances = std::max(1, std::atoi(argv[++i]));
+        }
+        else
+        {
+            std::printf("Usage: %s [--instances N]\n", argv[0]);
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    std::vector<std::unique_ptr<juce::AudioProcessor>> processors;
+    std::vector<std::unique_ptr<juce::AudioProcessorEditor>> editors;
+    Timings construction, editorCreation, editorDeletion, destruction;
+
+    processors.reserve((size_t)numInstances);
+    editors.reserve((size_t)numInstances);
+
+    for (int i = 0; i < numInstances; ++i)
+    {
+        construction.times.push_back(timeMilliseconds([&] { processors.emplace_back(createPluginFilter()); }));
+    }
+
+    const int numParameters = processors.front()->getParameters().size();
+
+    // All the editors are open at once, as after restoring a session, so
+    // that the shared resources are only created by the first one
+    for (auto& processor : processors)
+    {
+        editorCreation.times.push_back(timeMilliseconds([&] { editors.emplace_back(processor->createEditorIfNeeded()); }));
+    }
+
+    for (auto& editor : editors)
+    {
+        editorDeletion.times.push_back(timeMilliseconds([&] { editor.reset(); }));
+    }
+
+    for (auto& processor : processors)
+    {
+        destruction.times.push_back(timeMilliseconds([&] { processor.reset(); }));
+    }
+
+    std::printf("%s, %d instances, %d parameters each\n", JucePlugin_Name, numInstances, numParameters);
+    construction.print("processor");
+    editorCreation.print("editor");
+    editorDeletion.print("close");
+    destruction.print("delete");
+
+    return 0;
+}
@@ -0,0 +1,3 @@
+include(CPM)
+
+CPMAddPackage("gh:pybind/pybind11@2.13.6")
@@ -0,0 +1,230 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include "PluginEditor.h"
+
+Chain64AudioProcessorEditor::Chain64AudioProcessorEditor(Chain64AudioProcessor& p)
+    : AudioProcessorEditor(&p),
+      audioProcessor(p),
+      customTypeface(customLookAndFeel->customTypeface),
+      customFont(juce::Font(juce::FontOptions().withTypeface(customTypeface))),
+      levelMeterStrip(p.getLevelMeters(), customLookAndFeel.getObject())
+{
+    setSize(500, 500);
+    setResizeLimits(400, 400, 3000, 3000);
+    setResizable(true, p.wrapperType != Chain64AudioProcessor::wrapperType_AudioUnitv3);
+    getConstrainer()->setFixedAspectRatio(1.0f);
+
+    getLookAndFeel().setColour(juce::Label::textColourId, customLookAndFeel->textColour);
+    getLookAndFeel().setDefaultSansSerifTypeface(customTypeface);
+
+    header.setText("Plug64", juce::dontSendNotification);
+    header.setColour(juce::Label::textColourId, customLookAndFeel->backgroundColour);
+    header.setColour(juce::Label::backgroundColourId, customLookAndFeel->textColour);
+    addAndMakeVisible(header);
+
+    title.setText("CHAIN64", juce::dontSendNotification);
+    addAndMakeVisible(title);
+    addAndMakeVisible(levelMeterStrip);
+
+    setupLabel(orderLabel, "ORDER");
+    setupComboBox(orderBox);
+    const auto& orders = Chain64AudioProcessor::getStageOrders();
+    for (size_t i = 0; i < orders.size(); ++i)
+    {
+        juce::StringArray names;
+        for (auto stage : orders.at(i))
+        {
+            names.add(Chain64AudioProcessor::getStageName(stage).toUpperCase());
+        }
+        orderBox.addItem(names.joinIntoString(" > "), (int)i + 1);
+    }
+    orderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(p.treeState, "order", orderBox);
+
+    const std::array<juce::String, Chain64AudioProcessor::numStages> stageIDs{"gainon", "filteron", "ringon", "delayon"};
+    for (unsigned int stage = 0; stage < Chain64AudioProcessor::numStages; ++stage)
+    {
+        setupLabel(stageLabels[stage], Chain64AudioProcessor::getStageName(static_cast<Chain64AudioProcessor::Stage>(stage)).toUpperCase());
+        setupLabel(stageOnLabels[stage], "ON");
+        setupComboBox(stageOnBoxes[stage]);
+        stageOnBoxes[stage].addItem("OFF", 1);
+        stageOnBoxes[stage].addItem("ON", 2);
+        stageOnAttachments[stage] = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(p.treeState, stageIDs[stage], stageOnBoxes[stage]);
+    }
+
+    setupLabel(gainLabel, "GAIN");
+    setupSlider(gainSlider, customLookAndFeel->mainMasterSliderColour, " dB");
+    gainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.treeState, "gainmastergain", gainSlider);
+
+    setupLabel(filterTypeLabel, "TYPE");
+    setupLabel(filterCutoffLabel, "CUTOFF");
+    setupComboBox(filterTypeBox);
+    filterTypeBox.addItem("NONE", 1);
+    filterTypeBox.addItem("LPF12", 2);
+    filterTypeBox.addItem("HPF12", 3);
+    filterTypeBox.addItem("BPF12", 4);
+    filterTypeBox.addItem("LPF24", 5);
+    filterTypeBox.addItem("HPF24", 6);
+    filterTypeBox.addItem("BPF24", 7);
+    filterTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(p.treeState, "filtermastertype", filterTypeBox);
+    setupSlider(filterCutoffSlider, customLookAndFeel->mainMasterSliderColour, " Hz");
+    filterCutoffAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.treeState, "filtermastercutoff", filterCutoffSlider);
+
+    setupLabel(ringModLabel, "MOD");
+    setupLabel(ringFreqLabel, "FREQ");
+    setupLabel(ringWetLabel, "WET");
+    setupComboBox(ringModBox);
+    ringModBox.addItem("SINE", 1);
+    ringModBox.addItem("TRIANGLE", 2);
+    ringModBox.addItem("SINE AM", 3);
+    ringModBox.addItem("TRI AM", 4);
+    ringModBox.addItem("CH INPUT", 5);
+    ringModAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(p.treeState, "ringmastermod", ringModBox);
+    setupSlider(ringFreqSlider, customLookAndFeel->mainMasterSliderColour, " Hz");
+    ringFreqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.treeState, "ringmasterfreq", ringFreqSlider);
+    setupSlider(ringWetSlider, customLookAndFeel->otherMasterSliderColour, " %");
+    ringWetAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.treeState, "ringmasterwet", ringWetSlider);
+
+    setupLabel(delaySyncLabel, "SYNC");
+    setupLabel(delayTimeLabel, "TIME");
+    setupLabel(delayWetLabel, "WET");
+    setupComboBox(delaySyncBox);
+    delaySyncBox.addItem("NONE", 1);
+    for (auto i = 1; i <= 16; ++i)
+    {
+        delaySyncBox.addItem(std::to_string(i) + "/16", i+1);
+    }
+    delaySyncAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(p.treeState, "delaymastersync", delaySyncBox);
+    setupSlider(delayTimeSlider, customLookAndFeel->mainMasterSliderColour, " ms");
+    delayTimeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.treeState, "delaymastertime", delayTimeSlider);
+    setupSlider(delayWetSlider, customLookAndFeel->otherMasterSliderColour, " %");
+    delayWetAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.treeState, "delaymasterwet", delayWetSlider);
+}
+
+Chain64AudioProcessorEditor::~Chain64AudioProcessorEditor()
+{
+}
+
+void Chain64AudioProcessorEditor::setupLabel(juce::Label& label, const juce::String& text)
+{
+    label.setText(text, juce::dontSendNotification);
+    label.setJustificationType(juce::Justification::left);
+    addAndMakeVisible(label);
+}
+
+void Chain64AudioProcessorEditor::setupSlider(juce::Slider& slider, juce::Colour colour, const juce::String& suffix)
+{
+    slider.setLookAndFeel(&customLookAndFeel.getObject());
+    slider.setColour(juce::Slider::trackColourId, colour);
+    slider.setSliderStyle(juce::Slider::LinearBar);
+    slider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 0, 0);
+    slider.setPopupDisplayEnabled(false, false, this);
+    slider.setTextValueSuffix(suffix);
+    addAndMakeVisible(slider);
+}
+
+void Chain64AudioProcessorEditor::setupComboBox(juce::ComboBox& box)
+{
+    box.setLookAndFeel(&customLookAndFeel.getObject());
+    box.setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
+    box.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
+    box.setScrollWheelEnabled(true);
+    addAndMakeVisible(box);
+}
+
+void Chain64AudioProcessorEditor::placeCaption(juce::Label& label, float x, float y, float width, int blockUI)
+{
+    label.setJustificationType(juce::Justification::bottomLeft);
+    label.setBounds((int)((float)blockUI * x), (int)((float)blockUI * y), (int)((float)blockUI * width), blockUI);
+    label.setFont(customFont.withHeight(fontSize * 0.75f));
+}
+
+void Chain64AudioProcessorEditor::placeSlider(juce::Slider& slider, float x, float y, float width, int blockUI)
+{
+    const int sliderWidth = (int)((float)blockUI * width);
+    slider.setBounds((int)((float)blockUI * x), (int)((float)blockUI * y), sliderWidth, blockUI);
+    slider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, sliderWidth, blockUI);
+}
+
+void Chain64AudioProcessorEditor::paint(juce::Graphics& g)
+{
+    g.fillAll(customLookAndFeel->backgroundColour);
+    g.setColour(customLookAndFeel->lineColour);
+    auto width = static_cast<float>(getWidth());
+    g.drawLine(width * 0.05f, width * 0.2f, width * 0.95f, width * 0.2f, width * 0.004f);
+}
+
+void Chain64AudioProcessorEditor::resized()
+{
+    const int blockUI = (int)ceil((float)getWidth() / 16.0f);
+    fontSize = (float)blockUI * 0.75f;
+    customFont = customFont.withHeight(fontSize);
+
+    header.setJustificationType(juce::Justification::left);
+    header.setBounds(blockUI, blockUI / 2, blockUI * 2, (int)fontSize);
+    header.setFont(customFont.withHeight(fontSize));
+
+    title.setJustificationType(juce::Justification::left);
+    title.setBounds(blockUI, blockUI, blockUI * 14, blockUI * 2);
+    title.setFont(customFont.withHeight(fontSize * 2.0f));
+
+    levelMeterStrip.setBounds(blockUI, (int)((float)blockUI * 3.4f), blockUI * 14, (int)((float)blockUI * 0.4f));
+
+    orderLabel.setJustificationType(juce::Justification::centredLeft);
+    orderLabel.setBounds(blockUI, blockUI * 4, blockUI * 3, blockUI);
+    orderLabel.setFont(customFont.withHeight(fontSize));
+    orderBox.setBounds(blockUI * 4, blockUI * 4, blockUI * 11, blockUI);
+
+    for (unsigned int stage = 0; stage < Chain64AudioProcessor::numStages; ++stage)
+    {
+        const float y = 5.5f + 2.5f * (float)stage;
+
+        stageLabels[stage].setJustificationType(juce::Justification::centredLeft);
+        stageLabels[stage].setBounds(blockUI, (int)((float)blockUI * (y + 1.0f)), blockUI * 3, blockUI);
+        stageLabels[stage].setFont(customFont.withHeight(fontSize));
+
+        placeCaption(stageOnLabels[stage], 4.0f, y, 2.0f, blockUI);
+        stageOnBoxes[stage].setBounds(blockUI * 4, (int)((float)blockUI * (y + 1.0f)), blockUI * 2, blockUI);
+    }
+
+    float y = 5.5f;
+    placeCaption(gainLabel, 6.5f, y, 3.0f, blockUI);
+    placeSlider(gainSlider, 6.5f, y + 1.0f, 8.5f, blockUI);
+
+    y += 2.5f;
+    placeCaption(filterTypeLabel, 6.5f, y, 3.0f, blockUI);
+    placeCaption(filterCutoffLabel, 10.0f, y, 3.0f, blockUI);
+    filterTypeBox.setBounds((int)((float)blockUI * 6.5f), (int)((float)blockUI * (y + 1.0f)), blockUI * 3, blockUI);
+    placeSlider(filterCutoffSlider, 10.0f, y + 1.0f, 5.0f, blockUI);
+
+    y += 2.5f;
+    placeCaption(ringModLabel, 6.5f, y, 3.0f, blockUI);
+    placeCaption(ringFreqLabel, 10.0f, y, 2.25f, blockUI);
+    placeCaption(ringWetLabel, 12.75f, y, 2.25f, blockUI);
+    ringModBox.setBounds((int)((float)blockUI * 6.5f), (int)((float)blockUI * (y + 1.0f)), blockUI * 3, blockUI);
+    placeSlider(ringFreqSlider, 10.0f, y + 1.0f, 2.25f, blockUI);
+    placeSlider(ringWetSlider, 12.75f, y + 1.0f, 2.25f, blockUI);
+
+    y += 2.5f;
+    placeCaption(delaySyncLabel, 6.5f, y, 3.0f, blockUI);
+    placeCaption(delayTimeLabel, 10.0f, y, 2.25f, blockUI);
+    placeCaption(delayWetLabel, 12.75f, y, 2.25f, blockUI);
+    delaySyncBox.setBounds((int)((float)blockUI * 6.5f), (int)((float)blockUI * (y + 1.0f)), blockUI * 3, blockUI);
+    placeSlider(delayTimeSlider, 10.0f, y + 1.0f, 2.25f, blockUI);
+    placeSlider(delayWetSlider, 12.75f, y + 1.0f, 2.25f, blockUI);
+}
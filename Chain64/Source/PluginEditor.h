@@ -0,0 +1,89 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include "PluginProcessor.h"
+#include "CustomLookAndFeel.h"
+#include "LevelMeterStrip.h"
+
+// Shows the stage order, the stage switches and the master controls of each
+// stage; per-channel parameters are available through host automation
+class Chain64AudioProcessorEditor : public juce::AudioProcessorEditor
+{
+public:
+    Chain64AudioProcessorEditor(Chain64AudioProcessor&);
+    ~Chain64AudioProcessorEditor() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    Chain64AudioProcessor& audioProcessor;
+    // Shared by all the editors of the process, along with its typeface
+    juce::SharedResourcePointer<CustomLookAndFeel> customLookAndFeel;
+    juce::Label header;
+    juce::Label title;
+    juce::Label orderLabel;
+    juce::ComboBox orderBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> orderAttachment;
+    std::array<juce::Label, Chain64AudioProcessor::numStages> stageLabels;
+    std::array<juce::Label, Chain64AudioProcessor::numStages> stageOnLabels;
+    std::array<juce::ComboBox, Chain64AudioProcessor::numStages> stageOnBoxes;
+    std::array<std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>, Chain64AudioProcessor::numStages> stageOnAttachments;
+    juce::Label gainLabel;
+    juce::Slider gainSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> gainAttachment;
+    juce::Label filterTypeLabel;
+    juce::Label filterCutoffLabel;
+    juce::ComboBox filterTypeBox;
+    juce::Slider filterCutoffSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> filterTypeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterCutoffAttachment;
+    juce::Label ringModLabel;
+    juce::Label ringFreqLabel;
+    juce::Label ringWetLabel;
+    juce::ComboBox ringModBox;
+    juce::Slider ringFreqSlider;
+    juce::Slider ringWetSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> ringModAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> ringFreqAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> ringWetAttachment;
+    juce::Label delaySyncLabel;
+    juce::Label delayTimeLabel;
+    juce::Label delayWetLabel;
+    juce::ComboBox delaySyncBox;
+    juce::Slider delayTimeSlider;
+    juce::Slider delayWetSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> delaySyncAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> delayTimeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> delayWetAttachment;
+
+    juce::Typeface::Ptr customTypeface;
+    juce::Font customFont;
+    LevelMeterStrip levelMeterStrip;
+    float fontSize;
+
+    void setupLabel(juce::Label& label, const juce::String& text);
+    void setupSlider(juce::Slider& slider, juce::Colour colour, const juce::String& suffix);
+    void setupComboBox(juce::ComboBox& box);
+    void placeCaption(juce::Label& label, float x, float y, float width, int blockUI);
+    void placeSlider(juce::Slider& slider, float x, float y, float width, int blockUI);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Chain64AudioProcessorEditor)
+};
@@ -0,0 +1,518 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+#include <algorithm>
+#include <string>
+
+namespace
+{
+const std::array<std::string, Chain64AudioProcessor::numStages> stagePrefixes{"gain", "filter", "ring", "delay"};
+}
+
+Chain64AudioProcessor::Chain64AudioProcessor() :
+#ifndef JucePlugin_PreferredChannelConfigurations
+    AudioProcessor(BusesProperties()
+#if ! JucePlugin_IsMidiEffect
+#if ! JucePlugin_IsSynth
+                   .withInput("Input", juce::AudioChannelSet::stereo(), true)
+#endif
+                   .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+#endif
+                  ),
+#endif
+    treeState(*this, nullptr, juce::Identifier("Chain64Parameters"),
+              [&]()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>("order", "Stage Order", juce::NormalisableRange<float>(0.0f, 23.0f, 1.0f), 0.0f));
+
+    // Gain and filter start on, as they leave the signal untouched with their
+    // defaults; the ring modulator and the delay do not, so they start off
+    for (unsigned int stage = 0; stage < numStages; ++stage)
+    {
+        const auto stageName = getStageName(static_cast<Stage>(stage)).toStdString();
+        const bool neutral = stage == gainStage || stage == filterStage;
+        layout.add(std::make_unique<juce::AudioParameterFloat>(stagePrefixes.at(stage) + "on", stageName + " On", juce::NormalisableRange<float>(0.0f, 1.0f, 1.0f), neutral ? 1.0f : 0.0f));
+    }
+
+    // Parameter IDs are the ones of the single plugins prefixed by the stage,
+    // e.g. "delaymastertime" or "filterchcutoff12"
+    ParameterTable::addStage(layout, ParameterTable::gainSpecs, "gain", "Gain");
+    ParameterTable::addStage(layout, ParameterTable::filterSpecs, "filter", "Filter");
+    ParameterTable::addStage(layout, ParameterTable::ringSpecs, "ring", "Ring");
+    ParameterTable::addStage(layout, ParameterTable::delaySpecs, "delay", "Delay");
+
+    // Interpolates between the morph scenes of the preset bank, appended so
+    // that the indices of the other parameters do not change
+    layout.add(std::make_unique<juce::AudioParameterFloat>(PresetBank::morphParameterID, "Morph", juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 0.0f));
+
+    // Auto, Eco, Standard or High, appended for the same reason
+    layout.add(QualityTier::createParameter());
+
+    return layout;
+}
+()
+         )
+{
+    if (!treeState.state.hasProperty("selChannel"))
+    {
+        treeState.state.setProperty("selchannel", 1, nullptr);
+    }
+
+    // In the order of the layout
+    ParameterTable::Cursor parameters(*this);
+    orderParameter = parameters.next();
+    parameters.nextMaster(stageOnParameters);
+
+    ParameterTable::StageParameters<1> gainValues;
+    parameters.nextStage(gainValues);
+    for (unsigned int i = 0; i < MAX_CHANS + 1; ++i)
+    {
+        gainParameters.at(i) = gainValues.at(i).at(0);
+    }
+
+    parameters.nextStage(filterParameters);
+    parameters.nextStage(ringParameters);
+    parameters.nextStage(delayParameters);
+
+    // The morph parameter is taken by the preset bank
+    parameters.next();
+    qualityParameter = parameters.next();
+
+    // Choices switch halfway through a morph
+    presetBank.setDiscrete(orderParameter);
+    for (auto* stageOnParameter : stageOnParameters)
+    {
+        presetBank.setDiscrete(stageOnParameter);
+    }
+
+    for (unsigned int i = 0; i < MAX_CHANS + 1; ++i)
+    {
+        presetBank.setDiscrete(filterParameters.at(i).at(0));
+        presetBank.setDiscrete(ringParameters.at(i).at(0));
+        presetBank.setDiscrete(ringParameters.at(i).at(2));
+        presetBank.setDiscrete(delayParameters.at(i).at(0));
+    }
+
+    stateLoader.onRestored = [this]
+    {
+        if (treeState.state.hasProperty("selchannel"))
+        {
+            selChannel.referTo(treeState.state.getPropertyAsValue("selchannel", nullptr));
+        }
+    };
+
+    updateParams();
+}
+
+Chain64AudioProcessor::~Chain64AudioProcessor()
+{
+}
+
+const std::array<std::array<Chain64AudioProcessor::Stage, Chain64AudioProcessor::numStages>, 24>& Chain64AudioProcessor::getStageOrders()
+{
+    static const auto orders = []
+    {
+        std::array<std::array<Stage, numStages>, 24> permutations;
+        std::array<Stage, numStages> order{gainStage, filterStage, ringStage, delayStage};
+
+        for (auto& permutation : permutations)
+        {
+            permutation = order;
+            std::next_permutation(order.begin(), order.end());
+        }
+
+        return permutations;
+    }();
+
+    return orders;
+}
+
+juce::String Chain64AudioProcessor::getStageName(Stage stage)
+{
+    switch (stage)
+    {
+        case gainStage:
+            return "Gain";
+        case filterStage:
+            return "Filter";
+        case ringStage:
+            return "Ring";
+        case delayStage:
+            return "Delay";
+        default:
+            return {};
+    }
+}
+
+const juce::String Chain64AudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool Chain64AudioProcessor::acceptsMidi() const
+{
+#if JucePlugin_WantsMidiInput
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Chain64AudioProcessor::producesMidi() const
+{
+#if JucePlugin_ProducesMidiOutput
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Chain64AudioProcessor::isMidiEffect() const
+{
+#if JucePlugin_IsMidiEffect
+    return true;
+#else
+    return false;
+#endif
+}
+
+double Chain64AudioProcessor::getTailLengthSeconds() const
+{
+    return 0.0;
+}
+
+int Chain64AudioProcessor::getNumPrograms()
+{
+    // Hosts expect at least one program
+    return std::max(presetBank.getNumPresets(), 1);
+}
+
+int Chain64AudioProcessor::getCurrentProgram()
+{
+    return std::max(presetBank.getCurrentIndex(), 0);
+}
+
+void Chain64AudioProcessor::setCurrentProgram(int index)
+{
+    presetBank.select(index);
+}
+
+const juce::String Chain64AudioProcessor::getProgramName(int index)
+{
+    return presetBank.getName(index);
+}
+
+void Chain64AudioProcessor::changeProgramName(int index, const juce::String& newName)
+{
+    presetBank.setName(index, newName);
+    updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+}
+
+int Chain64AudioProcessor::storePreset(const juce::String& name)
+{
+    const int index = presetBank.add(name);
+    updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+    return index;
+}
+
+void Chain64AudioProcessor::setMorphScenes(int indexA, int indexB)
+{
+    presetBank.setMorphScenes(indexA, indexB);
+}
+
+void Chain64AudioProcessor::resetChannels(int first, int last)
+{
+    BulkEdit edit(presetBank);
+    edit.resetChannels([this](int ch) { return getChannelParameters(ch); }, first, last);
+    edit.commit();
+}
+
+void Chain64AudioProcessor::copyChannel(int source, int first, int last)
+{
+    BulkEdit edit(presetBank);
+    edit.copyChannel([this](int ch) { return getChannelParameters(ch); }, source, first, last);
+    edit.commit();
+}
+
+void Chain64AudioProcessor::randomiseChannels(int first, int last)
+{
+    BulkEdit edit(presetBank);
+    edit.randomiseChannels([this](int ch) { return getChannelParameters(ch); }, juce::Random::getSystemRandom(), first, last);
+    edit.commit();
+}
+
+std::array<juce::AudioParameterFloat*, 13> Chain64AudioProcessor::getChannelParameters(int ch) const
+{
+    const auto index = (size_t)ch + 1;
+    const auto& filter = filterParameters.at(index);
+    const auto& ring = ringParameters.at(index);
+    const auto& delay = delayParameters.at(index);
+
+    return {gainParameters.at(index),
+            filter.at(0), filter.at(1), filter.at(2), filter.at(3),
+            ring.at(0), ring.at(1), ring.at(2), ring.at(3),
+            delay.at(0), delay.at(1), delay.at(2), delay.at(3)};
+}
+
+void Chain64AudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    const auto numChannels = getTotalNumInputChannels();
+
+    // Tiles are never longer than tileSize, whatever the host block size
+    gainEngine.prepare(sampleRate, tileSize, numChannels);
+    filterEngine.prepare(sampleRate, tileSize, numChannels);
+    ringEngine.prepare(sampleRate, tileSize, numChannels);
+    delayEngine.prepare(sampleRate, tileSize, numChannels);
+    levelMeters.prepare(sampleRate, numChannels);
+    governor.prepare(sampleRate);
+    metrics.setGovernorLevel(0);
+
+    applyQuality();
+    updateParams();
+
+    metrics.prepare(sampleRate, samplesPerBlock, gainEngine.getMemoryBytes() + filterEngine.getMemoryBytes() + ringEngine.getMemoryBytes() + delayEngine.getMemoryBytes());
+}
+
+void Chain64AudioProcessor::releaseResources()
+{
+
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+bool Chain64AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+#if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+#endif
+
+    return true;
+}
+#endif
+
+void Chain64AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    metrics.beginBlock();
+
+    auto totalNumInputChannels = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    juce::ignoreUnused(midiMessages);
+
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+    {
+        buffer.clear(i, 0, buffer.getNumSamples());
+    }
+
+    // Hosts without a transport give no position or tempo, in which case
+    // the last tempo is kept
+    if (auto* currPlayHead = getPlayHead())
+    {
+        if (const auto position = currPlayHead->getPosition(); position.hasValue())
+        {
+            posInfo = *position;
+
+            if (const auto newBpm = posInfo.getBpm(); newBpm.hasValue())
+            {
+                bpm = static_cast<float>(*newBpm);
+            }
+        }
+    }
+
+    applyQuality();
+
+    auto* const* channels = buffer.getArrayOfWritePointers();
+
+    presetBank.processSteps(channels, totalNumInputChannels, buffer.getNumSamples(),
+        [this](int step) { updateParams(step); },
+        [this](float* const* stepChannels, int numChannels, int numSamples) { processRange(stepChannels, numChannels, 0, numSamples); });
+
+    levelMeters.process(buffer.getArrayOfReadPointers(), totalNumInputChannels, buffer.getNumSamples());
+
+    const int activeChannels = std::min(totalNumInputChannels, MAX_CHANS);
+    metrics.endBlock(buffer.getNumSamples(), activeChannels, numActiveStages == 0 ? activeChannels : countSleepingChannels(activeChannels));
+
+    if (governor.endBlock(metrics.getLastBlockNanos(), buffer.getNumSamples(), isNonRealtime(), metrics.getProcessLoad()))
+    {
+        metrics.setGovernorLevel(governor.getLevel());
+    }
+}
+
+void Chain64AudioProcessor::applyQuality()
+{
+    // The tiles leave no room for the oversampled filter, so High takes the
+    // exact saturation of the ladders at the host rate
+    const auto tier = QualityTier::resolve(*qualityParameter, isNonRealtime(), governor.getLevel());
+    ringEngine.setRampStride(QualityTier::getRampStride(tier));
+    ringEngine.setHalfRate(QualityTier::runsAtHalfRate(tier));
+    ringEngine.setPreciseOscillators(QualityTier::usesPreciseOscillators(tier));
+    delayEngine.setRampStride(QualityTier::getRampStride(tier));
+    delayEngine.setHalfRate(QualityTier::runsAtHalfRate(tier));
+    delayEngine.setCubicInterpolation(QualityTier::interpolatesCubically(tier));
+    filterEngine.setExactSaturation(QualityTier::usesExactSaturation(tier));
+}
+
+void Chain64AudioProcessor::processRange(float* const* channels, int numChannels, int startSample, int numSamples)
+{
+    if (numActiveStages == 0)
+    {
+        return;
+    }
+
+    // The ring modulator may read other channels as modulators, so the stages
+    // preceding it must be done on every channel before its inputs are taken
+    int ringPosition = numActiveStages;
+    for (int stage = 0; stage < numActiveStages; ++stage)
+    {
+        if (activeStages.at((size_t)stage) == ringStage)
+        {
+            ringPosition = stage;
+        }
+    }
+
+    const int endSample = startSample + numSamples;
+
+    for (int offset = startSample; offset < endSample; offset += tileSize)
+    {
+        const int length = std::min(tileSize, endSample - offset);
+
+        // Disabled engines keep their ramps going too, so that they do not
+        // jump when enabled
+        gainEngine.advanceSmoothers(length);
+        filterEngine.advanceSmoothers(length);
+        ringEngine.advanceSmoothers(length);
+        delayEngine.advanceSmoothers(length);
+
+        processStages(0, ringPosition, channels, numChannels, offset, length);
+
+        if (ringPosition < numActiveStages)
+        {
+            ringEngine.snapshotInputs(channels, numChannels, offset, length);
+            processStages(ringPosition, numActiveStages, channels, numChannels, offset, length);
+        }
+    }
+}
+
+int Chain64AudioProcessor::countSleepingChannels(int numChannels) const
+{
+    int sleeping = 0;
+
+    // A channel sleeps when the channel stage of every enabled engine is neutral
+    for (unsigned int ch = 0; ch < (unsigned int)numChannels; ++ch)
+    {
+        bool channelSleeping = true;
+
+        for (int stage = 0; stage < numActiveStages && channelSleeping; ++stage)
+        {
+            switch (activeStages.at((size_t)stage))
+            {
+                case gainStage:
+                    channelSleeping = gainEngine.isChannelSleeping(ch);
+                    break;
+                case filterStage:
+                    channelSleeping = filterEngine.isChannelSleeping(ch);
+                    break;
+                case ringStage:
+                    channelSleeping = ringEngine.isChannelSleeping(ch);
+                    break;
+                case delayStage:
+                    channelSleeping = delayEngine.isChannelSleeping(ch);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        sleeping += channelSleeping ? 1 : 0;
+    }
+
+    return sleeping;
+}
+
+void Chain64AudioProcessor::processStages(int firstStage, int lastStage, float* const* channels, int numChannels, int startSample, int numSamples)
+{
+    // Every engine selects the same instruction set, so the whole chain runs
+    // as a single dispatched kernel
+    CpuDispatch::run(gainEngine.getIsaLevel(), [&]
+    {
+        for (unsigned int ch = 0; ch < (unsigned int)std::min(numChannels, MAX_CHANS); ++ch)
+        {
+            float* channelData = channels[ch] + startSample;
+
+            for (int stage = firstStage; stage < lastStage; ++stage)
+            {
+                switch (activeStages.at((size_t)stage))
+                {
+                    case gainStage:
+                        gainEngine.processChannel(ch, channelData, numSamples);
+                        break;
+                    case filterStage:
+                        filterEngine.processChannel(ch, channelData, numSamples);
+                        break;
+                    case ringStage:
+                        ringEngine.processChannel(ch, channelData, numSamples);
+                        break;
+                    case delayStage:
+                        delayEngine.processChannel(ch, channelData, numSamples);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+    });
+}
+
+bool Chain64AudioProcessor::hasEditor() const
+{
+    return true;
+}
+
+juce::AudioProcessorEditor* Chain64AudioProcessor::createEditor()
+{
+    return new Chain64AudioProcessorEditor(*this);
+}
+
+void Chain64AudioProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    if (stateLoader.getPendingState(destData))
+    {
+        return;
+    }
+
+    auto state = treeState.copyState();
+    std::unique_ptr<juce::XmlElement> xml(state.createXml());
+    presetBank.writeTo(*xml);
+    copyXmlToBinary(*xml, destData);
+}
+
+void Chain64AudioProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    // Decoded in the background, then applied by onRestored
+    stateLoader.load(data, sizeInBytes, isNonRealtime());
+}
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new Chain64AudioProcessor();
+}
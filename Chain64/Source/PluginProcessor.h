@@ -0,0 +1,235 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_plugin_client/juce_audio_plugin_client.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_audio_utils/juce_audio_utils.h>
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_events/juce_events.h>
+#include <juce_graphics/juce_graphics.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_gui_extra/juce_gui_extra.h>
+#include "BinaryData.h"
+#include "DelayEngine.h"
+#include "FilterEngine.h"
+#include "GainEngine.h"
+#include "RingEngine.h"
+#include "InstanceMetrics.h"
+#include "LevelMeters.h"
+#include "ParameterTable.h"
+#include "PresetBank.h"
+#include "QualityTier.h"
+#include "BulkEdit.h"
+#include "CpuGovernor.h"
+#include "StateLoader.h"
+
+// Gain64, Filter64, Ring64 and Delay64 in series. Each tile of samples of a
+// channel goes through all the active stages before moving to the next one,
+// so the data stays in cache instead of being swept once per plugin.
+class Chain64AudioProcessor : public juce::AudioProcessor
+{
+public:
+    enum Stage
+    {
+        gainStage = 0,
+        filterStage,
+        ringStage,
+        delayStage,
+        numStages
+    };
+
+    Chain64AudioProcessor();
+    ~Chain64AudioProcessor() override;
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+#endif
+
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram(int index) override;
+    const juce::String getProgramName(int index) override;
+    void changeProgramName(int index, const juce::String& newName) override;
+
+    void getStateInformation(juce::MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+    // Bulk edits of the channel parameters, from channel first to last (0
+    // based, included), each applied in one step
+    void resetChannels(int first = 0, int last = MAX_CHANS - 1);
+    void copyChannel(int source, int first = 0, int last = MAX_CHANS - 1);
+    void randomiseChannels(int first = 0, int last = MAX_CHANS - 1);
+
+    // Stores the current parameter values as a new preset, which becomes the
+    // current program, returning its index; presets are renamed through
+    // changeProgramName()
+    int storePreset(const juce::String& name);
+
+    // Assigns the presets the "Morph" parameter interpolates between, or
+    // stops morphing when either index is not a preset
+    void setMorphScenes(int indexA, int indexB);
+
+    // Levels of the output channels, shown by the editor
+    LevelMeters& getLevelMeters()
+    {
+        return levelMeters;
+    }
+
+    // All the orderings of the four stages, indexed by the "order" parameter
+    static const std::array<std::array<Stage, numStages>, 24>& getStageOrders();
+    static juce::String getStageName(Stage stage);
+
+    juce::AudioProcessorValueTreeState treeState;
+
+    juce::AudioParameterFloat* orderParameter = nullptr;
+    juce::AudioParameterFloat* qualityParameter = nullptr;
+    std::array<juce::AudioParameterFloat*, numStages> stageOnParameters = {nullptr};
+
+    // Parameters of each stage, master first and then one entry per channel,
+    // with the fields in the same order as the engine stage parameters
+    std::array<juce::AudioParameterFloat*, MAX_CHANS + 1> gainParameters = {nullptr};
+    ParameterTable::StageParameters<4> filterParameters = {};
+    ParameterTable::StageParameters<4> ringParameters = {};
+    ParameterTable::StageParameters<4> delayParameters = {};
+
+    juce::Value selChannel;
+
+private:
+    static constexpr int tileSize = 256;
+
+    GainEngine gainEngine;
+    FilterEngine filterEngine;
+    RingEngine ringEngine;
+    DelayEngine delayEngine;
+    GainEngine::Parameters gainEngineParameters;
+    FilterEngine::Parameters filterEngineParameters;
+    RingEngine::Parameters ringEngineParameters;
+    DelayEngine::Parameters delayEngineParameters;
+    InstanceMetrics metrics{JucePlugin_Name};
+    CpuGovernor governor;
+    LevelMeters levelMeters;
+    PresetBank presetBank{treeState};
+    StateLoader stateLoader{treeState, presetBank};
+    std::array<Stage, numStages> activeStages = {};
+    int numActiveStages = 0;
+    float bpm = 0.0f;
+    juce::AudioPlayHead::PositionInfo posInfo;
+
+    // Sets the engines to the quality tier, as lowered by the governor under
+    // overload
+    void applyQuality();
+    void processRange(float* const* channels, int numChannels, int startSample, int numSamples);
+    void processStages(int firstStage, int lastStage, float* const* channels, int numChannels, int startSample, int numSamples);
+    int countSleepingChannels(int numChannels) const;
+
+    std::array<juce::AudioParameterFloat*, 13> getChannelParameters(int ch) const;
+
+    // With a step, reads the values of that step of the block being processed
+    inline void updateParams(int step = -1)
+    {
+        const PresetBank::Reader read(presetBank, step);
+
+        gainEngineParameters.master.gain = read(gainParameters.at(0));
+
+        auto setFilterStage = [this, &read](FilterEngine::StageParameters& stage, unsigned int index)
+        {
+            stage.type = static_cast<int>(read(filterParameters.at(index).at(0)));
+            stage.cutoff = read(filterParameters.at(index).at(1));
+            stage.resonance = read(filterParameters.at(index).at(2));
+            stage.drive = read(filterParameters.at(index).at(3));
+        };
+
+        auto setRingStage = [this, &read](RingEngine::StageParameters& stage, unsigned int index)
+        {
+            stage.mod = static_cast<int>(read(ringParameters.at(index).at(0)));
+            stage.freq = read(ringParameters.at(index).at(1));
+            stage.modCh = static_cast<int>(read(ringParameters.at(index).at(2)));
+            stage.wet = read(ringParameters.at(index).at(3));
+        };
+
+        auto setDelayStage = [this, &read](DelayEngine::StageParameters& stage, unsigned int index)
+        {
+            stage.sync = static_cast<int>(read(delayParameters.at(index).at(0)));
+            stage.time = read(delayParameters.at(index).at(1));
+            stage.feedback = read(delayParameters.at(index).at(2));
+            stage.wet = read(delayParameters.at(index).at(3));
+        };
+
+        setFilterStage(filterEngineParameters.master, 0);
+        setRingStage(ringEngineParameters.master, 0);
+        setDelayStage(delayEngineParameters.master, 0);
+
+        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            gainEngineParameters.channels.at(ch).gain = read(gainParameters.at(ch + 1));
+            setFilterStage(filterEngineParameters.channels.at(ch), ch + 1);
+            setRingStage(ringEngineParameters.channels.at(ch), ch + 1);
+            setDelayStage(delayEngineParameters.channels.at(ch), ch + 1);
+        }
+
+        gainEngine.setParameters(gainEngineParameters);
+        filterEngine.setParameters(filterEngineParameters);
+        ringEngine.setParameters(ringEngineParameters);
+        delayEngine.setParameters(delayEngineParameters, bpm);
+
+        if (presetBank.takeJump())
+        {
+            gainEngine.jumpToTargets();
+            filterEngine.jumpToTargets();
+            ringEngine.jumpToTargets();
+            delayEngine.jumpToTargets();
+        }
+
+        // Inactive stages are skipped altogether
+        const auto& order = getStageOrders().at((size_t)juce::jlimit(0, 23, static_cast<int>(read(orderParameter))));
+        numActiveStages = 0;
+        for (auto stage : order)
+        {
+            if (read(stageOnParameters.at(stage)) >= 0.5f)
+            {
+                activeStages.at((size_t)numActiveStages++) = stage;
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Chain64AudioProcessor)
+};
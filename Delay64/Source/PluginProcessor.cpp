@@ -1,280 +1,356 @@
-/******************************************************************************
-This file is part of Plug64.
-Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
-
-Plug64 is free software: you can redistribute it and/or modify it under
-the terms of the GNU General Public License as published by the Free Software
-Foundation, either version 3 of the License, or (at your option) any later
-version.
-
-Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
-WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
-A PARTICULAR PURPOSE. See the GNU General Public License for more details.
-
-You should have received a copy of the GNU General Public License along with
-Plug64. If not, see <https://www.gnu.org/licenses/>.
-******************************************************************************/
-
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-#include <string>
-
-Delay64AudioProcessor::Delay64AudioProcessor() :
-#ifndef JucePlugin_PreferredChannelConfigurations
-    AudioProcessor(BusesProperties()
-#if ! JucePlugin_IsMidiEffect
-#if ! JucePlugin_IsSynth
-                   .withInput("Input", juce::AudioChannelSet::stereo(), true)
-#endif
-                   .withOutput("Output", juce::AudioChannelSet::stereo(), true)
-#endif
-                  ),
-#endif
-    treeState(*this, nullptr, juce::Identifier("Delay64Parameters"),
-              [&]()
-{
-    juce::AudioProcessorValueTreeState::ParameterLayout layout;
-
-    layout.add(std::make_unique<juce::AudioParameterFloat>("mastersync", "Master Sync", juce::NormalisableRange<float>(0.0f, 16.0f, 1.0f), 0.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("mastertime", "Master Time", juce::NormalisableRange<float>(0.0f, 5000.0f, 1.0f), 1000.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("masterfeedback", "Master Feedback", juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 25.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("masterwet", "Master Wet", juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 25.0f));
-
-    for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
-    {
-        std::string ch_str = std::to_string(ch+1);
-        std::string parameterID, parameterName;
-
-        parameterID = "chsync" + ch_str;
-        parameterName = "Channel " + ch_str + " Sync";
-        layout.add(std::make_unique<juce::AudioParameterFloat>(parameterID, parameterName,juce::NormalisableRange<float>(0.0f, 16.0f, 1.0f), 0.0f));
-
-        parameterID = "chtime" + ch_str;
-        parameterName = "Channel " + ch_str + " Time";
-        layout.add(std::make_unique<juce::AudioParameterFloat>(parameterID, parameterName, juce::NormalisableRange<float>(0.0f, 5000.0f, 1.0f), 1000.0f));
-
-        parameterID = "chfeedback" + ch_str;
-        parameterName = "Channel " + ch_str + " Feedback";
-        layout.add(std::make_unique<juce::AudioParameterFloat>(parameterID, parameterName, juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 0.0f));
-
-        parameterID = "chwet" + ch_str;
-        parameterName = "Channel " + ch_str + " Wet";
-        layout.add(std::make_unique<juce::AudioParameterFloat>(parameterID, parameterName, juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 0.0f));
-    }
-
-    return layout;
-}
-()
-         )
-{
-    if (!treeState.state.hasProperty("selChannel"))
-    {
-        treeState.state.setProperty("selchannel", 1, nullptr);
-    }
-
-    masterSyncParameter = treeState.getRawParameterValue("mastersync");
-    masterTimeParameter = treeState.getRawParameterValue("mastertime");
-    masterFeedbackParameter = treeState.getRawParameterValue("masterfeedback");
-    masterMixParameter = treeState.getRawParameterValue("masterwet");
-
-    for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
-    {
-        std::string ch_str = std::to_string(ch+1);
-        chSyncParameters.at(ch) = treeState.getRawParameterValue("chsync" + ch_str);
-        chTimeParameters.at(ch) = treeState.getRawParameterValue("chtime" + ch_str);
-        chFeedbackParameters.at(ch) = treeState.getRawParameterValue("chfeedback" + ch_str);
-        chMixParameters.at(ch) = treeState.getRawParameterValue("chwet" + ch_str);
-    }
-
-    updateParams();
-}
-
-Delay64AudioProcessor::~Delay64AudioProcessor()
-{
-}
-
-const juce::String Delay64AudioProcessor::getName() const
-{
-    return JucePlugin_Name;
-}
-
-bool Delay64AudioProcessor::acceptsMidi() const
-{
-#if JucePlugin_WantsMidiInput
-    return true;
-#else
-    return false;
-#endif
-}
-
-bool Delay64AudioProcessor::producesMidi() const
-{
-#if JucePlugin_ProducesMidiOutput
-    return true;
-#else
-    return false;
-#endif
-}
-
-bool Delay64AudioProcessor::isMidiEffect() const
-{
-#if JucePlugin_IsMidiEffect
-    return true;
-#else
-    return false;
-#endif
-}
-
-double Delay64AudioProcessor::getTailLengthSeconds() const
-{
-    return 0.0;
-}
-
-int Delay64AudioProcessor::getNumPrograms()
-{
-    return 1;
-}
-
-int Delay64AudioProcessor::getCurrentProgram()
-{
-    return 0;
-}
-
-void Delay64AudioProcessor::setCurrentProgram(int index)
-{
-    juce::ignoreUnused(index);
-}
-
-const juce::String Delay64AudioProcessor::getProgramName(int index)
-{
-    juce::ignoreUnused(index);
-
-    return {};
-}
-
-void Delay64AudioProcessor::changeProgramName(int index, const juce::String& newName)
-{
-    juce::ignoreUnused(index, newName);
-}
-
-void Delay64AudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
-{
-    juce::ignoreUnused(samplesPerBlock);
-
-    for (unsigned int ch = 0; ch < (unsigned int)std::min(getTotalNumInputChannels(), MAX_CHANS); ++ch)
-    {
-        chDelays.at(ch).set_sample_rate(static_cast<float>(sampleRate));
-        masterDelays.at(ch).set_sample_rate(static_cast<float>(sampleRate));
-        chDelays.at(ch).set_max_time(5000.0f, true);
-        masterDelays.at(ch).set_max_time(5000.0f, true);
-    }
-
-    updateParams();
-}
-
-void Delay64AudioProcessor::releaseResources()
-{
-
-}
-
-#ifndef JucePlugin_PreferredChannelConfigurations
-bool Delay64AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
-{
-#if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
-        return false;
-#endif
-
-    return true;
-}
-#endif
-
-void Delay64AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
-{
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
-
-    juce::ignoreUnused(midiMessages);
-
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-    {
-        buffer.clear(i, 0, buffer.getNumSamples());
-    }
-
-    auto currPlayHead = getPlayHead();
-    if (currPlayHead)
-    {
-        posInfo = *(currPlayHead->getPosition());
-        {
-            bpm = static_cast<float>(*(posInfo.getBpm()));
-        }
-    }
-
-    updateParams();
-
-    for (unsigned int ch = 0; ch < (unsigned int)totalNumInputChannels; ++ch)
-    {
-        auto* channelData = buffer.getWritePointer(ch);
-
-        if (ch < MAX_CHANS)
-        {
-            for (auto i = 0; i < buffer.getNumSamples(); ++i)
-            {
-                // Update delay time with smoothed values, since it cycles across all channels,
-                // we need to update it only once per buffer
-                if (ch == 0)
-                {
-                    updateParams(true);
-                }
-
-                // Channel delay
-                const float chDelayed = chDelays.at(ch).run(channelData[i]);
-                auto chSample = chDelayed * (*(chMixParameters.at(ch)) * 0.01f) + channelData[i] * (1.0f - (*(chMixParameters.at(ch)) * 0.01f));
-
-                // Master delay
-                const float masterDelayed = masterDelays.at(ch).run(chSample);
-                channelData[i] = masterDelayed * (*masterMixParameter * 0.01f) + chSample * (1.0f - (*masterMixParameter * 0.01f));
-            }
-        }
-    }
-}
-
-bool Delay64AudioProcessor::hasEditor() const
-{
-    return true;
-}
-
-juce::AudioProcessorEditor* Delay64AudioProcessor::createEditor()
-{
-    return new Delay64AudioProcessorEditor(*this);
-}
-
-void Delay64AudioProcessor::getStateInformation(juce::MemoryBlock& destData)
-{
-    auto state = treeState.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
-}
-
-void Delay64AudioProcessor::setStateInformation(const void* data, int sizeInBytes)
-{
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-    if (xmlState.get() != nullptr)
-    {
-        if (xmlState->hasTagName(treeState.state.getType()))
-        {
-            treeState.replaceState(juce::ValueTree::fromXml(*xmlState));
-
-            if (treeState.state.hasProperty("selchannel"))
-            {
-                selChannel.referTo(treeState.state.getPropertyAsValue("selchannel", nullptr));
-            }
-        }
-    }
-}
-
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
-{
-    return new Delay64AudioProcessor();
-}
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+Delay64AudioProcessor::Delay64AudioProcessor() :
+#ifndef JucePlugin_PreferredChannelConfigurations
+    AudioProcessor(BusesProperties()
+#if ! JucePlugin_IsMidiEffect
+#if ! JucePlugin_IsSynth
+                   .withInput("Input", juce::AudioChannelSet::stereo(), true)
+#endif
+                   .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+#endif
+                  ),
+#endif
+    treeState(*this, nullptr, juce::Identifier("Delay64Parameters"),
+              [&]()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    ParameterTable::addMaster(layout, ParameterTable::delaySpecs);
+    ParameterTable::addChannels(layout, ParameterTable::delaySpecs);
+
+    // Interpolates between the morph scenes of the preset bank, appended so
+    // that the indices of the other parameters do not change
+    layout.add(std::make_unique<juce::AudioParameterFloat>(PresetBank::morphParameterID, "Morph", juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 0.0f));
+
+    // Auto, Eco, Standard or High, appended for the same reason
+    layout.add(QualityTier::createParameter());
+
+    // Runs the master stage on a helper thread, appended for the same reason
+    layout.add(std::make_unique<juce::AudioParameterFloat>("pipeline", "Pipelined Master", juce::NormalisableRange<float>(0.0f, 1.0f, 1.0f), 0.0f));
+
+    return layout;
+}
+()
+         )
+{
+    if (!treeState.state.hasProperty("selChannel"))
+    {
+        treeState.state.setProperty("selchannel", 1, nullptr);
+    }
+
+    // In the order of the layout
+    ParameterTable::Cursor parameters(*this);
+    masterSyncParameter = parameters.next();
+    masterTimeParameter = parameters.next();
+    masterFeedbackParameter = parameters.next();
+    masterMixParameter = parameters.next();
+
+    for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+    {
+        chSyncParameters.at(ch) = parameters.next();
+        chTimeParameters.at(ch) = parameters.next();
+        chFeedbackParameters.at(ch) = parameters.next();
+        chMixParameters.at(ch) = parameters.next();
+    }
+
+    // The morph parameter is taken by the preset bank
+    parameters.next();
+    qualityParameter = parameters.next();
+    pipelineParameter = parameters.next();
+
+    // Choices switch halfway through a morph
+    presetBank.setDiscrete(masterSyncParameter);
+    for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+    {
+        presetBank.setDiscrete(chSyncParameters.at(ch));
+    }
+
+    stateLoader.onRestored = [this]
+    {
+        if (treeState.state.hasProperty("selchannel"))
+        {
+            selChannel.referTo(treeState.state.getPropertyAsValue("selchannel", nullptr));
+        }
+    };
+
+    updateParams();
+
+    startTimerHz(10);
+}
+
+Delay64AudioProcessor::~Delay64AudioProcessor()
+{
+    stopTimer();
+}
+
+const juce::String Delay64AudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool Delay64AudioProcessor::acceptsMidi() const
+{
+#if JucePlugin_WantsMidiInput
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Delay64AudioProcessor::producesMidi() const
+{
+#if JucePlugin_ProducesMidiOutput
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Delay64AudioProcessor::isMidiEffect() const
+{
+#if JucePlugin_IsMidiEffect
+    return true;
+#else
+    return false;
+#endif
+}
+
+double Delay64AudioProcessor::getTailLengthSeconds() const
+{
+    return 0.0;
+}
+
+int Delay64AudioProcessor::getNumPrograms()
+{
+    // Hosts expect at least one program
+    return std::max(presetBank.getNumPresets(), 1);
+}
+
+int Delay64AudioProcessor::getCurrentProgram()
+{
+    return std::max(presetBank.getCurrentIndex(), 0);
+}
+
+void Delay64AudioProcessor::setCurrentProgram(int index)
+{
+    presetBank.select(index);
+}
+
+const juce::String Delay64AudioProcessor::getProgramName(int index)
+{
+    return presetBank.getName(index);
+}
+
+void Delay64AudioProcessor::changeProgramName(int index, const juce::String& newName)
+{
+    presetBank.setName(index, newName);
+    updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+}
+
+int Delay64AudioProcessor::storePreset(const juce::String& name)
+{
+    const int index = presetBank.add(name);
+    updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+    return index;
+}
+
+void Delay64AudioProcessor::setMorphScenes(int indexA, int indexB)
+{
+    presetBank.setMorphScenes(indexA, indexB);
+}
+
+void Delay64AudioProcessor::resetChannels(int first, int last)
+{
+    BulkEdit edit(presetBank);
+    edit.resetChannels([this](int ch) { return getChannelParameters(ch); }, first, last);
+    edit.commit();
+}
+
+void Delay64AudioProcessor::copyChannel(int source, int first, int last)
+{
+    BulkEdit edit(presetBank);
+    edit.copyChannel([this](int ch) { return getChannelParameters(ch); }, source, first, last);
+    edit.commit();
+}
+
+void Delay64AudioProcessor::randomiseChannels(int first, int last)
+{
+    BulkEdit edit(presetBank);
+    edit.randomiseChannels([this](int ch) { return getChannelParameters(ch); }, juce::Random::getSystemRandom(), first, last);
+    edit.commit();
+}
+
+std::array<juce::AudioParameterFloat*, 4> Delay64AudioProcessor::getChannelParameters(int ch) const
+{
+    return {chSyncParameters.at((size_t)ch), chTimeParameters.at((size_t)ch), chFeedbackParameters.at((size_t)ch), chMixParameters.at((size_t)ch)};
+}
+
+void Delay64AudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    // The pipeline is prepared first, so that its helper thread is stopped
+    // while the engine is reset
+    pipeline.prepare(sampleRate, samplesPerBlock, getTotalNumInputChannels());
+    engine.prepare(sampleRate, samplesPerBlock, getTotalNumInputChannels());
+    levelMeters.prepare(sampleRate, getTotalNumInputChannels());
+    governor.prepare(sampleRate);
+    metrics.setGovernorLevel(0);
+
+    applyQuality();
+    pipelineActive = pipelineParameter->get() >= 0.5f;
+    setLatencySamples(pipelineActive ? pipeline.getLatencySamples() : 0);
+    pipeline.setEnabled(pipelineActive);
+
+    updateParams();
+
+    metrics.prepare(sampleRate, samplesPerBlock, engine.getMemoryBytes() + pipeline.getMemoryBytes());
+}
+
+void Delay64AudioProcessor::releaseResources()
+{
+    pipeline.release();
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+bool Delay64AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+#if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+#endif
+
+    return true;
+}
+#endif
+
+void Delay64AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    metrics.beginBlock();
+
+    auto totalNumInputChannels = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    juce::ignoreUnused(midiMessages);
+
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+    {
+        buffer.clear(i, 0, buffer.getNumSamples());
+    }
+
+    auto currPlayHead = getPlayHead();
+    if (currPlayHead)
+    {
+        posInfo = *(currPlayHead->getPosition());
+        {
+            bpm = static_cast<float>(*(posInfo.getBpm()));
+        }
+    }
+
+    const bool pipelined = pipelineParameter->get() >= 0.5f;
+    if (pipelined != pipelineActive)
+    {
+        pipeline.reset();
+        pipelineActive = pipelined;
+    }
+
+    applyQuality();
+
+    auto* const* channels = buffer.getArrayOfWritePointers();
+
+    presetBank.processSteps(channels, totalNumInputChannels, buffer.getNumSamples(),
+        [this](int step) { updateParams(step); },
+        [this](float* const* stepChannels, int numChannels, int numSamples)
+        {
+            if (pipelineActive)
+            {
+                pipeline.process(stepChannels, numChannels, numSamples, engineParameters.master);
+            }
+            else
+            {
+                engine.process(stepChannels, numChannels, numSamples);
+            }
+        });
+
+    levelMeters.process(buffer.getArrayOfReadPointers(), totalNumInputChannels, buffer.getNumSamples());
+
+    const int activeChannels = std::min(totalNumInputChannels, MAX_CHANS);
+    metrics.endBlock(buffer.getNumSamples(), activeChannels, engine.countSleepingChannels(activeChannels));
+
+    if (governor.endBlock(metrics.getLastBlockNanos(), buffer.getNumSamples(), isNonRealtime(), metrics.getProcessLoad()))
+    {
+        metrics.setGovernorLevel(governor.getLevel());
+    }
+}
+
+void Delay64AudioProcessor::applyQuality()
+{
+    const auto tier = QualityTier::resolve(*qualityParameter, isNonRealtime(), governor.getLevel());
+    engine.setRampStride(QualityTier::getRampStride(tier));
+    engine.setHalfRate(QualityTier::runsAtHalfRate(tier));
+    engine.setCubicInterpolation(QualityTier::interpolatesCubically(tier));
+}
+
+void Delay64AudioProcessor::timerCallback()
+{
+    pipeline.setEnabled(pipelineActive);
+
+    const int latency = pipelineActive ? pipeline.getLatencySamples() : 0;
+
+    if (latency != getLatencySamples())
+    {
+        setLatencySamples(latency);
+    }
+}
+
+bool Delay64AudioProcessor::hasEditor() const
+{
+    return true;
+}
+
+juce::AudioProcessorEditor* Delay64AudioProcessor::createEditor()
+{
+    return new Delay64AudioProcessorEditor(*this);
+}
+
+void Delay64AudioProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    if (stateLoader.getPendingState(destData))
+    {
+        return;
+    }
+
+    auto state = treeState.copyState();
+    std::unique_ptr<juce::XmlElement> xml(state.createXml());
+    presetBank.writeTo(*xml);
+    copyXmlToBinary(*xml, destData);
+}
+
+void Delay64AudioProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    // Decoded in the background, then applied by onRestored
+    stateLoader.load(data, sizeInBytes, isNonRealtime());
+}
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new Delay64AudioProcessor();
+}
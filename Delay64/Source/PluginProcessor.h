@@ -1,146 +1,181 @@
-/******************************************************************************
-This file is part of Plug64.
-Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
-
-Plug64 is free software: you can redistribute it and/or modify it under
-the terms of the GNU General Public License as published by the Free Software
-Foundation, either version 3 of the License, or (at your option) any later
-version.
-
-Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
-WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
-A PARTICULAR PURPOSE. See the GNU General Public License for more details.
-
-You should have received a copy of the GNU General Public License along with
-Plug64. If not, see <https://www.gnu.org/licenses/>.
-******************************************************************************/
-
-#pragma once
-
-#include <array>
-#include <atomic>
-#include <juce_audio_basics/juce_audio_basics.h>
-#include <juce_audio_devices/juce_audio_devices.h>
-#include <juce_audio_formats/juce_audio_formats.h>
-#include <juce_audio_plugin_client/juce_audio_plugin_client.h>
-#include <juce_audio_processors/juce_audio_processors.h>
-#include <juce_audio_utils/juce_audio_utils.h>
-#include <juce_core/juce_core.h>
-#include <juce_data_structures/juce_data_structures.h>
-#include <juce_dsp/juce_dsp.h>
-#include <juce_events/juce_events.h>
-#include <juce_graphics/juce_graphics.h>
-#include <juce_gui_basics/juce_gui_basics.h>
-#include <juce_gui_extra/juce_gui_extra.h>
-#include "BinaryData.h"
-#include "soutel/include/soutel/delay.h"
-
-class Delay64AudioProcessor : public juce::AudioProcessor
-{
-public:
-    Delay64AudioProcessor();
-    ~Delay64AudioProcessor() override;
-
-    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-#ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
-#endif
-
-    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
-    juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram(int index) override;
-    const juce::String getProgramName(int index) override;
-    void changeProgramName(int index, const juce::String& newName) override;
-
-    void getStateInformation(juce::MemoryBlock& destData) override;
-    void setStateInformation(const void* data, int sizeInBytes) override;
-
-    juce::AudioProcessorValueTreeState treeState;
-
-    std::array<std::atomic<float>*, MAX_CHANS> chSyncParameters = {nullptr};
-    std::array<std::atomic<float>*, MAX_CHANS> chTimeParameters = {nullptr};
-    std::array<std::atomic<float>*, MAX_CHANS> chFeedbackParameters = {nullptr};
-    std::array<std::atomic<float>*, MAX_CHANS> chMixParameters = {nullptr};
-    std::array<float, MAX_CHANS> chDelayTimes = {1000.0f};
-    std::atomic<float>* masterSyncParameter = nullptr;
-    std::atomic<float>* masterTimeParameter = nullptr;
-    std::atomic<float>* masterFeedbackParameter = nullptr;
-    std::atomic<float>* masterMixParameter = nullptr;
-    float masterDelayTime = 1000.0f;
-
-    juce::Value selChannel;
-
-private:
-    std::array<soutel::Delay<float>, MAX_CHANS> chDelays;
-    std::array<soutel::Delay<float>, MAX_CHANS> masterDelays;
-    std::array<juce::SmoothedValue<float>, MAX_CHANS> masterTimeSmoothers;
-    std::array<juce::SmoothedValue<float>, MAX_CHANS> chTimeSmoothers;
-    float bpm = 0.0f;
-    juce::AudioPlayHead::PositionInfo posInfo;
-
-    inline void updateParams(const bool &onlySmoothers = false)
-    {
-        if (!onlySmoothers)
-        {
-            auto masterSync = static_cast<int>(*masterSyncParameter);
-            if (masterSync == 0 || bpm < 1.0)
-            {
-                masterDelayTime = *masterTimeParameter;
-            }
-            else
-            {
-                masterDelayTime = (60000.0f / (bpm * 4.0f)) * static_cast<float>(masterSync);
-            }
-        }
-
-        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
-        {
-            if (!onlySmoothers)
-            {
-                auto chSync = static_cast<int>(*(chSyncParameters.at(ch)));
-                if (chSync == 0 || bpm < 1.0)
-                {
-                    chDelayTimes.at(ch) = *(chTimeParameters.at(ch));
-                }
-                else
-                {
-                    chDelayTimes.at(ch) = (60000.0f / (bpm * 4.0f)) * static_cast<float>(chSync);
-                }
-
-                if (!juce::exactlyEqual(chTimeSmoothers.at(ch).getTargetValue(), chDelayTimes.at(ch)))
-                {
-                    chTimeSmoothers.at(ch).setTargetValue(chDelayTimes.at(ch));
-                }
-
-                chDelays.at(ch).set_feedback(*(chFeedbackParameters.at(ch)) * 0.01f);
-
-
-                if (!juce::exactlyEqual(masterTimeSmoothers.at(ch).getTargetValue(), masterDelayTime))
-                {
-                    masterTimeSmoothers.at(ch).setTargetValue(masterDelayTime);
-                }
-
-                masterDelays.at(ch).set_feedback(*masterFeedbackParameter * 0.01f);
-            }
-
-            masterDelays.at(ch).set_time(masterTimeSmoothers.at(ch).getNextValue());
-            chDelays.at(ch).set_time(chTimeSmoothers.at(ch).getNextValue());
-        }
-    }
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Delay64AudioProcessor)
-};
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_plugin_client/juce_audio_plugin_client.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_audio_utils/juce_audio_utils.h>
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_events/juce_events.h>
+#include <juce_graphics/juce_graphics.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_gui_extra/juce_gui_extra.h>
+#include "BinaryData.h"
+#include "DelayEngine.h"
+#include "MasterStagePipeline.h"
+#include "InstanceMetrics.h"
+#include "LevelMeters.h"
+#include "ParameterTable.h"
+#include "PresetBank.h"
+#include "QualityTier.h"
+#include "BulkEdit.h"
+#include "CpuGovernor.h"
+#include "StateLoader.h"
+
+class Delay64AudioProcessor : public juce::AudioProcessor,
+    private juce::Timer
+{
+public:
+    Delay64AudioProcessor();
+    ~Delay64AudioProcessor() override;
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+#endif
+
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram(int index) override;
+    const juce::String getProgramName(int index) override;
+    void changeProgramName(int index, const juce::String& newName) override;
+
+    void getStateInformation(juce::MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+    // Bulk edits of the channel parameters, from channel first to last (0
+    // based, included), each applied in one step
+    void resetChannels(int first = 0, int last = MAX_CHANS - 1);
+    void copyChannel(int source, int first = 0, int last = MAX_CHANS - 1);
+    void randomiseChannels(int first = 0, int last = MAX_CHANS - 1);
+
+    // Stores the current parameter values as a new preset, which becomes the
+    // current program, returning its index; presets are renamed through
+    // changeProgramName()
+    int storePreset(const juce::String& name);
+
+    // Assigns the presets the "Morph" parameter interpolates between, or
+    // stops morphing when either index is not a preset
+    void setMorphScenes(int indexA, int indexB);
+
+    // Levels of the output channels, shown by the editor
+    LevelMeters& getLevelMeters()
+    {
+        return levelMeters;
+    }
+
+    juce::AudioProcessorValueTreeState treeState;
+
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chSyncParameters = {nullptr};
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chTimeParameters = {nullptr};
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chFeedbackParameters = {nullptr};
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chMixParameters = {nullptr};
+    juce::AudioParameterFloat* masterSyncParameter = nullptr;
+    juce::AudioParameterFloat* masterTimeParameter = nullptr;
+    juce::AudioParameterFloat* masterFeedbackParameter = nullptr;
+    juce::AudioParameterFloat* masterMixParameter = nullptr;
+    juce::AudioParameterFloat* pipelineParameter = nullptr;
+    juce::AudioParameterFloat* qualityParameter = nullptr;
+
+    juce::Value selChannel;
+
+private:
+    DelayEngine engine;
+    DelayEngine::Parameters engineParameters;
+    MasterStagePipeline<DelayEngine> pipeline{engine};
+    std::atomic<bool> pipelineActive{false};
+    InstanceMetrics metrics{JucePlugin_Name};
+    CpuGovernor governor;
+    LevelMeters levelMeters;
+    PresetBank presetBank{treeState};
+    StateLoader stateLoader{treeState, presetBank};
+    float bpm = 0.0f;
+    juce::AudioPlayHead::PositionInfo posInfo;
+
+    // Runs the helper thread of the pipeline only in pipelined mode, and
+    // reports its latency from the message thread, since
+    // setLatencySamples() is not realtime safe
+    void timerCallback() override;
+
+    // Sets the engine to the quality tier, as lowered by the governor under
+    // overload
+    void applyQuality();
+
+    std::array<juce::AudioParameterFloat*, 4> getChannelParameters(int ch) const;
+
+    // With a step, reads the values of that step of the block being processed
+    inline void updateParams(int step = -1)
+    {
+        const PresetBank::Reader read(presetBank, step);
+
+        engineParameters.master.sync = static_cast<int>(read(masterSyncParameter));
+        engineParameters.master.time = read(masterTimeParameter);
+        engineParameters.master.feedback = read(masterFeedbackParameter);
+        engineParameters.master.wet = read(masterMixParameter);
+
+        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            auto& chParameters = engineParameters.channels.at(ch);
+            chParameters.sync = static_cast<int>(read(chSyncParameters.at(ch)));
+            chParameters.time = read(chTimeParameters.at(ch));
+            chParameters.feedback = read(chFeedbackParameters.at(ch));
+            chParameters.wet = read(chMixParameters.at(ch));
+        }
+
+        // In pipelined mode the master parameters are applied by the pipeline,
+        // when the helper thread is not using them
+        if (pipelineActive)
+        {
+            engine.setChannelParameters(engineParameters, bpm);
+        }
+        else
+        {
+            engine.setParameters(engineParameters, bpm);
+        }
+
+        // The master stage of the pipelined mode always ramps, since it may
+        // be running on the helper thread
+        if (presetBank.takeJump() && !pipelineActive)
+        {
+            engine.jumpToTargets();
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Delay64AudioProcessor)
+};
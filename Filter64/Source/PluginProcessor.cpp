@@ -1,252 +1,354 @@
-/******************************************************************************
-This file is part of Plug64.
-Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
-
-Plug64 is free software: you can redistribute it and/or modify it under
-the terms of the GNU General Public License as published by the Free Software
-Foundation, either version 3 of the License, or (at your option) any later
-version.
-
-Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
-WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
-A PARTICULAR PURPOSE. See the GNU General Public License for more details.
-
-You should have received a copy of the GNU General Public License along with
-Plug64. If not, see <https://www.gnu.org/licenses/>.
-******************************************************************************/
-
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-#include <string>
-
-Filter64AudioProcessor::Filter64AudioProcessor() :
-#ifndef JucePlugin_PreferredChannelConfigurations
-    AudioProcessor(BusesProperties()
-#if ! JucePlugin_IsMidiEffect
-#if ! JucePlugin_IsSynth
-                   .withInput("Input", juce::AudioChannelSet::stereo(), true)
-#endif
-                   .withOutput("Output", juce::AudioChannelSet::stereo(), true)
-#endif
-                  ),
-#endif
-    treeState(*this, nullptr, juce::Identifier("Filter64Parameters"),
-              [&]()
-{
-    juce::AudioProcessorValueTreeState::ParameterLayout layout;
-
-    layout.add(std::make_unique<juce::AudioParameterFloat>("mastertype", "Master Filter", juce::NormalisableRange<float>(0.0f, 6.0f, 1.0f), 0.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("mastercutoff", "Master Cutoff", juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.4f, false), 20000.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("masterresonance", "Master Resonance", juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 5.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("masterdrive", "Master Drive", juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 0.0f));
-
-    for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
-    {
-        std::string ch_str = std::to_string(ch+1);
-        std::string parameterID, parameterName;
-
-        parameterID = "chtype" + ch_str;
-        parameterName = "Channel " + ch_str + " Filter";
-        layout.add(std::make_unique<juce::AudioParameterFloat>(parameterID, parameterName,juce::NormalisableRange<float>(0.0f, 6.0f, 1.0f), 0.0f));
-
-        parameterID = "chcutoff" + ch_str;
-        parameterName = "Channel " + ch_str + " Cutoff";
-        layout.add(std::make_unique<juce::AudioParameterFloat>(parameterID, parameterName, juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.4f, false), 20000.0f));
-
-        parameterID = "chresonance" + ch_str;
-        parameterName = "Channel " + ch_str + " Resonance";
-        layout.add(std::make_unique<juce::AudioParameterFloat>(parameterID, parameterName, juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 5.0f));
-
-        parameterID = "chdrive" + ch_str;
-        parameterName = "Channel " + ch_str + " Drive";
-        layout.add(std::make_unique<juce::AudioParameterFloat>(parameterID, parameterName, juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 0.0f));
-    }
-
-    return layout;
-}
-()
-         )
-{
-    if (!treeState.state.hasProperty("selChannel"))
-    {
-        treeState.state.setProperty("selchannel", 1, nullptr);
-    }
-
-    masterTypeParameter = treeState.getRawParameterValue("mastertype");
-    masterCutoffParameter = treeState.getRawParameterValue("mastercutoff");
-    masterResonanceParameter = treeState.getRawParameterValue("masterresonance");
-    masterDriveParameter = treeState.getRawParameterValue("masterdrive");
-
-    for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
-    {
-        std::string ch_str = std::to_string(ch+1);
-        chTypeParameters.at(ch) = treeState.getRawParameterValue("chtype" + ch_str);
-        chCutoffParameters.at(ch) = treeState.getRawParameterValue("chcutoff" + ch_str);
-        chResonanceParameters.at(ch) = treeState.getRawParameterValue("chresonance" + ch_str);
-        chDriveParameters.at(ch) = treeState.getRawParameterValue("chdrive" + ch_str);
-    }
-}
-
-Filter64AudioProcessor::~Filter64AudioProcessor()
-{
-}
-
-const juce::String Filter64AudioProcessor::getName() const
-{
-    return JucePlugin_Name;
-}
-
-bool Filter64AudioProcessor::acceptsMidi() const
-{
-#if JucePlugin_WantsMidiInput
-    return true;
-#else
-    return false;
-#endif
-}
-
-bool Filter64AudioProcessor::producesMidi() const
-{
-#if JucePlugin_ProducesMidiOutput
-    return true;
-#else
-    return false;
-#endif
-}
-
-bool Filter64AudioProcessor::isMidiEffect() const
-{
-#if JucePlugin_IsMidiEffect
-    return true;
-#else
-    return false;
-#endif
-}
-
-double Filter64AudioProcessor::getTailLengthSeconds() const
-{
-    return 0.0;
-}
-
-int Filter64AudioProcessor::getNumPrograms()
-{
-    return 1;
-}
-
-int Filter64AudioProcessor::getCurrentProgram()
-{
-    return 0;
-}
-
-void Filter64AudioProcessor::setCurrentProgram(int index)
-{
-    juce::ignoreUnused(index);
-}
-
-const juce::String Filter64AudioProcessor::getProgramName(int index)
-{
-    juce::ignoreUnused(index);
-
-    return {};
-}
-
-void Filter64AudioProcessor::changeProgramName(int index, const juce::String& newName)
-{
-    juce::ignoreUnused(index, newName);
-}
-
-void Filter64AudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
-{
-    juce::dsp::ProcessSpec spec{sampleRate, (juce::uint32)samplesPerBlock, 1};
-
-    for (unsigned int ch = 0; ch < (unsigned int)std::min(getTotalNumInputChannels(), MAX_CHANS); ++ch)
-    {
-        processorChains.at(ch).prepare(spec);
-    }
-    
-    updateParams();
-}
-
-void Filter64AudioProcessor::releaseResources()
-{
-
-}
-
-#ifndef JucePlugin_PreferredChannelConfigurations
-bool Filter64AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
-{
-#if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
-        return false;
-#endif
-
-    return true;
-}
-#endif
-
-void Filter64AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
-{
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
-
-    juce::ignoreUnused(midiMessages);
-
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-    {
-        buffer.clear(i, 0, buffer.getNumSamples());
-    }
-
-    juce::dsp::AudioBlock<float> block(buffer);
-
-    updateParams();
-
-    for (unsigned int ch = 0; ch < (unsigned int)totalNumInputChannels; ++ch)
-    {
-        if (ch < MAX_CHANS)
-        {
-            auto channelBlock = block.getSingleChannelBlock(ch);
-            juce::dsp::ProcessContextReplacing<float> context(channelBlock);
-            processorChains.at(ch).process(context);
-        }
-    }
-}
-
-bool Filter64AudioProcessor::hasEditor() const
-{
-    return true;
-}
-
-juce::AudioProcessorEditor* Filter64AudioProcessor::createEditor()
-{
-    return new Filter64AudioProcessorEditor(*this);
-}
-
-void Filter64AudioProcessor::getStateInformation(juce::MemoryBlock& destData)
-{
-    auto state = treeState.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
-}
-
-void Filter64AudioProcessor::setStateInformation(const void* data, int sizeInBytes)
-{
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-    if (xmlState.get() != nullptr)
-    {
-        if (xmlState->hasTagName(treeState.state.getType()))
-        {
-            treeState.replaceState(juce::ValueTree::fromXml(*xmlState));
-
-            if (treeState.state.hasProperty("selchannel"))
-            {
-                selChannel.referTo(treeState.state.getPropertyAsValue("selchannel", nullptr));
-            }
-        }
-    }
-}
-
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
-{
-    return new Filter64AudioProcessor();
-}
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+Filter64AudioProcessor::Filter64AudioProcessor() :
+#ifndef JucePlugin_PreferredChannelConfigurations
+    AudioProcessor(BusesProperties()
+#if ! JucePlugin_IsMidiEffect
+#if ! JucePlugin_IsSynth
+                   .withInput("Input", juce::AudioChannelSet::stereo(), true)
+#endif
+                   .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+#endif
+                  ),
+#endif
+    treeState(*this, nullptr, juce::Identifier("Filter64Parameters"),
+              [&]()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    ParameterTable::addMaster(layout, ParameterTable::filterSpecs);
+    ParameterTable::addChannels(layout, ParameterTable::filterSpecs);
+
+    // Interpolates between the morph scenes of the preset bank, appended so
+    // that the indices of the other parameters do not change
+    layout.add(std::make_unique<juce::AudioParameterFloat>(PresetBank::morphParameterID, "Morph", juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 0.0f));
+
+    // Off, 2x or 4x, appended for the same reason
+    layout.add(std::make_unique<juce::AudioParameterFloat>("oversampling", "Oversampling", juce::NormalisableRange<float>(0.0f, 2.0f, 1.0f), 0.0f));
+
+    // Auto, Eco, Standard or High
+    layout.add(QualityTier::createParameter());
+
+    // Runs the master stage on a helper thread, appended for the same reason
+    layout.add(std::make_unique<juce::AudioParameterFloat>("pipeline", "Pipelined Master", juce::NormalisableRange<float>(0.0f, 1.0f, 1.0f), 0.0f));
+
+    return layout;
+}
+()
+         )
+{
+    if (!treeState.state.hasProperty("selChannel"))
+    {
+        treeState.state.setProperty("selchannel", 1, nullptr);
+    }
+
+    // In the order of the layout
+    ParameterTable::Cursor parameters(*this);
+    masterTypeParameter = parameters.next();
+    masterCutoffParameter = parameters.next();
+    masterResonanceParameter = parameters.next();
+    masterDriveParameter = parameters.next();
+
+    for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+    {
+        chTypeParameters.at(ch) = parameters.next();
+        chCutoffParameters.at(ch) = parameters.next();
+        chResonanceParameters.at(ch) = parameters.next();
+        chDriveParameters.at(ch) = parameters.next();
+    }
+
+    // The morph parameter is taken by the preset bank
+    parameters.next();
+    oversamplingParameter = parameters.next();
+    qualityParameter = parameters.next();
+    pipelineParameter = parameters.next();
+
+    // Choices switch halfway through a morph
+    presetBank.setDiscrete(masterTypeParameter);
+    for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+    {
+        presetBank.setDiscrete(chTypeParameters.at(ch));
+    }
+
+    stateLoader.onRestored = [this]
+    {
+        if (treeState.state.hasProperty("selchannel"))
+        {
+            selChannel.referTo(treeState.state.getPropertyAsValue("selchannel", nullptr));
+        }
+    };
+
+    startTimerHz(10);
+}
+
+Filter64AudioProcessor::~Filter64AudioProcessor()
+{
+    stopTimer();
+}
+
+const juce::String Filter64AudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool Filter64AudioProcessor::acceptsMidi() const
+{
+#if JucePlugin_WantsMidiInput
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Filter64AudioProcessor::producesMidi() const
+{
+#if JucePlugin_ProducesMidiOutput
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Filter64AudioProcessor::isMidiEffect() const
+{
+#if JucePlugin_IsMidiEffect
+    return true;
+#else
+    return false;
+#endif
+}
+
+double Filter64AudioProcessor::getTailLengthSeconds() const
+{
+    return 0.0;
+}
+
+int Filter64AudioProcessor::getNumPrograms()
+{
+    // Hosts expect at least one program
+    return std::max(presetBank.getNumPresets(), 1);
+}
+
+int Filter64AudioProcessor::getCurrentProgram()
+{
+    return std::max(presetBank.getCurrentIndex(), 0);
+}
+
+void Filter64AudioProcessor::setCurrentProgram(int index)
+{
+    presetBank.select(index);
+}
+
+const juce::String Filter64AudioProcessor::getProgramName(int index)
+{
+    return presetBank.getName(index);
+}
+
+void Filter64AudioProcessor::changeProgramName(int index, const juce::String& newName)
+{
+    presetBank.setName(index, newName);
+    updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+}
+
+int Filter64AudioProcessor::storePreset(const juce::String& name)
+{
+    const int index = presetBank.add(name);
+    updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+    return index;
+}
+
+void Filter64AudioProcessor::setMorphScenes(int indexA, int indexB)
+{
+    presetBank.setMorphScenes(indexA, indexB);
+}
+
+void Filter64AudioProcessor::resetChannels(int first, int last)
+{
+    BulkEdit edit(presetBank);
+    edit.resetChannels([this](int ch) { return getChannelParameters(ch); }, first, last);
+    edit.commit();
+}
+
+void Filter64AudioProcessor::copyChannel(int source, int first, int last)
+{
+    BulkEdit edit(presetBank);
+    edit.copyChannel([this](int ch) { return getChannelParameters(ch); }, source, first, last);
+    edit.commit();
+}
+
+void Filter64AudioProcessor::randomiseChannels(int first, int last)
+{
+    BulkEdit edit(presetBank);
+    edit.randomiseChannels([this](int ch) { return getChannelParameters(ch); }, juce::Random::getSystemRandom(), first, last);
+    edit.commit();
+}
+
+std::array<juce::AudioParameterFloat*, 4> Filter64AudioProcessor::getChannelParameters(int ch) const
+{
+    return {chTypeParameters.at((size_t)ch), chCutoffParameters.at((size_t)ch), chResonanceParameters.at((size_t)ch), chDriveParameters.at((size_t)ch)};
+}
+
+void Filter64AudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    // The pipeline is prepared first, so that its helper thread is stopped
+    // while the engine is reset
+    pipeline.prepare(sampleRate, samplesPerBlock, getTotalNumInputChannels());
+    engine.prepare(sampleRate, samplesPerBlock, getTotalNumInputChannels());
+    levelMeters.prepare(sampleRate, getTotalNumInputChannels());
+    governor.prepare(sampleRate);
+    metrics.setGovernorLevel(0);
+
+    const int latencyOversampling = getLatencyOversampling();
+    engine.setOversampling(getOversampling(0), latencyOversampling);
+    engine.setExactSaturation(QualityTier::usesExactSaturation(QualityTier::resolve(*qualityParameter, isNonRealtime())));
+    engineLatency = engine.getLatencySamples();
+    pipelineActive = pipelineParameter->get() >= 0.5f && latencyOversampling == 1;
+    setLatencySamples(pipelineActive ? pipeline.getLatencySamples() : engineLatency.load());
+    pipeline.setEnabled(pipelineActive);
+
+    updateParams();
+
+    metrics.prepare(sampleRate, samplesPerBlock, engine.getMemoryBytes() + pipeline.getMemoryBytes());
+}
+
+void Filter64AudioProcessor::releaseResources()
+{
+    pipeline.release();
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+bool Filter64AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+#if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+#endif
+
+    return true;
+}
+#endif
+
+void Filter64AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    metrics.beginBlock();
+
+    auto totalNumInputChannels = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    juce::ignoreUnused(midiMessages);
+
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+    {
+        buffer.clear(i, 0, buffer.getNumSamples());
+    }
+
+    // The oversampled ladders all run on the audio thread, so the pipelined
+    // master is left aside while oversampling. The latency stays that of the
+    // tier when the governor lowers the oversampling, and that of High in
+    // Auto, which pads while playing.
+    const int oversampling = getOversampling();
+    const int latencyOversampling = getLatencyOversampling();
+    const bool pipelined = pipelineParameter->get() >= 0.5f && latencyOversampling == 1;
+    if (pipelined != pipelineActive)
+    {
+        pipeline.reset();
+        pipelineActive = pipelined;
+    }
+
+    // After the pipeline, which may have been using the master ladders
+    engine.setOversampling(oversampling, latencyOversampling);
+    engine.setExactSaturation(QualityTier::usesExactSaturation(QualityTier::resolve(*qualityParameter, isNonRealtime(), governor.getLevel())));
+    engineLatency = engine.getLatencySamples();
+
+    auto* const* channels = buffer.getArrayOfWritePointers();
+
+    presetBank.processSteps(channels, totalNumInputChannels, buffer.getNumSamples(),
+        [this](int step) { updateParams(step); },
+        [this](float* const* stepChannels, int numChannels, int numSamples)
+        {
+            if (pipelineActive)
+            {
+                pipeline.process(stepChannels, numChannels, numSamples, engineParameters.master);
+            }
+            else
+            {
+                engine.process(stepChannels, numChannels, numSamples);
+            }
+        });
+
+    levelMeters.process(buffer.getArrayOfReadPointers(), totalNumInputChannels, buffer.getNumSamples());
+    spectrumTap.push(buffer.getArrayOfReadPointers(), totalNumInputChannels, buffer.getNumSamples());
+
+    const int activeChannels = std::min(totalNumInputChannels, MAX_CHANS);
+    metrics.endBlock(buffer.getNumSamples(), activeChannels, engine.countSleepingChannels(activeChannels));
+
+    if (governor.endBlock(metrics.getLastBlockNanos(), buffer.getNumSamples(), isNonRealtime(), metrics.getProcessLoad()))
+    {
+        metrics.setGovernorLevel(governor.getLevel());
+    }
+}
+
+void Filter64AudioProcessor::timerCallback()
+{
+    pipeline.setEnabled(pipelineActive);
+
+    const int latency = pipelineActive ? pipeline.getLatencySamples() : engineLatency.load();
+
+    if (latency != getLatencySamples())
+    {
+        setLatencySamples(latency);
+    }
+}
+
+bool Filter64AudioProcessor::hasEditor() const
+{
+    return true;
+}
+
+juce::AudioProcessorEditor* Filter64AudioProcessor::createEditor()
+{
+    return new Filter64AudioProcessorEditor(*this);
+}
+
+void Filter64AudioProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    if (stateLoader.getPendingState(destData))
+    {
+        return;
+    }
+
+    auto state = treeState.copyState();
+    std::unique_ptr<juce::XmlElement> xml(state.createXml());
+    presetBank.writeTo(*xml);
+    copyXmlToBinary(*xml, destData);
+}
+
+void Filter64AudioProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    // Decoded in the background, then applied by onRestored
+    stateLoader.load(data, sizeInBytes, isNonRealtime());
+}
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new Filter64AudioProcessor();
+}
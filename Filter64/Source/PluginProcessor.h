@@ -1,114 +1,228 @@
-/******************************************************************************
-This file is part of Plug64.
-Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
-
-Plug64 is free software: you can redistribute it and/or modify it under
-the terms of the GNU General Public License as published by the Free Software
-Foundation, either version 3 of the License, or (at your option) any later
-version.
-
-Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
-WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
-A PARTICULAR PURPOSE. See the GNU General Public License for more details.
-
-You should have received a copy of the GNU General Public License along with
-Plug64. If not, see <https://www.gnu.org/licenses/>.
-******************************************************************************/
-
-#pragma once
-
-#include <juce_audio_basics/juce_audio_basics.h>
-#include <juce_audio_devices/juce_audio_devices.h>
-#include <juce_audio_formats/juce_audio_formats.h>
-#include <juce_audio_plugin_client/juce_audio_plugin_client.h>
-#include <juce_audio_processors/juce_audio_processors.h>
-#include <juce_audio_utils/juce_audio_utils.h>
-#include <juce_core/juce_core.h>
-#include <juce_data_structures/juce_data_structures.h>
-#include <juce_dsp/juce_dsp.h>
-#include <juce_events/juce_events.h>
-#include <juce_graphics/juce_graphics.h>
-#include <juce_gui_basics/juce_gui_basics.h>
-#include <juce_gui_extra/juce_gui_extra.h>
-#include "BinaryData.h"
-
-class Filter64AudioProcessor : public juce::AudioProcessor
-{
-public:
-    Filter64AudioProcessor();
-    ~Filter64AudioProcessor() override;
-
-    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-#ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
-#endif
-
-    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
-    juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram(int index) override;
-    const juce::String getProgramName(int index) override;
-    void changeProgramName(int index, const juce::String& newName) override;
-
-    void getStateInformation(juce::MemoryBlock& destData) override;
-    void setStateInformation(const void* data, int sizeInBytes) override;
-
-    juce::AudioProcessorValueTreeState treeState;
-
-    std::array<std::atomic<float>*, MAX_CHANS> chTypeParameters = {nullptr};
-    std::array<std::atomic<float>*, MAX_CHANS> chCutoffParameters = {nullptr};
-    std::array<std::atomic<float>*, MAX_CHANS> chResonanceParameters = {nullptr};
-    std::array<std::atomic<float>*, MAX_CHANS> chDriveParameters = {nullptr};
-    std::atomic<float>* masterTypeParameter = nullptr;
-    std::atomic<float>* masterCutoffParameter = nullptr;
-    std::atomic<float>* masterResonanceParameter = nullptr;
-    std::atomic<float>* masterDriveParameter = nullptr;
-
-    juce::Value selChannel;
-
-private:
-    std::array<juce::dsp::ProcessorChain<juce::dsp::LadderFilter<float>, juce::dsp::LadderFilter<float>>, MAX_CHANS> processorChains;
-
-    inline void updateParams()
-    {
-        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
-        {
-            processorChains.at(ch).get<0>().setCutoffFrequencyHz(*(chCutoffParameters.at(ch)));
-            processorChains.at(ch).get<0>().setResonance(*(chResonanceParameters.at(ch)) * 0.01f);
-            float chDrive = *(chDriveParameters.at(ch));
-            processorChains.at(ch).get<0>().setDrive(juce::jmap(chDrive, 0.0f, 100.0f, 1.0f, 10.0f));
-            auto chFilterType = static_cast<int>(*(chTypeParameters.at(ch)));
-            processorChains.at(ch).get<0>().setEnabled(chFilterType != 0);
-            if (chFilterType > 0)
-            {
-                processorChains.at(ch).get<0>().setMode(static_cast<juce::dsp::LadderFilterMode>(chFilterType - 1));
-            }
-
-            processorChains.at(ch).get<1>().setCutoffFrequencyHz(*masterCutoffParameter);
-            processorChains.at(ch).get<1>().setResonance(*masterResonanceParameter * 0.01f);
-            float masterDrive = *masterDriveParameter;
-            processorChains.at(ch).get<1>().setDrive(juce::jmap(masterDrive, 0.0f, 100.0f, 1.0f, 10.0f));
-            auto masterFilterType = static_cast<int>(*masterTypeParameter);
-            processorChains.at(ch).get<1>().setEnabled(masterFilterType != 0);
-            if (masterFilterType > 0)
-            {
-                processorChains.at(ch).get<1>().setMode(static_cast<juce::dsp::LadderFilterMode>(masterFilterType - 1));
-            }
-        }
-    }
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Filter64AudioProcessor)
-};
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_plugin_client/juce_audio_plugin_client.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_audio_utils/juce_audio_utils.h>
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_events/juce_events.h>
+#include <juce_graphics/juce_graphics.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_gui_extra/juce_gui_extra.h>
+#include "BinaryData.h"
+#include "FilterEngine.h"
+#include "MasterStagePipeline.h"
+#include "InstanceMetrics.h"
+#include "LevelMeters.h"
+#include "SpectrumAnalyser.h"
+#include "TripleBuffer.h"
+#include "ParameterTable.h"
+#include "PresetBank.h"
+#include "QualityTier.h"
+#include "BulkEdit.h"
+#include "CpuGovernor.h"
+#include "StateLoader.h"
+
+class Filter64AudioProcessor : public juce::AudioProcessor,
+    private juce::Timer
+{
+public:
+    Filter64AudioProcessor();
+    ~Filter64AudioProcessor() override;
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+#endif
+
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram(int index) override;
+    const juce::String getProgramName(int index) override;
+    void changeProgramName(int index, const juce::String& newName) override;
+
+    void getStateInformation(juce::MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+    // Bulk edits of the channel parameters, from channel first to last (0
+    // based, included), each applied in one step
+    void resetChannels(int first = 0, int last = MAX_CHANS - 1);
+    void copyChannel(int source, int first = 0, int last = MAX_CHANS - 1);
+    void randomiseChannels(int first = 0, int last = MAX_CHANS - 1);
+
+    // Stores the current parameter values as a new preset, which becomes the
+    // current program, returning its index; presets are renamed through
+    // changeProgramName()
+    int storePreset(const juce::String& name);
+
+    // Assigns the presets the "Morph" parameter interpolates between, or
+    // stops morphing when either index is not a preset
+    void setMorphScenes(int indexA, int indexB);
+
+    // Levels of the output channels, shown by the editor
+    LevelMeters& getLevelMeters()
+    {
+        return levelMeters;
+    }
+
+    // Stage parameters last applied to the engine, morph included, for the
+    // response shown by the editor; returns whether they changed since the
+    // last call
+    bool readAppliedParameters(FilterEngine::Parameters& applied)
+    {
+        if (!appliedParameters.update())
+        {
+            return false;
+        }
+
+        applied = appliedParameters.getReadBuffer();
+        return true;
+    }
+
+    // 1, 2 or 4, from the oversampling parameter and the quality tier, as
+    // lowered by the CPU governor
+    int getOversampling() const
+    {
+        return getOversampling(governor.getLevel());
+    }
+
+    // The factor whose latency is reported: 4 in Auto, so that the latency
+    // stays the same whether the host renders offline or not
+    int getLatencyOversampling() const
+    {
+        return QualityTier::getOversampling(QualityTier::resolveLatency(*qualityParameter), getRequestedOversampling());
+    }
+
+    // Copies the channel shown by the editor spectrum
+    SpectrumTap& getSpectrumTap()
+    {
+        return spectrumTap;
+    }
+
+    juce::AudioProcessorValueTreeState treeState;
+
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chTypeParameters = {nullptr};
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chCutoffParameters = {nullptr};
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chResonanceParameters = {nullptr};
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chDriveParameters = {nullptr};
+    juce::AudioParameterFloat* masterTypeParameter = nullptr;
+    juce::AudioParameterFloat* masterCutoffParameter = nullptr;
+    juce::AudioParameterFloat* masterResonanceParameter = nullptr;
+    juce::AudioParameterFloat* masterDriveParameter = nullptr;
+    juce::AudioParameterFloat* pipelineParameter = nullptr;
+    juce::AudioParameterFloat* oversamplingParameter = nullptr;
+    juce::AudioParameterFloat* qualityParameter = nullptr;
+
+    juce::Value selChannel;
+
+private:
+    FilterEngine engine;
+    FilterEngine::Parameters engineParameters;
+    MasterStagePipeline<FilterEngine> pipeline{engine};
+    std::atomic<bool> pipelineActive{false};
+    // Latency of the oversampling, reported by the timer
+    std::atomic<int> engineLatency{0};
+    InstanceMetrics metrics{JucePlugin_Name};
+    CpuGovernor governor;
+    LevelMeters levelMeters;
+    SpectrumTap spectrumTap;
+    TripleBuffer<FilterEngine::Parameters> appliedParameters;
+    PresetBank presetBank{treeState};
+    StateLoader stateLoader{treeState, presetBank};
+
+    // Runs the helper thread of the pipeline only in pipelined mode, and
+    // reports its latency or that of the oversampling from the message
+    // thread, since setLatencySamples() is not realtime safe
+    void timerCallback() override;
+
+    std::array<juce::AudioParameterFloat*, 4> getChannelParameters(int ch) const;
+
+    // With the quality tier lowered by stepsDown tiers
+    int getOversampling(int stepsDown) const
+    {
+        return QualityTier::getOversampling(QualityTier::resolve(*qualityParameter, isNonRealtime(), stepsDown), getRequestedOversampling());
+    }
+
+    int getRequestedOversampling() const
+    {
+        return 1 << juce::jlimit(0, 2, juce::roundToInt(oversamplingParameter->get()));
+    }
+
+    // With a step, reads the values of that step of the block being processed
+    inline void updateParams(int step = -1)
+    {
+        const PresetBank::Reader read(presetBank, step);
+
+        engineParameters.master.type = static_cast<int>(read(masterTypeParameter));
+        engineParameters.master.cutoff = read(masterCutoffParameter);
+        engineParameters.master.resonance = read(masterResonanceParameter);
+        engineParameters.master.drive = read(masterDriveParameter);
+
+        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            auto& chParameters = engineParameters.channels.at(ch);
+            chParameters.type = static_cast<int>(read(chTypeParameters.at(ch)));
+            chParameters.cutoff = read(chCutoffParameters.at(ch));
+            chParameters.resonance = read(chResonanceParameters.at(ch));
+            chParameters.drive = read(chDriveParameters.at(ch));
+        }
+
+        appliedParameters.getWriteBuffer() = engineParameters;
+        appliedParameters.publish();
+
+        // In pipelined mode the master parameters are applied by the pipeline,
+        // when the helper thread is not using them
+        if (pipelineActive)
+        {
+            engine.setChannelParameters(engineParameters);
+        }
+        else
+        {
+            engine.setParameters(engineParameters);
+        }
+
+        // The master stage of the pipelined mode always ramps, since it may
+        // be running on the helper thread
+        if (presetBank.takeJump() && !pipelineActive)
+        {
+            engine.jumpToTargets();
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Filter64AudioProcessor)
+};
@@ -0,0 +1,264 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "ResponseView.h"
+
+namespace
+{
+    bool sameStage(const FilterEngine::StageParameters& a, const FilterEngine::StageParameters& b)
+    {
+        return a.type == b.type && juce::exactlyEqual(a.cutoff, b.cutoff)
+            && juce::exactlyEqual(a.resonance, b.resonance) && juce::exactlyEqual(a.drive, b.drive);
+    }
+}
+
+ResponseView::ResponseView(Filter64AudioProcessor& processorToShow, const CustomLookAndFeel& lookAndFeelToUse) :
+    audioProcessor(processorToShow),
+    customLookAndFeel(lookAndFeelToUse),
+    analyser(processorToShow.getSpectrumTap())
+{
+    for (int i = 0; i < numPoints; ++i)
+    {
+        frequencies[(size_t)i] = (float)(minFrequency * std::pow(maxFrequency / minFrequency, (double)i / (double)(numPoints - 1)));
+    }
+
+    // The engine defaults, until the processor publishes its parameters
+    updateResponse();
+
+    setOpaque(true);
+    setInterceptsMouseClicks(false, false);
+    startTimerHz(frameRate);
+}
+
+ResponseView::~ResponseView()
+{
+    stopTimer();
+    analyser.stop();
+}
+
+void ResponseView::paint(juce::Graphics& g)
+{
+    g.fillAll(customLookAndFeel.backgroundColour.brighter(0.05f));
+
+    g.setColour(customLookAndFeel.lineColour.withAlpha(0.15f));
+    for (const double frequency : {100.0, 1000.0, 10000.0})
+    {
+        g.drawVerticalLine(juce::roundToInt(frequencyToX(frequency)), 0.0f, (float)getHeight());
+    }
+    g.drawHorizontalLine(juce::roundToInt(decibelsToY(0.0f, minResponseDecibels, maxResponseDecibels)), 0.0f, (float)getWidth());
+
+    if (spectrumShown)
+    {
+        g.setColour(customLookAndFeel.backgroundColour.brighter(0.4f));
+        g.fillPath(spectrumPath);
+    }
+
+    const float thickness = std::max((float)getWidth() * 0.003f, 1.0f);
+
+    g.setColour(customLookAndFeel.mainMasterSliderColour);
+    g.strokePath(masterPath, juce::PathStrokeType(thickness));
+    g.setColour(customLookAndFeel.mainChSliderColour);
+    g.strokePath(channelPath, juce::PathStrokeType(thickness));
+    g.setColour(customLookAndFeel.textColour);
+    g.strokePath(totalPath, juce::PathStrokeType(thickness * 1.5f));
+}
+
+void ResponseView::resized()
+{
+    updateResponsePaths();
+    updateSpectrumPath();
+}
+
+void ResponseView::setChannel(int ch)
+{
+    channel = juce::jlimit(1, MAX_CHANS, ch);
+
+    if (spectrumShown)
+    {
+        analyser.start(channel - 1);
+    }
+
+    if (updateResponse())
+    {
+        repaint();
+    }
+}
+
+void ResponseView::setSpectrumShown(bool shouldBeShown)
+{
+    spectrumShown = shouldBeShown;
+
+    if (spectrumShown)
+    {
+        analyser.start(channel - 1);
+    }
+    else
+    {
+        analyser.stop();
+        spectrumPath.clear();
+    }
+
+    repaint();
+}
+
+void ResponseView::timerCallback()
+{
+    bool changed = false;
+
+    if (audioProcessor.readAppliedParameters(applied) || !juce::exactlyEqual(getCurrentSampleRate(), shownSampleRate)
+        || audioProcessor.getOversampling() != shownOversampling)
+    {
+        changed = updateResponse();
+    }
+
+    if (spectrumShown && analyser.read(spectrum))
+    {
+        updateSpectrumPath();
+        changed = true;
+    }
+
+    if (changed)
+    {
+        repaint();
+    }
+}
+
+bool ResponseView::updateResponse()
+{
+    const auto& channelStage = applied.channels.at((size_t)channel - 1);
+    const double sampleRate = getCurrentSampleRate();
+    const int oversampling = audioProcessor.getOversampling();
+
+    if (sameStage(channelStage, shownChannelStage) && sameStage(applied.master, shownMasterStage)
+        && juce::exactlyEqual(sampleRate, shownSampleRate) && oversampling == shownOversampling)
+    {
+        return false;
+    }
+
+    shownChannelStage = channelStage;
+    shownMasterStage = applied.master;
+    shownSampleRate = sampleRate;
+    shownOversampling = oversampling;
+
+    // The ladders run at the oversampled rate
+    const LadderResponse channelResponse(shownChannelStage, sampleRate * oversampling);
+    const LadderResponse masterResponse(shownMasterStage, sampleRate * oversampling);
+
+    for (size_t i = 0; i < (size_t)numPoints; ++i)
+    {
+        channelDecibels[i] = channelResponse.getMagnitudeDecibels(frequencies[i]);
+        masterDecibels[i] = masterResponse.getMagnitudeDecibels(frequencies[i]);
+    }
+
+    updateResponsePaths();
+    return true;
+}
+
+void ResponseView::updateResponsePaths()
+{
+    channelPath.clear();
+    masterPath.clear();
+    totalPath.clear();
+
+    // Up to just below Nyquist, where the response ends
+    const double nyquist = shownSampleRate * 0.5;
+
+    for (size_t i = 0; i < (size_t)numPoints && frequencies[i] < nyquist; ++i)
+    {
+        const float x = frequencyToX(frequencies[i]);
+        const float channelY = decibelsToY(channelDecibels[i], minResponseDecibels, maxResponseDecibels);
+        const float masterY = decibelsToY(masterDecibels[i], minResponseDecibels, maxResponseDecibels);
+        const float totalY = decibelsToY(channelDecibels[i] + masterDecibels[i], minResponseDecibels, maxResponseDecibels);
+
+        if (i == 0)
+        {
+            channelPath.startNewSubPath(x, channelY);
+            masterPath.startNewSubPath(x, masterY);
+            totalPath.startNewSubPath(x, totalY);
+        }
+        else
+        {
+            channelPath.lineTo(x, channelY);
+            masterPath.lineTo(x, masterY);
+            totalPath.lineTo(x, totalY);
+        }
+    }
+}
+
+void ResponseView::updateSpectrumPath()
+{
+    spectrumPath.clear();
+
+    if (!spectrumShown)
+    {
+        return;
+    }
+
+    const double binWidth = getCurrentSampleRate() / (double)SpectrumAnalyser::fftSize;
+    const float bottom = (float)getHeight();
+    bool started = false;
+    float lastX = 0.0f;
+
+    for (size_t bin = 1; bin < (size_t)SpectrumAnalyser::numBins; ++bin)
+    {
+        const double frequency = (double)bin * binWidth;
+
+        if (frequency < minFrequency)
+        {
+            continue;
+        }
+
+        if (frequency > maxFrequency)
+        {
+            break;
+        }
+
+        lastX = frequencyToX(frequency);
+        const float y = decibelsToY(spectrum.decibels[bin], minSpectrumDecibels, 0.0f);
+
+        if (!started)
+        {
+            spectrumPath.startNewSubPath(lastX, bottom);
+            started = true;
+        }
+
+        spectrumPath.lineTo(lastX, y);
+    }
+
+    if (started)
+    {
+        spectrumPath.lineTo(lastX, bottom);
+        spectrumPath.closeSubPath();
+    }
+}
+
+double ResponseView::getCurrentSampleRate() const
+{
+    const double sampleRate = audioProcessor.getSampleRate();
+    return sampleRate > 0.0 ? sampleRate : 44100.0;
+}
+
+float ResponseView::frequencyToX(double frequency) const
+{
+    return (float)getWidth() * (float)(std::log(frequency / minFrequency) / std::log(maxFrequency / minFrequency));
+}
+
+float ResponseView::decibelsToY(float decibels, float minDecibels, float maxDecibels) const
+{
+    const float proportion = juce::jlimit(0.0f, 1.0f, (decibels - minDecibels) / (maxDecibels - minDecibels));
+    return (float)getHeight() * (1.0f - proportion);
+}
@@ -0,0 +1,87 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include "PluginProcessor.h"
+#include "CustomLookAndFeel.h"
+#include "LadderResponse.h"
+#include "SpectrumAnalyser.h"
+
+// Response of the master stage, of the stage of the selected channel and of
+// the two in series, computed from the parameters the processor last
+// applied and kept until they change. Under it, an optional live spectrum
+// of the channel output, analysed on a background thread.
+class ResponseView : public juce::Component, private juce::Timer
+{
+public:
+    ResponseView(Filter64AudioProcessor& processorToShow, const CustomLookAndFeel& lookAndFeelToUse);
+    ~ResponseView() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    // Channel from 1, as selected in the editor
+    void setChannel(int ch);
+    void setSpectrumShown(bool shouldBeShown);
+
+private:
+    static constexpr int frameRate = 30;
+    static constexpr int numPoints = 256;
+    static constexpr double minFrequency = 20.0;
+    static constexpr double maxFrequency = 20000.0;
+    // Scales of the response and of the spectrum, from bottom to top
+    static constexpr float minResponseDecibels = -48.0f;
+    static constexpr float maxResponseDecibels = 24.0f;
+    static constexpr float minSpectrumDecibels = -96.0f;
+
+    Filter64AudioProcessor& audioProcessor;
+    const CustomLookAndFeel& customLookAndFeel;
+    SpectrumAnalyser analyser;
+    SpectrumAnalyser::Spectrum spectrum;
+    FilterEngine::Parameters applied;
+
+    // What the curves were computed for
+    FilterEngine::StageParameters shownChannelStage;
+    FilterEngine::StageParameters shownMasterStage;
+    // Negative until the curves are first computed
+    double shownSampleRate = -1.0;
+    int shownOversampling = 1;
+    int channel = 1;
+    bool spectrumShown = false;
+
+    std::array<float, numPoints> frequencies{};
+    std::array<float, numPoints> channelDecibels{};
+    std::array<float, numPoints> masterDecibels{};
+    juce::Path channelPath;
+    juce::Path masterPath;
+    juce::Path totalPath;
+    juce::Path spectrumPath;
+
+    void timerCallback() override;
+    // Recomputes the curves if the stages shown changed, returning whether
+    // they did
+    bool updateResponse();
+    void updateResponsePaths();
+    void updateSpectrumPath();
+    double getCurrentSampleRate() const;
+    float frequencyToX(double frequency) const;
+    float decibelsToY(float decibels, float minDecibels, float maxDecibels) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ResponseView)
+};
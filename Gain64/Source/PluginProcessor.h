@@ -1,80 +1,135 @@
-/******************************************************************************
-This file is part of Plug64.
-Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
-
-Plug64 is free software: you can redistribute it and/or modify it under
-the terms of the GNU General Public License as published by the Free Software
-Foundation, either version 3 of the License, or (at your option) any later
-version.
-
-Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
-WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
-A PARTICULAR PURPOSE. See the GNU General Public License for more details.
-
-You should have received a copy of the GNU General Public License along with
-Plug64. If not, see <https://www.gnu.org/licenses/>.
-******************************************************************************/
-
-#pragma once
-
-#include <juce_audio_basics/juce_audio_basics.h>
-#include <juce_audio_devices/juce_audio_devices.h>
-#include <juce_audio_formats/juce_audio_formats.h>
-#include <juce_audio_plugin_client/juce_audio_plugin_client.h>
-#include <juce_audio_processors/juce_audio_processors.h>
-#include <juce_audio_utils/juce_audio_utils.h>
-#include <juce_core/juce_core.h>
-#include <juce_data_structures/juce_data_structures.h>
-#include <juce_dsp/juce_dsp.h>
-#include <juce_events/juce_events.h>
-#include <juce_graphics/juce_graphics.h>
-#include <juce_gui_basics/juce_gui_basics.h>
-#include <juce_gui_extra/juce_gui_extra.h>
-#include "BinaryData.h"
-
-class Gain64AudioProcessor : public juce::AudioProcessor
-{
-public:
-    Gain64AudioProcessor();
-    ~Gain64AudioProcessor() override;
-
-    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-#ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
-#endif
-
-    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
-    juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram(int index) override;
-    const juce::String getProgramName(int index) override;
-    void changeProgramName(int index, const juce::String& newName) override;
-
-    void getStateInformation(juce::MemoryBlock& destData) override;
-    void setStateInformation(const void* data, int sizeInBytes) override;
-
-    juce::AudioProcessorValueTreeState treeState;
-
-    std::array<std::atomic<float>*, MAX_CHANS> chGainParameters = {nullptr};
-    std::atomic<float>* masterGainParameter = nullptr;
-
-    juce::Value selChannel;
-
-private:
-    std::array<juce::dsp::ProcessorChain<juce::dsp::Gain<float>, juce::dsp::Gain<float>>, MAX_CHANS> processorChains;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Gain64AudioProcessor)
-};
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_plugin_client/juce_audio_plugin_client.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_audio_utils/juce_audio_utils.h>
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_events/juce_events.h>
+#include <juce_graphics/juce_graphics.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_gui_extra/juce_gui_extra.h>
+#include "BinaryData.h"
+#include "GainEngine.h"
+#include "InstanceMetrics.h"
+#include "LevelMeters.h"
+#include "ParameterTable.h"
+#include "PresetBank.h"
+#include "BulkEdit.h"
+#include "StateLoader.h"
+
+class Gain64AudioProcessor : public juce::AudioProcessor
+{
+public:
+    Gain64AudioProcessor();
+    ~Gain64AudioProcessor() override;
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+#endif
+
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram(int index) override;
+    const juce::String getProgramName(int index) override;
+    void changeProgramName(int index, const juce::String& newName) override;
+
+    void getStateInformation(juce::MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+    // Bulk edits of the channel parameters, from channel first to last (0
+    // based, included), each applied in one step
+    void resetChannels(int first = 0, int last = MAX_CHANS - 1);
+    void copyChannel(int source, int first = 0, int last = MAX_CHANS - 1);
+    void randomiseChannels(int first = 0, int last = MAX_CHANS - 1);
+
+    // Stores the current parameter values as a new preset, which becomes the
+    // current program, returning its index; presets are renamed through
+    // changeProgramName()
+    int storePreset(const juce::String& name);
+
+    // Assigns the presets the "Morph" parameter interpolates between, or
+    // stops morphing when either index is not a preset
+    void setMorphScenes(int indexA, int indexB);
+
+    // Levels of the output channels, shown by the editor
+    LevelMeters& getLevelMeters()
+    {
+        return levelMeters;
+    }
+
+    juce::AudioProcessorValueTreeState treeState;
+
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chGainParameters = {nullptr};
+    juce::AudioParameterFloat* masterGainParameter = nullptr;
+
+    juce::Value selChannel;
+
+private:
+    GainEngine engine;
+    GainEngine::Parameters engineParameters;
+    InstanceMetrics metrics{JucePlugin_Name};
+    LevelMeters levelMeters;
+    PresetBank presetBank{treeState};
+    StateLoader stateLoader{treeState, presetBank};
+
+    std::array<juce::AudioParameterFloat*, 1> getChannelParameters(int ch) const;
+
+    // With a step, reads the values of that step of the block being processed
+    inline void updateParams(int step = -1)
+    {
+        const PresetBank::Reader read(presetBank, step);
+
+        engineParameters.master.gain = read(masterGainParameter);
+
+        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            engineParameters.channels.at(ch).gain = read(chGainParameters.at(ch));
+        }
+
+        engine.setParameters(engineParameters);
+
+        if (presetBank.takeJump())
+        {
+            engine.jumpToTargets();
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Gain64AudioProcessor)
+};
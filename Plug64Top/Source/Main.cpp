@@ -0,0 +1,158 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <signal.h>
+#include "CpuDispatch.h"
+#include "InstanceMetrics.h"
+
+// Lists the live Plug64 instances published in the metrics segment, refreshed
+// every interval seconds, or once with --once
+
+static void printUsage()
+{
+    std::printf("Usage: plug64-top [--once] [--interval seconds]\n");
+}
+
+static std::string formatBytes(std::uint64_t bytes)
+{
+    char text[32];
+
+    if (bytes >= 1024 * 1024)
+    {
+        std::snprintf(text, sizeof(text), "%.1fM", (double)bytes / (1024.0 * 1024.0));
+    }
+    else
+    {
+        std::snprintf(text, sizeof(text), "%.1fK", (double)bytes / 1024.0);
+    }
+
+    return text;
+}
+
+static void printInstances(const MetricsSegment& segment)
+{
+    std::printf("%-8s %-10s %7s %6s %12s %9s %9s %6s %9s %-12s %6s %6s %8s %-8s\n",
+                "PID", "PLUGIN", "RATE", "BLOCK", "BLOCKS", "AVG(us)", "MAX(us)", "LOAD%", "OVERRUNS", "GOVERNOR", "ACTIVE", "SLEEP", "MEM", "ISA");
+
+    int instances = 0;
+
+    for (const auto& slot : segment.slots)
+    {
+        if (slot.state.load(std::memory_order_acquire) != MetricsSlot::live)
+        {
+            continue;
+        }
+
+        const auto pid = slot.pid.load();
+
+        // Slots of crashed hosts stay live until they are recycled
+        if (kill((pid_t)pid, 0) != 0 && errno == ESRCH)
+        {
+            continue;
+        }
+
+        char name[MetricsSlot::nameLength + 1] = {};
+        std::memcpy(name, slot.pluginName, MetricsSlot::nameLength);
+
+        const auto relaxed = std::memory_order_relaxed;
+        const auto blocks = slot.blocksProcessed.load(relaxed);
+        const auto sampleRate = slot.sampleRate.load(relaxed);
+        const auto blockSize = slot.blockSize.load(relaxed);
+        const double averageMicros = blocks > 0 ? (double)slot.totalBlockNanos.load(relaxed) / (double)blocks * 0.001 : 0.0;
+        const double maxMicros = (double)slot.maxBlockNanos.load(relaxed) * 0.001;
+        const double budgetMicros = sampleRate > 0 ? (double)blockSize * 1.0e6 / (double)sampleRate : 0.0;
+        const double load = budgetMicros > 0.0 ? averageMicros / budgetMicros * 100.0 : 0.0;
+
+        // Level, then the steps down and the restores so far
+        char governor[32];
+        std::snprintf(governor, sizeof(governor), "%u %llu/%llu", (unsigned)slot.governorLevel.load(relaxed),
+                      (unsigned long long)slot.governorStepDowns.load(relaxed), (unsigned long long)slot.governorRestores.load(relaxed));
+
+        std::printf("%-8d %-10s %7u %6u %12llu %9.1f %9.1f %6.1f %9llu %-12s %6u %6u %8s %-8s\n",
+                    (int)pid, name, (unsigned)sampleRate, (unsigned)blockSize, (unsigned long long)blocks,
+                    averageMicros, maxMicros, load, (unsigned long long)slot.overruns.load(relaxed), governor,
+                    (unsigned)slot.activeChannels.load(relaxed), (unsigned)slot.sleepingChannels.load(relaxed),
+                    formatBytes(slot.memoryBytes.load(relaxed)).c_str(),
+                    CpuDispatch::getName((CpuDispatch::Level)slot.isaLevel.load(relaxed)));
+
+        ++instances;
+    }
+
+    std::printf("\n%d live instance%s\n", instances, instances == 1 ? "" : "s");
+}
+
+int main(int argc, char* argv[])
+{
+    bool once = false;
+    double interval = 1.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--once") == 0)
+        {
+            once = true;
+        }
+        else if (std::strcmp(argv[i], "--interval") == 0 && i + 1 < argc)
+        {
+            interval = std::max(0.1, std::atof(argv[++i]));
+        }
+        else
+        {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    MetricsSegment* segment = MetricsSegment::open(false);
+    if (segment == nullptr)
+    {
+        std::printf("No Plug64 instance has published metrics yet\n");
+        return 1;
+    }
+
+    while (true)
+    {
+        if (!once)
+        {
+            // Clear the screen and move the cursor home
+            std::printf("\033[2J\033[H");
+        }
+
+        printInstances(*segment);
+        std::fflush(stdout);
+
+        if (once)
+        {
+            break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+    }
+
+    MetricsSegment::close(segment);
+
+    return 0;
+}
@@ -0,0 +1,386 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include "DelayEngine.h"
+#include "FilterEngine.h"
+#include "GainEngine.h"
+#include "RingEngine.h"
+
+namespace py = pybind11;
+
+using Buffer = py::array_t<float, py::array::c_style>;
+
+// Stage fields of each engine, addressed with the same names used by the
+// plugin parameter IDs ("mastertime", "chtime12", ...)
+template <typename Engine>
+struct StageFields;
+
+template <>
+struct StageFields<DelayEngine>
+{
+    static void write(DelayEngine::StageParameters& stage, const std::string& name, float value)
+    {
+        if (name == "sync") stage.sync = static_cast<int>(value);
+        else if (name == "time") stage.time = value;
+        else if (name == "feedback") stage.feedback = value;
+        else if (name == "wet") stage.wet = value;
+        else throw py::key_error("unknown Delay64 parameter: " + name);
+    }
+
+    static float read(const DelayEngine::StageParameters& stage, const std::string& name)
+    {
+        if (name == "sync") return static_cast<float>(stage.sync);
+        if (name == "time") return stage.time;
+        if (name == "feedback") return stage.feedback;
+        if (name == "wet") return stage.wet;
+        throw py::key_error("unknown Delay64 parameter: " + name);
+    }
+};
+
+template <>
+struct StageFields<FilterEngine>
+{
+    static void write(FilterEngine::StageParameters& stage, const std::string& name, float value)
+    {
+        if (name == "type") stage.type = static_cast<int>(value);
+        else if (name == "cutoff") stage.cutoff = value;
+        else if (name == "resonance") stage.resonance = value;
+        else if (name == "drive") stage.drive = value;
+        else throw py::key_error("unknown Filter64 parameter: " + name);
+    }
+
+    static float read(const FilterEngine::StageParameters& stage, const std::string& name)
+    {
+        if (name == "type") return static_cast<float>(stage.type);
+        if (name == "cutoff") return stage.cutoff;
+        if (name == "resonance") return stage.resonance;
+        if (name == "drive") return stage.drive;
+        throw py::key_error("unknown Filter64 parameter: " + name);
+    }
+};
+
+template <>
+struct StageFields<GainEngine>
+{
+    static void write(GainEngine::StageParameters& stage, const std::string& name, float value)
+    {
+        if (name == "gain") stage.gain = value;
+        else throw py::key_error("unknown Gain64 parameter: " + name);
+    }
+
+    static float read(const GainEngine::StageParameters& stage, const std::string& name)
+    {
+        if (name == "gain") return stage.gain;
+        throw py::key_error("unknown Gain64 parameter: " + name);
+    }
+};
+
+template <>
+struct StageFields<RingEngine>
+{
+    static void write(RingEngine::StageParameters& stage, const std::string& name, float value)
+    {
+        if (name == "mod") stage.mod = static_cast<int>(value);
+        else if (name == "freq") stage.freq = value;
+        else if (name == "modch") stage.modCh = static_cast<int>(value);
+        else if (name == "wet") stage.wet = value;
+        else throw py::key_error("unknown Ring64 parameter: " + name);
+    }
+
+    static float read(const RingEngine::StageParameters& stage, const std::string& name)
+    {
+        if (name == "mod") return static_cast<float>(stage.mod);
+        if (name == "freq") return stage.freq;
+        if (name == "modch") return static_cast<float>(stage.modCh);
+        if (name == "wet") return stage.wet;
+        throw py::key_error("unknown Ring64 parameter: " + name);
+    }
+};
+
+// Owns one engine and its parameter snapshot. Calls on the same instance are
+// serialised, different instances can process concurrently from several
+// Python threads since the GIL is released while the engine runs.
+template <typename Engine>
+class PyEngine
+{
+public:
+    PyEngine(double sampleRate, int numChannels, int maxBlockSize) :
+        channels(numChannels),
+        blockSize(maxBlockSize),
+        channelPointers((size_t)std::max(numChannels, 0), nullptr)
+    {
+        if (numChannels < 1)
+        {
+            throw py::value_error("channels must be at least 1");
+        }
+
+        if (maxBlockSize < 1)
+        {
+            throw py::value_error("max_block_size must be at least 1");
+        }
+
+        engine.prepare(sampleRate, maxBlockSize, numChannels);
+    }
+
+    void set(const std::string& parameterID, float value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto parameters = engine.getParameters();
+        auto [stage, field] = locate(parameters, parameterID);
+        StageFields<Engine>::write(*stage, field, value);
+        apply(parameters);
+    }
+
+    float get(const std::string& parameterID)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto parameters = engine.getParameters();
+        auto [stage, field] = locate(parameters, parameterID);
+        return StageFields<Engine>::read(*stage, field);
+    }
+
+    void setBpm(float newBpm)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bpm = newBpm;
+        apply(engine.getParameters());
+    }
+
+    // Ring64 only: routes of (channel, source, weight), the source being an
+    // input channel or "osc1" to "osc4", all numbered from 1
+    using PyRoute = std::tuple<int, std::variant<int, std::string>, float>;
+
+    void setModulationMatrix(const std::vector<PyRoute>& pyRoutes, const std::vector<float>& oscillatorFrequencies)
+    {
+        if (oscillatorFrequencies.size() > (size_t)ModulationMatrix::numOscillators)
+        {
+            throw py::value_error("at most 4 oscillator frequencies can be given");
+        }
+
+        ModulationMatrix matrix;
+        std::vector<ModulationMatrix::Route> routes;
+
+        for (const auto& [channel, source, weight] : pyRoutes)
+        {
+            ModulationMatrix::Route route;
+            route.channel = channel - 1;
+            route.weight = weight;
+
+            if (const auto* name = std::get_if<std::string>(&source))
+            {
+                route.oscillator = true;
+                route.source = (name->size() == 4 && name->rfind("osc", 0) == 0) ? (*name)[3] - '1' : -1;
+            }
+            else
+            {
+                route.source = std::get<int>(source) - 1;
+            }
+
+            routes.push_back(route);
+        }
+
+        if (!matrix.setRoutes(routes.data(), (int)routes.size()))
+        {
+            throw py::value_error("routes need a channel from 1 to MAX_CHANS and an input channel or 'osc1' to 'osc4', "
+                                  "up to " + std::to_string(ModulationMatrix::maxRoutes) + " routes");
+        }
+
+        for (size_t i = 0; i < oscillatorFrequencies.size(); ++i)
+        {
+            matrix.setOscillatorFrequency((int)i, oscillatorFrequencies[i]);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        engine.setModulationMatrix(matrix);
+        engine.setMatrixEnabled(!routes.empty());
+    }
+
+    void process(Buffer buffer, std::optional<Buffer> output)
+    {
+        const auto numChannels = checkShape(buffer);
+        const auto numSamples = (int)buffer.shape(1);
+
+        float* target = nullptr;
+        const float* source = nullptr;
+
+        if (output.has_value())
+        {
+            if (output->ndim() != 2 || output->shape(0) != buffer.shape(0) || output->shape(1) != buffer.shape(1))
+            {
+                throw py::value_error("output must have the same (channels, samples) shape as the input");
+            }
+
+            target = output->mutable_data();
+            source = buffer.data();
+        }
+        else
+        {
+            target = buffer.mutable_data();
+        }
+
+        if (source == target)
+        {
+            source = nullptr;
+        }
+
+        py::gil_scoped_release release;
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // The engines process in place, so an input rendered into an output
+        // is copied there first; a block at a time, right before it is
+        // processed, so that it is still in the cache when the engine reads it
+        for (int offset = 0; offset < numSamples; offset += blockSize)
+        {
+            const int chunk = std::min(blockSize, numSamples - offset);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto start = (size_t)ch * (size_t)numSamples + (size_t)offset;
+                channelPointers[(size_t)ch] = target + start;
+
+                if (source != nullptr)
+                {
+                    std::memcpy(target + start, source + start, sizeof(float) * (size_t)chunk);
+                }
+            }
+
+            engine.process(channelPointers.data(), numChannels, chunk);
+        }
+    }
+
+    int getChannels() const
+    {
+        return channels;
+    }
+
+private:
+    Engine engine;
+    std::mutex mutex;
+    int channels;
+    int blockSize;
+    float bpm = 0.0f;
+    std::vector<float*> channelPointers;
+
+    void apply(const typename Engine::Parameters& parameters)
+    {
+        if constexpr (std::is_same_v<Engine, DelayEngine>)
+        {
+            engine.setParameters(parameters, bpm);
+        }
+        else
+        {
+            engine.setParameters(parameters);
+        }
+    }
+
+    int checkShape(const Buffer& buffer) const
+    {
+        if (buffer.ndim() != 2)
+        {
+            throw py::value_error("buffer must be a 2D (channels, samples) array");
+        }
+
+        if (buffer.shape(0) > channels)
+        {
+            throw py::value_error("buffer has more channels than the instance was created with");
+        }
+
+        return (int)buffer.shape(0);
+    }
+
+    static std::pair<typename Engine::StageParameters*, std::string> locate(typename Engine::Parameters& parameters, const std::string& parameterID)
+    {
+        if (parameterID.rfind("master", 0) == 0)
+        {
+            return {&parameters.master, parameterID.substr(6)};
+        }
+
+        if (parameterID.rfind("ch", 0) == 0)
+        {
+            auto digits = parameterID.size();
+            while (digits > 2 && std::isdigit(static_cast<unsigned char>(parameterID[digits - 1])))
+            {
+                --digits;
+            }
+
+            if (digits < parameterID.size())
+            {
+                const int ch = std::stoi(parameterID.substr(digits));
+                if (ch >= 1 && ch <= MAX_CHANS)
+                {
+                    return {&parameters.channels.at((size_t)ch - 1), parameterID.substr(2, digits - 2)};
+                }
+            }
+        }
+
+        throw py::key_error("unknown parameter ID: " + parameterID);
+    }
+};
+
+template <typename Engine>
+static void bindEngine(py::module_& m, const char* name, const char* doc)
+{
+    using Wrapper = PyEngine<Engine>;
+
+    auto cls = py::class_<Wrapper>(m, name, doc)
+        .def(py::init<double, int, int>(), py::arg("sample_rate") = 48000.0, py::arg("channels") = 2, py::arg("max_block_size") = 512)
+        .def_property_readonly("channels", &Wrapper::getChannels)
+        .def("set", &Wrapper::set, py::arg("parameter_id"), py::arg("value"),
+             "Sets a parameter using the plugin parameter ID, e.g. 'mastercutoff' or 'chcutoff3'.")
+        .def("get", &Wrapper::get, py::arg("parameter_id"))
+        .def("process", &Wrapper::process, py::arg("buffer").noconvert(), py::arg("output").noconvert() = py::none(),
+             "Processes a float32 C-contiguous (channels, samples) array in place, or into a preallocated output "
+             "array of the same shape. No copy is made in place, while an output receives a single copy of the input, "
+             "block by block, before it is processed there. The GIL is released while processing.");
+
+    if constexpr (std::is_same_v<Engine, DelayEngine>)
+    {
+        cls.def("set_bpm", &Wrapper::setBpm, py::arg("bpm"), "Sets the tempo used by the sync parameters.");
+    }
+
+    if constexpr (std::is_same_v<Engine, RingEngine>)
+    {
+        cls.def("set_modulation_matrix", &Wrapper::setModulationMatrix, py::arg("routes"), py::arg("oscillator_frequencies") = std::vector<float>(),
+                "Modulates channel stages by weighted sums of inputs and oscillators, given as (channel, source, weight) "
+                "routes where the source is an input channel or 'osc1' to 'osc4'. An empty list switches the matrix off.");
+    }
+}
+
+PYBIND11_MODULE(plug64, m)
+{
+    m.doc() = "Plug64 DSP engines for offline processing of multichannel NumPy buffers";
+    m.attr("MAX_CHANS") = MAX_CHANS;
+
+    bindEngine<DelayEngine>(m, "Delay64", "Per-channel and master delay");
+    bindEngine<FilterEngine>(m, "Filter64", "Per-channel and master ladder filter");
+    bindEngine<GainEngine>(m, "Gain64", "Per-channel and master gain");
+    bindEngine<RingEngine>(m, "Ring64", "Per-channel and master ring modulator");
+}
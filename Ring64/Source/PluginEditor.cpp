@@ -20,24 +20,26 @@ Plug64. If not, see <https://www.gnu.org/licenses/>.
 Ring64AudioProcessorEditor::Ring64AudioProcessorEditor(Ring64AudioProcessor& p)
     : AudioProcessorEditor(&p),
       audioProcessor(p),
-      customTypeface(juce::Typeface::createSystemTypefaceFor(BinaryData::Font_ttf, BinaryData::Font_ttfSize)),
-      customFont(juce::Font(juce::FontOptions().withTypeface(customTypeface)))
+      customTypeface(customLookAndFeel->customTypeface),
+      customFont(juce::Font(juce::FontOptions().withTypeface(customTypeface))),
+      levelMeterStrip(p.getLevelMeters(), customLookAndFeel.getObject())
 {
     setSize(500, 440);
     setResizeLimits(400, 352, 3000, 2640);
     setResizable(true, p.wrapperType != Ring64AudioProcessor::wrapperType_AudioUnitv3);
     getConstrainer()->setFixedAspectRatio(5.0f/4.4f);
 
-    getLookAndFeel().setColour(juce::Label::textColourId, customLookAndFeel.textColour);
+    getLookAndFeel().setColour(juce::Label::textColourId, customLookAndFeel->textColour);
     getLookAndFeel().setDefaultSansSerifTypeface(customTypeface);
 
     header.setText("Plug64", juce::dontSendNotification);
-    header.setColour(juce::Label::textColourId, customLookAndFeel.backgroundColour);
-    header.setColour(juce::Label::backgroundColourId, customLookAndFeel.textColour);
+    header.setColour(juce::Label::textColourId, customLookAndFeel->backgroundColour);
+    header.setColour(juce::Label::backgroundColourId, customLookAndFeel->textColour);
     addAndMakeVisible(header);
 
     title.setText("RING64", juce::dontSendNotification);
     addAndMakeVisible(title);
+    addAndMakeVisible(levelMeterStrip);
 
     resetLabel.setText("RESET CH PARAMS", juce::dontSendNotification);
     addAndMakeVisible(resetLabel);
@@ -48,21 +50,7 @@ Ring64AudioProcessorEditor::Ring64AudioProcessorEditor(Ring64AudioProcessor& p)
     addAndMakeVisible(resetButton);
     resetButton.onClick = [this]
     {
-        for (int ch = 0; ch < MAX_CHANS; ++ch)
-        {
-            std::string ch_str = std::to_string(ch+1);
-            std::array<std::string, 4> paramIDs{"chmod" + ch_str, "chfreq" + ch_str, "chmodch" + ch_str, "chwet" + ch_str};
-
-            for (auto paramID : paramIDs)
-            {
-                if (auto* param = audioProcessor.treeState.getParameter(paramID))
-                {
-                    param->beginChangeGesture();
-                    param->setValueNotifyingHost(param->getDefaultValue());
-                    param->endChangeGesture();
-                }
-            }
-        }
+        audioProcessor.resetChannels();
     };
 
     masterLabel.setText("MASTER", juce::dontSendNotification);
@@ -85,8 +73,8 @@ Ring64AudioProcessorEditor::Ring64AudioProcessorEditor(Ring64AudioProcessor& p)
     masterModLabel.setJustificationType(juce::Justification::left);
     addAndMakeVisible(masterModLabel);
 
-    masterFreqSlider.setLookAndFeel(&customLookAndFeel);
-    masterFreqSlider.setColour(juce::Slider::trackColourId, customLookAndFeel.mainMasterSliderColour);
+    masterFreqSlider.setLookAndFeel(&customLookAndFeel.getObject());
+    masterFreqSlider.setColour(juce::Slider::trackColourId, customLookAndFeel->mainMasterSliderColour);
     masterFreqSlider.setSliderStyle(juce::Slider::LinearBar);
     masterFreqSlider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 0, 0);
     masterFreqSlider.setPopupDisplayEnabled(false, false, this);
@@ -94,8 +82,8 @@ Ring64AudioProcessorEditor::Ring64AudioProcessorEditor(Ring64AudioProcessor& p)
     masterFreqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.treeState, "masterfreq", masterFreqSlider);
     masterFreqSlider.setTextValueSuffix(" Hz");
 
-    masterModChSlider.setLookAndFeel(&customLookAndFeel);
-    masterModChSlider.setColour(juce::Slider::trackColourId, customLookAndFeel.otherMasterSliderColour);
+    masterModChSlider.setLookAndFeel(&customLookAndFeel.getObject());
+    masterModChSlider.setColour(juce::Slider::trackColourId, customLookAndFeel->otherMasterSliderColour);
     masterModChSlider.setSliderStyle(juce::Slider::LinearBar);
     masterModChSlider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 0, 0);
     masterModChSlider.setPopupDisplayEnabled(false, false, this);
@@ -103,8 +91,8 @@ Ring64AudioProcessorEditor::Ring64AudioProcessorEditor(Ring64AudioProcessor& p)
     masterModChAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.treeState, "mastermodch", masterModChSlider);
     //masterModChSlider.setTextValueSuffix(" %");
 
-    masterWetSlider.setLookAndFeel(&customLookAndFeel);
-    masterWetSlider.setColour(juce::Slider::trackColourId, customLookAndFeel.otherMasterSliderColour);
+    masterWetSlider.setLookAndFeel(&customLookAndFeel.getObject());
+    masterWetSlider.setColour(juce::Slider::trackColourId, customLookAndFeel->otherMasterSliderColour);
     masterWetSlider.setSliderStyle(juce::Slider::LinearBar);
     masterWetSlider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 0, 0);
     masterWetSlider.setPopupDisplayEnabled(false, false, this);
@@ -112,7 +100,7 @@ Ring64AudioProcessorEditor::Ring64AudioProcessorEditor(Ring64AudioProcessor& p)
     masterWetAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.treeState, "masterwet", masterWetSlider);
     masterWetSlider.setTextValueSuffix(" %");
 
-    masterModBox.setLookAndFeel(&customLookAndFeel);
+    masterModBox.setLookAndFeel(&customLookAndFeel.getObject());
     masterModBox.setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
     masterModBox.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
     masterModBox.setScrollWheelEnabled(true);
@@ -144,10 +132,12 @@ Ring64AudioProcessorEditor::Ring64AudioProcessorEditor(Ring64AudioProcessor& p)
     chModLabel.setJustificationType(juce::Justification::left);
     addAndMakeVisible(chModLabel);
 
-    selectChBox.setLookAndFeel(&customLookAndFeel);
+    selectChBox.setLookAndFeel(&customLookAndFeel.getObject());
     selectChBox.setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
     selectChBox.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
     selectChBox.setScrollWheelEnabled(true);
+    // Looked up by the editor benchmark
+    selectChBox.setComponentID("selectChannel");
     addAndMakeVisible(selectChBox);
     for (auto ch = 1; ch <= MAX_CHANS; ++ch)
     {
@@ -165,8 +155,8 @@ Ring64AudioProcessorEditor::Ring64AudioProcessorEditor(Ring64AudioProcessor& p)
         std::string ch_str = std::to_string(ch+1);
         std::string paramID;
 
-        chFreqSliders[ch].setLookAndFeel(&customLookAndFeel);
-        chFreqSliders[ch].setColour(juce::Slider::trackColourId, customLookAndFeel.mainChSliderColour);
+        chFreqSliders[ch].setLookAndFeel(&customLookAndFeel.getObject());
+        chFreqSliders[ch].setColour(juce::Slider::trackColourId, customLookAndFeel->mainChSliderColour);
         chFreqSliders[ch].setSliderStyle(juce::Slider::LinearBar);
         chFreqSliders[ch].setTextBoxStyle(juce::Slider::TextBoxLeft, false, 0, 0);
         chFreqSliders[ch].setPopupDisplayEnabled(false, false, this);
@@ -175,8 +165,8 @@ Ring64AudioProcessorEditor::Ring64AudioProcessorEditor(Ring64AudioProcessor& p)
         chFreqAttachments[ch] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.treeState, paramID, chFreqSliders[ch]);
         chFreqSliders[ch].setTextValueSuffix(" Hz");
 
-        chModChSliders[ch].setLookAndFeel(&customLookAndFeel);
-        chModChSliders[ch].setColour(juce::Slider::trackColourId, customLookAndFeel.otherChSliderColour);
+        chModChSliders[ch].setLookAndFeel(&customLookAndFeel.getObject());
+        chModChSliders[ch].setColour(juce::Slider::trackColourId, customLookAndFeel->otherChSliderColour);
         chModChSliders[ch].setSliderStyle(juce::Slider::LinearBar);
         chModChSliders[ch].setTextBoxStyle(juce::Slider::TextBoxLeft, false, 0, 0);
         chModChSliders[ch].setPopupDisplayEnabled(false, false, this);
@@ -185,8 +175,8 @@ Ring64AudioProcessorEditor::Ring64AudioProcessorEditor(Ring64AudioProcessor& p)
         chModChAttachments[ch] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.treeState, paramID, chModChSliders[ch]);
         //chModChSliders[ch].setTextValueSuffix(" %");
 
-        chWetSliders[ch].setLookAndFeel(&customLookAndFeel);
-        chWetSliders[ch].setColour(juce::Slider::trackColourId, customLookAndFeel.otherChSliderColour);
+        chWetSliders[ch].setLookAndFeel(&customLookAndFeel.getObject());
+        chWetSliders[ch].setColour(juce::Slider::trackColourId, customLookAndFeel->otherChSliderColour);
         chWetSliders[ch].setSliderStyle(juce::Slider::LinearBar);
         chWetSliders[ch].setTextBoxStyle(juce::Slider::TextBoxLeft, false, 0, 0);
         chWetSliders[ch].setPopupDisplayEnabled(false, false, this);
@@ -195,7 +185,7 @@ Ring64AudioProcessorEditor::Ring64AudioProcessorEditor(Ring64AudioProcessor& p)
         chWetAttachments[ch] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.treeState, paramID, chWetSliders[ch]);
         chWetSliders[ch].setTextValueSuffix(" %");
 
-        chModBoxes[ch].setLookAndFeel(&customLookAndFeel);
+        chModBoxes[ch].setLookAndFeel(&customLookAndFeel.getObject());
         chModBoxes[ch].setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
         chModBoxes[ch].setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
         chModBoxes[ch].setScrollWheelEnabled(true);
@@ -216,8 +206,8 @@ Ring64AudioProcessorEditor::~Ring64AudioProcessorEditor()
 
 void Ring64AudioProcessorEditor::paint(juce::Graphics& g)
 {
-    g.fillAll(customLookAndFeel.backgroundColour);
-    g.setColour(customLookAndFeel.lineColour);
+    g.fillAll(customLookAndFeel->backgroundColour);
+    g.setColour(customLookAndFeel->lineColour);
     auto width = static_cast<float>(getWidth());
     g.drawLine(width * 0.05f, width * 0.2f, width * 0.95f, width * 0.2f, width * 0.004f);
 }
@@ -236,6 +226,8 @@ void Ring64AudioProcessorEditor::resized()
     title.setBounds(blockUI, blockUI, blockUI * 14, blockUI * 2);
     title.setFont(customFont.withHeight(fontSize * 2.0f));
 
+    levelMeterStrip.setBounds(blockUI, (int)((float)blockUI * 3.4f), blockUI * 14, (int)((float)blockUI * 0.4f));
+
     resetLabel.setJustificationType(juce::Justification::centredLeft);
     resetLabel.setBounds(blockUI * 10, blockUI, blockUI * 14, blockUI * 2);
     resetLabel.setFont(customFont.withHeight(fontSize * 0.75f));
@@ -19,6 +19,7 @@ Plug64. If not, see <https://www.gnu.org/licenses/>.
 
 #include "PluginProcessor.h"
 #include "CustomLookAndFeel.h"
+#include "LevelMeterStrip.h"
 
 class Ring64AudioProcessorEditor : public juce::AudioProcessorEditor
 {
@@ -31,7 +32,8 @@ public:
 
 private:
     Ring64AudioProcessor& audioProcessor;
-    CustomLookAndFeel customLookAndFeel;
+    // Shared by all the editors of the process, along with its typeface
+    juce::SharedResourcePointer<CustomLookAndFeel> customLookAndFeel;
     juce::Label header;
     juce::Label title;
     juce::Label resetLabel;
@@ -68,6 +70,7 @@ private:
 
     juce::Typeface::Ptr customTypeface;
     juce::Font customFont;
+    LevelMeterStrip levelMeterStrip;
     float fontSize;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Ring64AudioProcessorEditor)
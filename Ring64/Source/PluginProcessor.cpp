@@ -17,7 +17,6 @@ Plug64. If not, see <https://www.gnu.org/licenses/>.
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
-#include <string>
 
 Ring64AudioProcessor::Ring64AudioProcessor() :
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -25,6 +24,7 @@ Ring64AudioProcessor::Ring64AudioProcessor() :
 #if ! JucePlugin_IsMidiEffect
 #if ! JucePlugin_IsSynth
                    .withInput("Input", juce::AudioChannelSet::stereo(), true)
+                   .withInput("Sidechain", juce::AudioChannelSet::stereo(), false)
 #endif
                    .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
@@ -35,32 +35,25 @@ Ring64AudioProcessor::Ring64AudioProcessor() :
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>("mastermod", "Master Modulator", juce::NormalisableRange<float>(0.0f, 4.0f, 1.0f), 0.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("masterfreq", "Master Frequency", juce::NormalisableRange<float>(0.0f, 20000.0f, 1.0f), 440.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("mastermodch", "Master Mod Channel", juce::NormalisableRange<float>(1.0f, 64.0f, 1.0f), 1.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("masterwet", "Master Wet", juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 100.0f));
+    ParameterTable::addMaster(layout, ParameterTable::ringSpecs);
+    ParameterTable::addChannels(layout, ParameterTable::ringSpecs);
 
-    for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
-    {
-        std::string ch_str = std::to_string(ch+1);
-        std::string parameterID, parameterName;
+    // Interpolates between the morph scenes of the preset bank, appended so
+    // that the indices of the other parameters do not change
+    layout.add(std::make_unique<juce::AudioParameterFloat>(PresetBank::morphParameterID, "Morph", juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 0.0f));
 
-        parameterID = "chmod" + ch_str;
-        parameterName = "Channel " + ch_str + " Modulator";
-        layout.add(std::make_unique<juce::AudioParameterFloat>(parameterID, parameterName,juce::NormalisableRange<float>(0.0f, 4.0f, 1.0f), 0.0f));
+    // Auto, Eco, Standard or High, appended for the same reason
+    layout.add(QualityTier::createParameter());
 
-        parameterID = "chfreq" + ch_str;
-        parameterName = "Channel " + ch_str + " Frequency";
-        layout.add(std::make_unique<juce::AudioParameterFloat>(parameterID, parameterName, juce::NormalisableRange<float>(0.0f, 20000.0f, 1.0f), 440.0f));
+    // Switches the channel stages with routes to the modulation matrix
+    layout.add(std::make_unique<juce::AudioParameterFloat>("matrix", "Modulation Matrix", juce::NormalisableRange<float>(0.0f, 1.0f, 1.0f), 0.0f));
 
-        parameterID = "chmodch" + ch_str;
-        parameterName = "Channel " + ch_str + " Mod Channel";
-        layout.add(std::make_unique<juce::AudioParameterFloat>(parameterID, parameterName, juce::NormalisableRange<float>(1.0f, 64.0f, 1.0f), (float)ch+1));
+    // Main input or sidechain for the CH INPUT modulator of each stage, also
+    // appended
+    ParameterTable::addStage(layout, ParameterTable::ringSourceSpecs);
 
-        parameterID = "chwet" + ch_str;
-        parameterName = "Channel " + ch_str + " Wet";
-        layout.add(std::make_unique<juce::AudioParameterFloat>(parameterID, parameterName, juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 0.0f));
-    }
+    // Runs the master stage on a helper thread, appended for the same reason
+    layout.add(std::make_unique<juce::AudioParameterFloat>("pipeline", "Pipelined Master", juce::NormalisableRange<float>(0.0f, 1.0f, 1.0f), 0.0f));
 
     return layout;
 }
@@ -72,25 +65,64 @@ Ring64AudioProcessor::Ring64AudioProcessor() :
         treeState.state.setProperty("selchannel", 1, nullptr);
     }
 
-    masterModParameter = treeState.getRawParameterValue("mastermod");
-    masterFreqParameter = treeState.getRawParameterValue("masterfreq");
-    masterModChParameter = treeState.getRawParameterValue("mastermodch");
-    masterMixParameter = treeState.getRawParameterValue("masterwet");
+    // In the order of the layout
+    ParameterTable::Cursor parameters(*this);
+    masterModParameter = parameters.next();
+    masterFreqParameter = parameters.next();
+    masterModChParameter = parameters.next();
+    masterMixParameter = parameters.next();
+
+    for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+    {
+        chModParameters.at(ch) = parameters.next();
+        chFreqParameters.at(ch) = parameters.next();
+        chModChParameters.at(ch) = parameters.next();
+        chMixParameters.at(ch) = parameters.next();
+    }
+
+    // The morph parameter is taken by the preset bank
+    parameters.next();
+    qualityParameter = parameters.next();
+    matrixParameter = parameters.next();
+    masterSourceParameter = parameters.next();
 
     for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
     {
-        std::string ch_str = std::to_string(ch+1);
-        chModParameters.at(ch) = treeState.getRawParameterValue("chmod" + ch_str);
-        chFreqParameters.at(ch) = treeState.getRawParameterValue("chfreq" + ch_str);
-        chModChParameters.at(ch) = treeState.getRawParameterValue("chmodch" + ch_str);
-        chMixParameters.at(ch) = treeState.getRawParameterValue("chwet" + ch_str);
+        chSourceParameters.at(ch) = parameters.next();
     }
 
+    pipelineParameter = parameters.next();
+
+    // Choices switch halfway through a morph
+    presetBank.setDiscrete(masterModParameter);
+    presetBank.setDiscrete(masterModChParameter);
+    presetBank.setDiscrete(masterSourceParameter);
+    for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+    {
+        presetBank.setDiscrete(chModParameters.at(ch));
+        presetBank.setDiscrete(chModChParameters.at(ch));
+        presetBank.setDiscrete(chSourceParameters.at(ch));
+    }
+
+    stateLoader.onRestored = [this]
+    {
+        if (treeState.state.hasProperty("selchannel"))
+        {
+            selChannel.referTo(treeState.state.getPropertyAsValue("selchannel", nullptr));
+        }
+
+        readModulationMatrix();
+    };
+
+    readModulationMatrix();
     updateParams();
+
+    startTimerHz(10);
 }
 
 Ring64AudioProcessor::~Ring64AudioProcessor()
 {
+    stopTimer();
 }
 
 const juce::String Ring64AudioProcessor::getName() const
@@ -132,47 +164,166 @@ double Ring64AudioProcessor::getTailLengthSeconds() const
 
 int Ring64AudioProcessor::getNumPrograms()
 {
-    return 1;
+    // Hosts expect at least one program
+    return std::max(presetBank.getNumPresets(), 1);
 }
 
 int Ring64AudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return std::max(presetBank.getCurrentIndex(), 0);
 }
 
 void Ring64AudioProcessor::setCurrentProgram(int index)
 {
-    juce::ignoreUnused(index);
+    presetBank.select(index);
 }
 
 const juce::String Ring64AudioProcessor::getProgramName(int index)
 {
-    juce::ignoreUnused(index);
-
-    return {};
+    return presetBank.getName(index);
 }
 
 void Ring64AudioProcessor::changeProgramName(int index, const juce::String& newName)
 {
-    juce::ignoreUnused(index, newName);
+    presetBank.setName(index, newName);
+    updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
 }
 
-void Ring64AudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+int Ring64AudioProcessor::storePreset(const juce::String& name)
+{
+    const int index = presetBank.add(name);
+    updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+    return index;
+}
+
+void Ring64AudioProcessor::setMorphScenes(int indexA, int indexB)
+{
+    presetBank.setMorphScenes(indexA, indexB);
+}
+
+void Ring64AudioProcessor::resetChannels(int first, int last)
+{
+    BulkEdit edit(presetBank);
+    edit.resetChannels([this](int ch) { return getChannelParameters(ch); }, first, last);
+    edit.commit();
+}
+
+void Ring64AudioProcessor::copyChannel(int source, int first, int last)
+{
+    BulkEdit edit(presetBank);
+    edit.copyChannel([this](int ch) { return getChannelParameters(ch); }, source, first, last);
+    edit.commit();
+}
+
+void Ring64AudioProcessor::randomiseChannels(int first, int last)
+{
+    BulkEdit edit(presetBank);
+    edit.randomiseChannels([this](int ch) { return getChannelParameters(ch); }, juce::Random::getSystemRandom(), first, last);
+    edit.commit();
+}
+
+std::array<juce::AudioParameterFloat*, 5> Ring64AudioProcessor::getChannelParameters(int ch) const
+{
+    return {chModParameters.at((size_t)ch), chFreqParameters.at((size_t)ch), chModChParameters.at((size_t)ch), chMixParameters.at((size_t)ch), chSourceParameters.at((size_t)ch)};
+}
+
+void Ring64AudioProcessor::setModulationMatrix(const ModulationMatrix& matrix)
+{
+    modulationMatrix = matrix;
+    writeModulationMatrix();
+
+    routing.getWriteBuffer() = modulationMatrix;
+    routing.publish();
+}
+
+void Ring64AudioProcessor::readModulationMatrix()
+{
+    const auto tree = treeState.state.getChildWithName("MODMATRIX");
+    ModulationMatrix matrix;
+    std::vector<ModulationMatrix::Route> routes;
+
+    for (const auto& child : tree)
+    {
+        if (child.hasType("ROUTE"))
+        {
+            ModulationMatrix::Route route;
+            route.channel = (int)child.getProperty("channel", 0) - 1;
+            route.oscillator = child.hasProperty("oscillator");
+            route.source = (int)child.getProperty(route.oscillator ? "oscillator" : "input", 0) - 1;
+            route.weight = (float)child.getProperty("weight", 1.0f);
+            routes.push_back(route);
+        }
+        else if (child.hasType("OSCILLATOR"))
+        {
+            const int index = (int)child.getProperty("index", 0) - 1;
+
+            if (index >= 0 && index < ModulationMatrix::numOscillators)
+            {
+                matrix.setOscillatorFrequency(index, (float)child.getProperty("freq", 440.0f));
+            }
+        }
+    }
+
+    // Invalid routes are dropped, and then dropped from the state too
+    const bool complete = matrix.setRoutes(routes.data(), (int)routes.size());
+    modulationMatrix = matrix;
+
+    if (!complete)
+    {
+        writeModulationMatrix();
+    }
+
+    routing.getWriteBuffer() = modulationMatrix;
+    routing.publish();
+}
+
+void Ring64AudioProcessor::writeModulationMatrix()
 {
-    juce::ignoreUnused(samplesPerBlock);
+    auto tree = treeState.state.getOrCreateChildWithName("MODMATRIX", nullptr);
+    tree.removeAllChildren(nullptr);
+
+    for (int i = 0; i < modulationMatrix.getNumRoutes(); ++i)
+    {
+        const auto route = modulationMatrix.getRoute(i);
+        juce::ValueTree child("ROUTE");
+        child.setProperty("channel", route.channel + 1, nullptr);
+        child.setProperty(route.oscillator ? "oscillator" : "input", route.source + 1, nullptr);
+        child.setProperty("weight", route.weight, nullptr);
+        tree.appendChild(child, nullptr);
+    }
 
-    for (unsigned int ch = 0; ch < (unsigned int)std::min(getTotalNumInputChannels(), MAX_CHANS); ++ch)
+    for (int i = 0; i < ModulationMatrix::numOscillators; ++i)
     {
-        chRings.at(ch).set_sample_rate(static_cast<float>(sampleRate));
-        masterRings.at(ch).set_sample_rate(static_cast<float>(sampleRate));
+        juce::ValueTree child("OSCILLATOR");
+        child.setProperty("index", i + 1, nullptr);
+        child.setProperty("freq", modulationMatrix.getOscillatorFrequency(i), nullptr);
+        tree.appendChild(child, nullptr);
     }
+}
+
+void Ring64AudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    // The pipeline is prepared first, so that its helper thread is stopped
+    // while the engine is reset
+    pipeline.prepare(sampleRate, samplesPerBlock, getMainBusNumInputChannels());
+    engine.prepare(sampleRate, samplesPerBlock, getMainBusNumInputChannels(), getSidechainChannels());
+    levelMeters.prepare(sampleRate, getMainBusNumInputChannels());
+    governor.prepare(sampleRate);
+    metrics.setGovernorLevel(0);
+
+    applyQuality();
+    pipelineActive = pipelineParameter->get() >= 0.5f;
+    setLatencySamples(pipelineActive ? pipeline.getLatencySamples() : 0);
+    pipeline.setEnabled(pipelineActive);
 
     updateParams();
+
+    metrics.prepare(sampleRate, samplesPerBlock, engine.getMemoryBytes() + pipeline.getMemoryBytes());
 }
 
 void Ring64AudioProcessor::releaseResources()
 {
-
+    pipeline.release();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -181,6 +332,10 @@ bool Ring64AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) co
 #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    // The sidechain is optional, with up to MAX_CHANS channels
+    if (layouts.inputBuses.size() > 1 && layouts.getNumChannels(true, 1) > MAX_CHANS)
+        return false;
 #endif
 
     return true;
@@ -190,82 +345,98 @@ bool Ring64AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) co
 void Ring64AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    metrics.beginBlock();
+
+    // The sidechain bus comes after the main one and is only read
+    auto numInputChannels = getMainBusNumInputChannels();
+    auto numOutputChannels = getMainBusNumOutputChannels();
 
     juce::ignoreUnused(midiMessages);
 
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+    for (auto i = numInputChannels; i < numOutputChannels; ++i)
     {
         buffer.clear(i, 0, buffer.getNumSamples());
     }
 
-    updateParams();
+    const bool pipelined = pipelineParameter->get() >= 0.5f;
+    if (pipelined != pipelineActive)
+    {
+        pipeline.reset();
+        pipelineActive = pipelined;
+    }
 
-    juce::AudioBuffer<float> tempBuffer(totalNumOutputChannels, buffer.getNumSamples());
+    applyQuality();
 
-    std::vector<const float*> inputChannelPointers(totalNumInputChannels);
-    for (auto ch = 0; ch < totalNumInputChannels; ++ch)
+    // Routes set on the message thread since the last block
+    if (routing.update())
     {
-        inputChannelPointers[ch] = buffer.getReadPointer(ch);
+        engine.setModulationMatrix(routing.getReadBuffer());
     }
+    engine.setMatrixEnabled(matrixParameter->get() >= 0.5f);
 
-    for (unsigned int ch = 0; ch < static_cast<unsigned int>(totalNumInputChannels); ++ch)
+    auto* const* channels = buffer.getArrayOfWritePointers();
+
+    // The CH INPUT modulators set to the sidechain read it in place while it
+    // is enabled, and the main input otherwise
+    const int sidechainChannels = getSidechainChannels();
+    const float* const* sidechain = nullptr;
+    if (sidechainChannels > 0)
     {
-        auto* channelData = buffer.getReadPointer(static_cast<int>(ch));
-        auto* tempChannelData = tempBuffer.getWritePointer(static_cast<int>(ch));
+        sidechain = buffer.getArrayOfReadPointers() + getChannelIndexInProcessBlockBuffer(true, 1, 0);
+    }
 
-        if (ch < MAX_CHANS)
+    // The engine moves through the sidechain across the steps
+    engine.setSidechain(sidechain, sidechainChannels);
+
+    presetBank.processSteps(channels, numInputChannels, buffer.getNumSamples(),
+        [this](int step) { updateParams(step); },
+        [this](float* const* stepChannels, int numChannels, int numSamples)
         {
-            for (auto i = 0; i < buffer.getNumSamples(); ++i)
+            if (pipelineActive)
             {
-                // Channel ring modulation
-                float chmod = 0.0f;
-                if (static_cast<int>(*(chModParameters.at(ch))) == 4)
-                {
-                    int chModCh = static_cast<int>(*(chModChParameters.at(ch))) - 1;
-                    if (chModCh < totalNumInputChannels)
-                    {
-                        chmod = inputChannelPointers[chModCh][i];
-                    }
-                }
-                const float chRinged = chRings.at(ch).run(channelData[i], chmod);
-                auto chSample = chRinged * (*(chMixParameters.at(ch)) * 0.01f) + channelData[i] * (1.0f - (*(chMixParameters.at(ch)) * 0.01f));
-
-                // Master ring modulation
-                float mastermod = 0.0f;
-                if (static_cast<int>(*masterModParameter) == 4)
-                {
-                    int masterModCh = static_cast<int>(*masterModChParameter) - 1;
-                    if (masterModCh < totalNumInputChannels)
-                    {
-                        mastermod = inputChannelPointers[masterModCh][i];
-                    }
-                }
-                const float masterRinged = masterRings.at(ch).run(chSample, mastermod);
-                tempChannelData[i] = masterRinged * (*masterMixParameter * 0.01f) + chSample * (1.0f - (*masterMixParameter * 0.01f));
+                pipeline.process(stepChannels, numChannels, numSamples, engineParameters.master);
             }
-        }
-        else
-        {
-            for (auto i = 0; i < buffer.getNumSamples(); ++i)
+            else
             {
-                tempChannelData[i] = channelData[i];
+                engine.process(stepChannels, numChannels, numSamples);
             }
-        }
-    }
+        });
 
-    for (unsigned int ch = 0; ch < static_cast<unsigned int>(totalNumOutputChannels); ++ch)
-    {
-        auto* channelData = buffer.getWritePointer(static_cast<int>(ch));
-        const auto* tempChannelData = tempBuffer.getReadPointer(static_cast<int>(ch));
+    levelMeters.process(buffer.getArrayOfReadPointers(), numInputChannels, buffer.getNumSamples());
 
-        for (auto i = 0; i < buffer.getNumSamples(); ++i)
-        {
-            channelData[i] = tempChannelData[i];
-        }
+    const int activeChannels = std::min(numInputChannels, MAX_CHANS);
+    metrics.endBlock(buffer.getNumSamples(), activeChannels, engine.countSleepingChannels(activeChannels));
+
+    if (governor.endBlock(metrics.getLastBlockNanos(), buffer.getNumSamples(), isNonRealtime(), metrics.getProcessLoad()))
+    {
+        metrics.setGovernorLevel(governor.getLevel());
     }
+}
+
+int Ring64AudioProcessor::getSidechainChannels() const
+{
+    const auto* bus = getBus(true, 1);
+    return bus != nullptr && bus->isEnabled() ? std::min(bus->getNumberOfChannels(), MAX_CHANS) : 0;
+}
 
+void Ring64AudioProcessor::applyQuality()
+{
+    const auto tier = QualityTier::resolve(*qualityParameter, isNonRealtime(), governor.getLevel());
+    engine.setRampStride(QualityTier::getRampStride(tier));
+    engine.setHalfRate(QualityTier::runsAtHalfRate(tier));
+    engine.setPreciseOscillators(QualityTier::usesPreciseOscillators(tier));
+}
+
+void Ring64AudioProcessor::timerCallback()
+{
+    pipeline.setEnabled(pipelineActive);
+
+    const int latency = pipelineActive ? pipeline.getLatencySamples() : 0;
+
+    if (latency != getLatencySamples())
+    {
+        setLatencySamples(latency);
+    }
 }
 
 bool Ring64AudioProcessor::hasEditor() const
@@ -280,26 +451,21 @@ juce::AudioProcessorEditor* Ring64AudioProcessor::createEditor()
 
 void Ring64AudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
+    if (stateLoader.getPendingState(destData))
+    {
+        return;
+    }
+
     auto state = treeState.copyState();
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
+    presetBank.writeTo(*xml);
     copyXmlToBinary(*xml, destData);
 }
 
 void Ring64AudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-    if (xmlState.get() != nullptr)
-    {
-        if (xmlState->hasTagName(treeState.state.getType()))
-        {
-            treeState.replaceState(juce::ValueTree::fromXml(*xmlState));
-
-            if (treeState.state.hasProperty("selchannel"))
-            {
-                selChannel.referTo(treeState.state.getPropertyAsValue("selchannel", nullptr));
-            }
-        }
-    }
+    // Decoded in the background, then applied by onRestored
+    stateLoader.load(data, sizeInBytes, isNonRealtime());
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -33,9 +33,21 @@ Plug64. If not, see <https://www.gnu.org/licenses/>.
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "BinaryData.h"
-#include "soutel/include/soutel/ringmod.h"
-
-class Ring64AudioProcessor : public juce::AudioProcessor
+#include "RingEngine.h"
+#include "MasterStagePipeline.h"
+#include "InstanceMetrics.h"
+#include "LevelMeters.h"
+#include "ParameterTable.h"
+#include "PresetBank.h"
+#include "QualityTier.h"
+#include "BulkEdit.h"
+#include "CpuGovernor.h"
+#include "StateLoader.h"
+#include "ModulationMatrix.h"
+#include "TripleBuffer.h"
+
+class Ring64AudioProcessor : public juce::AudioProcessor,
+    private juce::Timer
 {
 public:
     Ring64AudioProcessor();
@@ -69,96 +81,123 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
+    // Bulk edits of the channel parameters, from channel first to last (0
+    // based, included), each applied in one step
+    void resetChannels(int first = 0, int last = MAX_CHANS - 1);
+    void copyChannel(int source, int first = 0, int last = MAX_CHANS - 1);
+    void randomiseChannels(int first = 0, int last = MAX_CHANS - 1);
+
+    // Stores the current parameter values as a new preset, which becomes the
+    // current program, returning its index; presets are renamed through
+    // changeProgramName()
+    int storePreset(const juce::String& name);
+
+    // Assigns the presets the "Morph" parameter interpolates between, or
+    // stops morphing when either index is not a preset
+    void setMorphScenes(int indexA, int indexB);
+
+    // Levels of the output channels, shown by the editor
+    LevelMeters& getLevelMeters()
+    {
+        return levelMeters;
+    }
+
+    // Routes of the channel stages, set from the message thread and stored
+    // with the state; they apply while the matrix parameter is on
+    void setModulationMatrix(const ModulationMatrix& matrix);
+
+    const ModulationMatrix& getModulationMatrix() const
+    {
+        return modulationMatrix;
+    }
+
     juce::AudioProcessorValueTreeState treeState;
 
-    std::array<std::atomic<float>*, MAX_CHANS> chModParameters = {nullptr};
-    std::array<std::atomic<float>*, MAX_CHANS> chFreqParameters = {nullptr};
-    std::array<std::atomic<float>*, MAX_CHANS> chModChParameters = {nullptr};
-    std::array<std::atomic<float>*, MAX_CHANS> chMixParameters = {nullptr};
-    std::atomic<float>* masterModParameter = nullptr;
-    std::atomic<float>* masterFreqParameter = nullptr;
-    std::atomic<float>* masterModChParameter = nullptr;
-    std::atomic<float>* masterMixParameter = nullptr;
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chModParameters = {nullptr};
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chFreqParameters = {nullptr};
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chModChParameters = {nullptr};
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chMixParameters = {nullptr};
+    std::array<juce::AudioParameterFloat*, MAX_CHANS> chSourceParameters = {nullptr};
+    juce::AudioParameterFloat* masterModParameter = nullptr;
+    juce::AudioParameterFloat* masterFreqParameter = nullptr;
+    juce::AudioParameterFloat* masterModChParameter = nullptr;
+    juce::AudioParameterFloat* masterMixParameter = nullptr;
+    juce::AudioParameterFloat* pipelineParameter = nullptr;
+    juce::AudioParameterFloat* qualityParameter = nullptr;
+    juce::AudioParameterFloat* matrixParameter = nullptr;
+    juce::AudioParameterFloat* masterSourceParameter = nullptr;
 
     juce::Value selChannel;
 
 private:
-    std::array<soutel::RingMod<float>, MAX_CHANS> chRings;
-    std::array<soutel::RingMod<float>, MAX_CHANS> masterRings;
-
-    inline void updateParams()
+    RingEngine engine;
+    RingEngine::Parameters engineParameters;
+    MasterStagePipeline<RingEngine> pipeline{engine};
+    std::atomic<bool> pipelineActive{false};
+    InstanceMetrics metrics{JucePlugin_Name};
+    CpuGovernor governor;
+    LevelMeters levelMeters;
+    ModulationMatrix modulationMatrix;
+    TripleBuffer<ModulationMatrix> routing;
+    PresetBank presetBank{treeState};
+    StateLoader stateLoader{treeState, presetBank};
+
+    // Runs the helper thread of the pipeline only in pipelined mode, and
+    // reports its latency from the message thread, since
+    // setLatencySamples() is not realtime safe
+    void timerCallback() override;
+
+    // Sets the engine to the quality tier, as lowered by the governor under
+    // overload
+    void applyQuality();
+
+    std::array<juce::AudioParameterFloat*, 5> getChannelParameters(int ch) const;
+
+    // Channels of the sidechain bus, 0 while it is disabled
+    int getSidechainChannels() const;
+
+    // The matrix is kept in the state as a MODMATRIX child, with channels,
+    // inputs and oscillators numbered from 1
+    void readModulationMatrix();
+    void writeModulationMatrix();
+
+    // With a step, reads the values of that step of the block being processed
+    inline void updateParams(int step = -1)
     {
-        soutel::RModulators masterModulator = soutel::RModulators::oscillator;
-        soutel::BLWaveforms masterWaveform = soutel::BLWaveforms::sine;
-        bool masterAm = false;
+        const PresetBank::Reader read(presetBank, step);
+
+        engineParameters.master.mod = static_cast<int>(read(masterModParameter));
+        engineParameters.master.freq = read(masterFreqParameter);
+        engineParameters.master.modCh = static_cast<int>(read(masterModChParameter));
+        engineParameters.master.wet = read(masterMixParameter);
+        engineParameters.master.sidechain = read(masterSourceParameter) >= 0.5f;
 
-        int masterMod = static_cast<int>(*(masterModParameter));
-        switch (masterMod)
+        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
         {
-            case 0:
-                masterModulator = soutel::RModulators::oscillator;
-                masterWaveform = soutel::BLWaveforms::sine;
-                break;
-            case 1:
-                masterModulator = soutel::RModulators::oscillator;
-                masterWaveform = soutel::BLWaveforms::triangle;
-                break;
-            case 2:
-                masterModulator = soutel::RModulators::oscillator;
-                masterWaveform = soutel::BLWaveforms::sine;
-                masterAm = true;
-                break;
-            case 3:
-                masterModulator = soutel::RModulators::oscillator;
-                masterWaveform = soutel::BLWaveforms::triangle;
-                masterAm = true;
-                break;
-            case 4:
-                masterModulator = soutel::RModulators::input;
-                break;
+            auto& chParameters = engineParameters.channels.at(ch);
+            chParameters.mod = static_cast<int>(read(chModParameters.at(ch)));
+            chParameters.freq = read(chFreqParameters.at(ch));
+            chParameters.modCh = static_cast<int>(read(chModChParameters.at(ch)));
+            chParameters.wet = read(chMixParameters.at(ch));
+            chParameters.sidechain = read(chSourceParameters.at(ch)) >= 0.5f;
         }
 
-        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+        // In pipelined mode the master parameters are applied by the pipeline,
+        // when the helper thread is not using them
+        if (pipelineActive)
+        {
+            engine.setChannelParameters(engineParameters);
+        }
+        else
+        {
+            engine.setParameters(engineParameters);
+        }
+
+        // The master stage of the pipelined mode always ramps, since it may
+        // be running on the helper thread
+        if (presetBank.takeJump() && !pipelineActive)
         {
-            soutel::RModulators chModulator = soutel::RModulators::oscillator;
-            soutel::BLWaveforms chWaveform = soutel::BLWaveforms::sine;
-            bool chAm = false;
-
-            int chMod = static_cast<int>(*(chModParameters.at(ch)));
-            switch (chMod)
-            {
-                case 0:
-                    chModulator = soutel::RModulators::oscillator;
-                    chWaveform = soutel::BLWaveforms::sine;
-                    break;
-                case 1:
-                    chModulator = soutel::RModulators::oscillator;
-                    chWaveform = soutel::BLWaveforms::triangle;
-                    break;
-                case 2:
-                    chModulator = soutel::RModulators::oscillator;
-                    chWaveform = soutel::BLWaveforms::sine;
-                    chAm = true;
-                    break;
-                case 3:
-                    chModulator = soutel::RModulators::oscillator;
-                    chWaveform = soutel::BLWaveforms::triangle;
-                    chAm = true;
-                    break;
-                case 4:
-                    chModulator = soutel::RModulators::input;
-                    break;
-            }
-
-            chRings.at(ch).set_modulator(chModulator);
-            chRings.at(ch).set_modulator_wave(chWaveform);
-            chRings.at(ch).set_am(chAm);
-            chRings.at(ch).set_frequency(*(chFreqParameters.at(ch)));
-
-            masterRings.at(ch).set_modulator(masterModulator);
-            masterRings.at(ch).set_modulator_wave(masterWaveform);
-            masterRings.at(ch).set_am(masterAm);
-            masterRings.at(ch).set_frequency(*masterFreqParameter);
+            engine.jumpToTargets();
         }
     }
 
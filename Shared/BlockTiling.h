@@ -0,0 +1,95 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+// Splits a block into sample tiles processed across groups of channels, so
+// that the tiles of a group, together with the channel state they touch,
+// stay in cache before moving on. Channels must be independent, since each
+// channel sees its samples in order but interleaved with the other channels
+// of the group.
+struct BlockTiling
+{
+    static constexpr int l1Bytes = 32 * 1024;
+    static constexpr int l2Bytes = 256 * 1024;
+
+    // Zero means no tiling: every channel is swept through the whole block
+    int tileSize = 0;
+    int groupSize = 0;
+
+    // bytesPerChannelSample is the memory touched for every sample of a
+    // channel, i.e. the buffer itself plus the state read and written
+    static BlockTiling choose(int numChannels, int numSamples, int bytesPerChannelSample)
+    {
+        // Small working sets already fit, tiling would only add overhead
+        if (numChannels <= 1 || numChannels * numSamples * bytesPerChannelSample <= l2Bytes)
+        {
+            return {};
+        }
+
+        for (int tile : std::array<int, 3>{256, 128, 64})
+        {
+            const int group = l1Bytes / (tile * bytesPerChannelSample);
+
+            if (group >= 4 || tile == 64)
+            {
+                if (tile >= numSamples)
+                {
+                    return {};
+                }
+
+                return {tile, std::clamp(group, 1, numChannels)};
+            }
+        }
+
+        return {};
+    }
+
+    // Calls function(channel, startSample, numSamples) for every tile
+    template <typename Function>
+    void forEachTile(int numChannels, int numSamples, Function&& function) const
+    {
+        if (tileSize == 0)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                function(ch, 0, numSamples);
+            }
+
+            return;
+        }
+
+        for (int firstChannel = 0; firstChannel < numChannels; firstChannel += groupSize)
+        {
+            const int lastChannel = std::min(firstChannel + groupSize, numChannels);
+
+            for (int start = 0; start < numSamples; start += tileSize)
+            {
+                const int length = std::min(tileSize, numSamples - start);
+
+                for (int ch = firstChannel; ch < lastChannel; ++ch)
+                {
+                    function(ch, start, length);
+                }
+            }
+        }
+    }
+};
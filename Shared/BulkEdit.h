@@ -0,0 +1,140 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "PresetBank.h"
+
+// Edits many parameters in one step, for the editor actions acting on all
+// the channels. The changes are made on a snapshot of the parameter values
+// and committed through the preset bank, so the engines get them all at the
+// next block and the host is only notified of the parameters that changed.
+//
+// The channel operations take parametersOf(ch), giving the parameters of a
+// channel (0 based) in the same order for every channel.
+class BulkEdit
+{
+public:
+    explicit BulkEdit(PresetBank& bankToUse) :
+        bank(bankToUse),
+        values(bankToUse.getCurrentValues())
+    {
+    }
+
+    float get(const juce::AudioParameterFloat* parameter) const
+    {
+        const int index = bank.indexOf(parameter);
+        return index >= 0 ? values[(size_t)index] : parameter->get();
+    }
+
+    // Sets a denormalised value
+    void set(const juce::AudioParameterFloat* parameter, float value)
+    {
+        if (const int index = bank.indexOf(parameter); index >= 0)
+        {
+            values[(size_t)index] = bank.getParameter(index)->getNormalisableRange().snapToLegalValue(value);
+        }
+    }
+
+    void reset(const juce::AudioParameterFloat* parameter)
+    {
+        if (const int index = bank.indexOf(parameter); index >= 0)
+        {
+            const auto* rangedParameter = bank.getParameter(index);
+            values[(size_t)index] = rangedParameter->convertFrom0to1(rangedParameter->getDefaultValue());
+        }
+    }
+
+    void randomise(const juce::AudioParameterFloat* parameter, juce::Random& random)
+    {
+        if (const int index = bank.indexOf(parameter); index >= 0)
+        {
+            const auto* rangedParameter = bank.getParameter(index);
+            values[(size_t)index] = rangedParameter->getNormalisableRange().snapToLegalValue(rangedParameter->convertFrom0to1(random.nextFloat()));
+        }
+    }
+
+    template <typename ParametersOf>
+    void resetChannels(ParametersOf&& parametersOf, int first, int last)
+    {
+        forEachChannel(first, last, [&](int ch)
+        {
+            for (const auto* parameter : parametersOf(ch))
+            {
+                reset(parameter);
+            }
+        });
+    }
+
+    // Copies the parameters of the source channel to the channels from
+    // first to last, included
+    template <typename ParametersOf>
+    void copyChannel(ParametersOf&& parametersOf, int source, int first, int last)
+    {
+        if (!juce::isPositiveAndBelow(source, MAX_CHANS))
+        {
+            return;
+        }
+
+        const auto sourceParameters = parametersOf(source);
+
+        forEachChannel(first, last, [&](int ch)
+        {
+            auto parameter = sourceParameters.begin();
+
+            for (const auto* target : parametersOf(ch))
+            {
+                set(target, get(*parameter++));
+            }
+        });
+    }
+
+    template <typename ParametersOf>
+    void randomiseChannels(ParametersOf&& parametersOf, juce::Random& random, int first, int last)
+    {
+        forEachChannel(first, last, [&](int ch)
+        {
+            for (const auto* parameter : parametersOf(ch))
+            {
+                randomise(parameter, random);
+            }
+        });
+    }
+
+    void commit()
+    {
+        bank.apply(values);
+    }
+
+private:
+    PresetBank& bank;
+    std::vector<float> values;
+
+    template <typename Function>
+    static void forEachChannel(int first, int last, Function&& function)
+    {
+        for (int ch = std::max(first, 0); ch <= std::min(last, MAX_CHANS - 1); ++ch)
+        {
+            function(ch);
+        }
+    }
+};
@@ -0,0 +1,142 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PLUG64_CPU_DISPATCH 1
+#define PLUG64_KERNEL_TARGET(isa) __attribute__((target(isa), flatten))
+#else
+#define PLUG64_CPU_DISPATCH 0
+#endif
+
+// Runtime selection of the instruction set the DSP kernels run with, so that
+// a single binary uses AVX2 and AVX-512 where the CPU has them. A kernel is
+// a lambda handed to run(): it is inlined, together with everything it calls
+// that is visible to the compiler, into a copy of run() compiled for the
+// selected level. Code living in precompiled JUCE modules is still called
+// out of line and runs the baseline instructions.
+//
+// Dispatch needs GCC or Clang on x86; elsewhere every level runs the
+// baseline build. The ForceIsaLevel build option caps the selected level, to
+// compare the paths on the same machine.
+struct CpuDispatch
+{
+    enum class Level : std::uint32_t
+    {
+        baseline = 0,
+        avx2 = 1,
+        avx512 = 2
+    };
+
+    static const char* getName(Level level)
+    {
+        switch (level)
+        {
+            case Level::avx2:
+                return "avx2";
+            case Level::avx512:
+                return "avx512";
+            default:
+                return "baseline";
+        }
+    }
+
+    // Highest level supported by this CPU
+    static Level detect()
+    {
+#if PLUG64_CPU_DISPATCH
+        __builtin_cpu_init();
+
+        const bool hasAvx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+
+        if (hasAvx2 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")
+            && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq"))
+        {
+            return Level::avx512;
+        }
+
+        if (hasAvx2)
+        {
+            return Level::avx2;
+        }
+#endif
+
+        return Level::baseline;
+    }
+
+    // Level the engines use, detected once; not realtime safe on the first call,
+    // so the engines query it in prepare()
+    static Level select()
+    {
+        static const Level selected = []
+        {
+            const Level detected = detect();
+
+#if defined(PLUG64_FORCE_ISA_LEVEL)
+            const Level forced = Level::PLUG64_FORCE_ISA_LEVEL;
+            return forced < detected ? forced : detected;
+#else
+            return detected;
+#endif
+        }();
+
+        return selected;
+    }
+
+    // Runs the kernel with the instruction set of the given level, which must
+    // not exceed detect()
+    template <typename Kernel>
+    static void run(Level level, Kernel&& kernel)
+    {
+#if PLUG64_CPU_DISPATCH
+        switch (level)
+        {
+            case Level::avx512:
+                runAvx512(kernel);
+                return;
+            case Level::avx2:
+                runAvx2(kernel);
+                return;
+            default:
+                break;
+        }
+#else
+        (void)level;
+#endif
+
+        kernel();
+    }
+
+private:
+#if PLUG64_CPU_DISPATCH
+    template <typename Kernel>
+    PLUG64_KERNEL_TARGET("avx2,fma") static void runAvx2(Kernel& kernel)
+    {
+        kernel();
+    }
+
+    template <typename Kernel>
+    PLUG64_KERNEL_TARGET("avx512f,avx512vl,avx512bw,avx512dq,avx2,fma") static void runAvx512(Kernel& kernel)
+    {
+        kernel();
+    }
+#endif
+};
@@ -0,0 +1,137 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+// Keeps an instance out of dropouts under sustained overload by lowering its
+// quality, and raises it back once there is headroom again. The load is the
+// processing time of the blocks over their duration at the sample rate, or
+// the load of the audio thread shared with the other instances of the host
+// process when that is higher (see InstanceMetrics::getProcessLoad()), since
+// many instances that each fit their blocks easily can still overload their
+// thread together. It is
+// averaged over windows of about 100 ms: a window above stepDownLoad lowers
+// the level by one step, while the level goes back up one step only after
+// restoreSeconds of windows all below restoreLoad, so that a step that does
+// not fit is not tried again right away.
+//
+// The level is the number of quality tiers the processor drops (see
+// QualityTier::resolve()). Everything is realtime safe and the level can be
+// read from any thread.
+class CpuGovernor
+{
+public:
+    static constexpr int maxLevel = 2;
+    static constexpr double stepDownLoad = 0.8;
+    static constexpr double restoreLoad = 0.4;
+    static constexpr double windowSeconds = 0.1;
+    static constexpr double restoreSeconds = 2.0;
+
+    void prepare(double sampleRate)
+    {
+        currentSampleRate = sampleRate;
+        windowLength = (std::uint64_t)std::max(std::llround(windowSeconds * sampleRate), 1LL);
+        restoreLength = (std::uint64_t)std::llround(restoreSeconds * sampleRate);
+        reset();
+    }
+
+    // Back to full quality
+    void reset()
+    {
+        level.store(0, std::memory_order_relaxed);
+        windowNanos = 0;
+        windowSamples = 0;
+        calmSamples = 0;
+    }
+
+    int getLevel() const
+    {
+        return level.load(std::memory_order_relaxed);
+    }
+
+    // Called after each block with the time it took and the latest load of
+    // the host process; returns true when the level changed. Offline renders
+    // have no deadline to meet, so they run at full quality.
+    bool endBlock(std::uint64_t blockNanos, int numSamples, bool nonRealtime = false, double processLoad = 0.0)
+    {
+        if (nonRealtime)
+        {
+            const bool changed = getLevel() != 0;
+            reset();
+            return changed;
+        }
+
+        if (currentSampleRate <= 0.0 || numSamples <= 0)
+        {
+            return false;
+        }
+
+        windowNanos += blockNanos;
+        windowSamples += (std::uint64_t)numSamples;
+
+        if (windowSamples < windowLength)
+        {
+            return false;
+        }
+
+        const double load = std::max((double)windowNanos * 1.0e-9 * currentSampleRate / (double)windowSamples, processLoad);
+        const auto samples = windowSamples;
+        windowNanos = 0;
+        windowSamples = 0;
+
+        const int current = getLevel();
+
+        if (load > stepDownLoad)
+        {
+            calmSamples = 0;
+
+            if (current < maxLevel)
+            {
+                level.store(current + 1, std::memory_order_relaxed);
+                return true;
+            }
+
+            return false;
+        }
+
+        calmSamples = load < restoreLoad ? calmSamples + samples : 0;
+
+        if (current > 0 && calmSamples >= restoreLength)
+        {
+            calmSamples = 0;
+            level.store(current - 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    std::atomic<int> level{0};
+    double currentSampleRate = 0.0;
+    std::uint64_t windowNanos = 0;
+    std::uint64_t windowSamples = 0;
+    std::uint64_t windowLength = 1;
+    std::uint64_t restoreLength = 0;
+    // Samples since the load was last above restoreLoad
+    std::uint64_t calmSamples = 0;
+};
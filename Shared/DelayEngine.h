@@ -0,0 +1,402 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "BlockTiling.h"
+#include "CpuDispatch.h"
+#include "DelayLine.h"
+#include "Mixing.h"
+#include "SmootherBank.h"
+
+// DSP core of Delay64: a per-channel delay followed by a master delay in
+// series. It does not depend on the plugin wrapper, so it can be driven by
+// the processor as well as by the Python bindings.
+class DelayEngine
+{
+public:
+    struct StageParameters
+    {
+        int sync = 0;
+        float time = 1000.0f;
+        float feedback = 0.0f;
+        float wet = 0.0f;
+    };
+
+    struct Parameters
+    {
+        StageParameters master{0, 1000.0f, 25.0f, 25.0f};
+        std::array<StageParameters, MAX_CHANS> channels;
+    };
+
+    void prepare(double sampleRate, int maxBlockSize, int numChannels)
+    {
+        blockSize = std::max(maxBlockSize, 1);
+        activeChannels = std::clamp(numChannels, 0, MAX_CHANS);
+        isaLevel = CpuDispatch::select();
+
+        for (unsigned int ch = 0; ch < (unsigned int)activeChannels; ++ch)
+        {
+            chDelays.at(ch).prepare(sampleRate, maxTimeMs);
+            masterDelays.at(ch).prepare(sampleRate, maxTimeMs);
+        }
+
+        // Times and wet amounts, the channel rows first then the wet ones
+        channelSmoothers.prepare(2 * MAX_CHANS, blockSize, sampleRate, rampSeconds);
+        masterSmoothers.prepare(2, blockSize, sampleRate, rampSeconds);
+
+        // One scratch buffer per stage, since the pipelined stages run at once
+        channelWetData.assign((size_t)blockSize, 0.0f);
+        masterWetData.assign((size_t)blockSize, 0.0f);
+        chHalfRate.fill({});
+        masterHalfRate.fill({});
+
+        setParameters(parameters, bpm);
+        channelSmoothers.jumpToTargets();
+        masterSmoothers.jumpToTargets();
+    }
+
+    void setParameters(const Parameters& newParameters, float newBpm = 0.0f)
+    {
+        setChannelParameters(newParameters, newBpm);
+        setMasterParameters(newParameters.master);
+    }
+
+    // The channel and master stages can be updated separately, so that one can
+    // be changed while the other is being processed on another thread
+    void setChannelParameters(const Parameters& newParameters, float newBpm = 0.0f)
+    {
+        parameters.channels = newParameters.channels;
+        bpm = newBpm;
+
+        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            channelSmoothers.setTarget((int)ch, stageTime(parameters.channels.at(ch)));
+            channelSmoothers.setTarget(MAX_CHANS + (int)ch, parameters.channels.at(ch).wet * 0.01f);
+            chDelays.at(ch).setFeedback(parameters.channels.at(ch).feedback * 0.01f);
+        }
+    }
+
+    void setMasterParameters(const StageParameters& newMaster)
+    {
+        parameters.master = newMaster;
+
+        masterSmoothers.setTarget(0, stageTime(parameters.master));
+        masterSmoothers.setTarget(1, parameters.master.wet * 0.01f);
+
+        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            masterDelays.at(ch).setFeedback(parameters.master.feedback * 0.01f);
+        }
+    }
+
+    const Parameters& getParameters() const
+    {
+        return parameters;
+    }
+
+    // Ends the parameter ramps, so that the next block starts at the targets
+    void jumpToTargets()
+    {
+        channelSmoothers.jumpToTargets();
+        masterSmoothers.jumpToTargets();
+    }
+
+    // Samples between the updates of a ramping delay time: larger strides step
+    // the time, which is cheaper, instead of setting it on every sample
+    void setRampStride(int samples)
+    {
+        rampStride.store(std::max(samples, 1), std::memory_order_relaxed);
+    }
+
+    int getRampStride() const
+    {
+        return rampStride.load(std::memory_order_relaxed);
+    }
+
+    // Runs the delay lines once every two samples, on the average of the
+    // pair, and interpolates their output, which halves their cost but
+    // limits the delayed signal to a quarter of the sample rate. The lines
+    // keep their contents across a switch, so the echoes in flight then play
+    // once at the other rate.
+    void setHalfRate(bool enabled)
+    {
+        halfRate.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool isHalfRate() const
+    {
+        return halfRate.load(std::memory_order_relaxed);
+    }
+
+    // Reads the delay lines with cubic instead of linear interpolation, which
+    // keeps the highs of the echoes when the time falls between two samples
+    // or glides, at about twice the cost of a read
+    void setCubicInterpolation(bool enabled)
+    {
+        cubicInterpolation.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool isCubicInterpolation() const
+    {
+        return cubicInterpolation.load(std::memory_order_relaxed);
+    }
+
+    // A channel sleeps when its own stage is neutral (a zero wet amount);
+    // reported by the instance metrics
+    bool isChannelSleeping(unsigned int ch) const
+    {
+        return parameters.channels.at(ch).wet <= 0.0f;
+    }
+
+    int countSleepingChannels(int numChannels) const
+    {
+        int sleeping = 0;
+
+        for (unsigned int ch = 0; ch < (unsigned int)std::clamp(numChannels, 0, MAX_CHANS); ++ch)
+        {
+            sleeping += isChannelSleeping(ch) ? 1 : 0;
+        }
+
+        return sleeping;
+    }
+
+    // Instruction set of the kernels, selected in prepare(); the per-channel
+    // functions are the kernels and are meant to be called from a
+    // CpuDispatch::run() block, as process() does
+    CpuDispatch::Level getIsaLevel() const
+    {
+        return isaLevel;
+    }
+
+    std::size_t getMemoryBytes() const
+    {
+        std::size_t bytes = sizeof(*this) + channelSmoothers.getMemoryBytes() + masterSmoothers.getMemoryBytes()
+            + (channelWetData.capacity() + masterWetData.capacity()) * sizeof(float);
+
+        // Two delay lines per channel
+        for (unsigned int ch = 0; ch < (unsigned int)activeChannels; ++ch)
+        {
+            bytes += chDelays.at(ch).getMemoryBytes() + masterDelays.at(ch).getMemoryBytes() - 2 * sizeof(DelayLine);
+        }
+
+        return bytes;
+    }
+
+    // Processes numChannels buffers in place; channels above MAX_CHANS are left untouched.
+    // Large blocks are processed in cache-sized tiles across groups of channels.
+    void process(float* const* channels, int numChannels, int numSamples)
+    {
+        numChannels = std::min(numChannels, activeChannels);
+
+        CpuDispatch::run(isaLevel, [&]
+        {
+            for (int offset = 0; offset < numSamples; offset += blockSize)
+            {
+                const int chunk = std::min(blockSize, numSamples - offset);
+                advanceSmoothers(chunk);
+
+                const auto tiling = BlockTiling::choose(numChannels, chunk, bytesPerChannelSample);
+                tiling.forEachTile(numChannels, chunk, [&](int ch, int startSample, int length)
+                {
+                    processChannel((unsigned int)ch, channels[ch] + offset + startSample, length, startSample);
+                });
+            }
+        });
+    }
+
+    // Renders the parameter ramps of the next numSamples, at most the prepared
+    // block size, for the processChannel() calls that follow
+    void advanceSmoothers(int numSamples)
+    {
+        channelSmoothers.render(2 * MAX_CHANS, numSamples);
+        masterSmoothers.render(2, numSamples);
+    }
+
+    // Processes samples of the block given to the last advanceSmoothers() call,
+    // starting rampOffset samples into it
+    void processChannel(unsigned int ch, float* channelData, int numSamples, int rampOffset = 0)
+    {
+        processStage(chDelays.at(ch), chHalfRate.at(ch), channelSmoothers, (int)ch, MAX_CHANS + (int)ch, channelWetData.data(), channelData, numSamples, rampOffset);
+        processStage(masterDelays.at(ch), masterHalfRate.at(ch), masterSmoothers, 0, 1, masterWetData.data(), channelData, numSamples, rampOffset);
+    }
+
+    void processChannelStage(unsigned int ch, float* channelData, int numSamples)
+    {
+        processStage(chDelays.at(ch), chHalfRate.at(ch), channelSmoothers, (int)ch, MAX_CHANS + (int)ch, channelWetData.data(), channelData, numSamples, 0);
+    }
+
+    void processMasterStage(unsigned int ch, float* channelData, int numSamples)
+    {
+        processStage(masterDelays.at(ch), masterHalfRate.at(ch), masterSmoothers, 0, 1, masterWetData.data(), channelData, numSamples, 0);
+    }
+
+    // Hooks for MasterStagePipeline: each stage renders its own ramps
+    void beginChannelStage(const float* const*, int, int numSamples)
+    {
+        channelSmoothers.render(2 * MAX_CHANS, numSamples);
+    }
+
+    void beginMasterStage(int numSamples)
+    {
+        masterSmoothers.render(2, numSamples);
+    }
+
+private:
+    // Buffer plus the write and read positions of the two delay lines
+    static constexpr int bytesPerChannelSample = 20;
+    static constexpr double rampSeconds = 0.05;
+    static constexpr float maxTimeMs = 5000.0f;
+
+    // A delay line at half rate: the first sample of the pending pair, and
+    // the last two outputs, interpolated between
+    struct HalfRateLine
+    {
+        float input = 0.0f;
+        float previous = 0.0f;
+        float current = 0.0f;
+        bool odd = false;
+        bool active = false;
+    };
+
+    std::array<DelayLine, MAX_CHANS> chDelays;
+    std::array<DelayLine, MAX_CHANS> masterDelays;
+    std::array<HalfRateLine, MAX_CHANS> chHalfRate;
+    std::array<HalfRateLine, MAX_CHANS> masterHalfRate;
+    SmootherBank channelSmoothers;
+    SmootherBank masterSmoothers;
+    std::vector<float> channelWetData;
+    std::vector<float> masterWetData;
+    Parameters parameters;
+    float bpm = 0.0f;
+    CpuDispatch::Level isaLevel = CpuDispatch::Level::baseline;
+    int blockSize = 1;
+    int activeChannels = 0;
+    // Also read by the master stage, which may run on the pipeline thread
+    std::atomic<int> rampStride{1};
+    std::atomic<bool> halfRate{false};
+    std::atomic<bool> cubicInterpolation{false};
+
+    inline float stageTime(const StageParameters& stage) const
+    {
+        if (stage.sync == 0 || bpm < 1.0f)
+        {
+            return stage.time;
+        }
+
+        return (60000.0f / (bpm * 4.0f)) * static_cast<float>(stage.sync);
+    }
+
+    // The delayed signal goes through wetData, then is mixed in by block.
+    // While the time ramps, it is set every rampStride samples; once settled,
+    // once per block
+    void processStage(DelayLine& delay, HalfRateLine& line, const SmootherBank& smoothers, int timeRow, int wetRow,
+                      float* wetData, float* channelData, int numSamples, int rampOffset) const
+    {
+        const int stride = getRampStride();
+        const bool half = isHalfRate();
+
+        // At half rate the line advances once per two samples
+        const float timeScale = half ? 0.5f : 1.0f;
+        delay.setInterpolation(isCubicInterpolation() ? DelayLine::Interpolation::cubic : DelayLine::Interpolation::linear);
+
+        if (const float* times = smoothers.getRamp(timeRow))
+        {
+            for (auto start = 0; start < numSamples; start += stride)
+            {
+                delay.setTime(times[rampOffset + start] * timeScale);
+                runLine(delay, line, half, channelData + start, wetData + start, std::min(stride, numSamples - start));
+            }
+        }
+        else
+        {
+            delay.setTime(smoothers.getCurrentValue(timeRow) * timeScale);
+            runLine(delay, line, half, channelData, wetData, numSamples);
+        }
+
+        if (const float* wets = smoothers.getRamp(wetRow))
+        {
+            Mixing::crossfade(channelData, wetData, wets + rampOffset, numSamples);
+        }
+        else
+        {
+            Mixing::crossfade(channelData, wetData, smoothers.getCurrentValue(wetRow), numSamples);
+        }
+    }
+
+    // Runs the line over numSamples, at the host rate or at half of it
+    static void runLine(DelayLine& delay, HalfRateLine& line, bool half, const float* input, float* output, int numSamples)
+    {
+        if (!half)
+        {
+            for (auto i = 0; i < numSamples; ++i)
+            {
+                output[i] = delay.run(input[i]);
+            }
+
+            // Kept so that a switch to half rate starts from the last output
+            line.current = numSamples > 0 ? output[numSamples - 1] : line.current;
+            line.active = false;
+            return;
+        }
+
+        if (!line.active)
+        {
+            line.previous = line.current;
+            line.odd = false;
+            line.active = true;
+        }
+
+        auto firstOfPair = [&](int i)
+        {
+            output[i] = 0.5f * (line.previous + line.current);
+            line.input = input[i];
+        };
+
+        auto secondOfPair = [&](int i)
+        {
+            line.previous = line.current;
+            line.current = delay.run(0.5f * (line.input + input[i]));
+            output[i] = line.previous;
+        };
+
+        auto i = 0;
+
+        if (line.odd && numSamples > 0)
+        {
+            secondOfPair(i++);
+        }
+
+        for (; i + 1 < numSamples; i += 2)
+        {
+            firstOfPair(i);
+            secondOfPair(i + 1);
+        }
+
+        line.odd = i < numSamples;
+
+        if (line.odd)
+        {
+            firstOfPair(i);
+        }
+    }
+};
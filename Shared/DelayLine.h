@@ -0,0 +1,136 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// A delay line with feedback, the delayed signal being written back with
+// the input. It is read between two samples by linear interpolation, or
+// between four by cubic Lagrange interpolation, which keeps the highs of a
+// fractional or gliding time; both read the same buffer, so the interpolation
+// can be switched while the line is playing. Times are in ms, at least one
+// sample, and two for the cubic read, below which it falls back to linear.
+class DelayLine
+{
+public:
+    enum class Interpolation
+    {
+        linear,
+        cubic
+    };
+
+    // Allocates and clears the buffer; not realtime safe
+    void prepare(double sampleRate, float maxTimeMs)
+    {
+        samplesPerMs = (float)(sampleRate * 0.001);
+        buffer.assign((size_t)std::ceil(maxTimeMs * samplesPerMs) + guardSamples, 0.0f);
+        position = 0;
+        setTime(timeMs);
+    }
+
+    void clear()
+    {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        position = 0;
+    }
+
+    void setTime(float ms)
+    {
+        timeMs = ms;
+        const float maxDelay = (float)std::max((int)buffer.size() - guardSamples, 1);
+        const float delay = std::clamp(ms * samplesPerMs, 1.0f, maxDelay);
+        whole = (int)delay;
+        fraction = delay - (float)whole;
+    }
+
+    void setFeedback(float amount)
+    {
+        feedback = amount;
+    }
+
+    void setInterpolation(Interpolation newInterpolation)
+    {
+        interpolation = newInterpolation;
+    }
+
+    Interpolation getInterpolation() const
+    {
+        return interpolation;
+    }
+
+    std::size_t getMemoryBytes() const
+    {
+        return sizeof(*this) + buffer.capacity() * sizeof(float);
+    }
+
+    // One sample through the line
+    float run(float input)
+    {
+        const float output = interpolation == Interpolation::cubic && whole >= 2 ? readCubic() : readLinear();
+        buffer[(size_t)position] = input + feedback * output;
+        position = position + 1 == (int)buffer.size() ? 0 : position + 1;
+        return output;
+    }
+
+private:
+    // Past the longest time, for the samples the cubic read looks ahead
+    static constexpr int guardSamples = 4;
+
+    std::vector<float> buffer;
+    float samplesPerMs = 0.0f;
+    float timeMs = 0.0f;
+    float feedback = 0.0f;
+    float fraction = 0.0f;
+    int whole = 1;
+    int position = 0;
+    Interpolation interpolation = Interpolation::linear;
+
+    // The sample written `delay` samples ago
+    inline float past(int delay) const
+    {
+        const int index = position - delay;
+        return buffer[(size_t)(index < 0 ? index + (int)buffer.size() : index)];
+    }
+
+    inline float readLinear() const
+    {
+        const float newer = past(whole);
+        return newer + fraction * (past(whole + 1) - newer);
+    }
+
+    // Lagrange polynomial through the two samples around the time and their
+    // neighbours
+    inline float readCubic() const
+    {
+        const float ym1 = past(whole - 1);
+        const float y0 = past(whole);
+        const float y1 = past(whole + 1);
+        const float y2 = past(whole + 2);
+        const float f = fraction;
+
+        const float cm1 = -f * (f - 1.0f) * (f - 2.0f) * (1.0f / 6.0f);
+        const float c0 = (f + 1.0f) * (f - 1.0f) * (f - 2.0f) * 0.5f;
+        const float c1 = -(f + 1.0f) * f * (f - 2.0f) * 0.5f;
+        const float c2 = (f + 1.0f) * f * (f - 1.0f) * (1.0f / 6.0f);
+
+        return cm1 * ym1 + c0 * y0 + c1 * y1 + c2 * y2;
+    }
+};
@@ -0,0 +1,467 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "CpuDispatch.h"
+#include "HalfBandOversampler.h"
+#include "LadderBank.h"
+#include "SmootherBank.h"
+
+// DSP core of Filter64: a per-channel ladder filter followed by a master
+// ladder filter in series, optionally run at 2 or 4 times the sample rate to
+// keep the drive and the self-oscillation from aliasing.
+class FilterEngine
+{
+public:
+    struct StageParameters
+    {
+        int type = 0;
+        float cutoff = 20000.0f;
+        float resonance = 5.0f;
+        float drive = 0.0f;
+    };
+
+    struct Parameters
+    {
+        StageParameters master;
+        std::array<StageParameters, MAX_CHANS> channels;
+    };
+
+    void prepare(double sampleRate, int maxBlockSize, int numChannels)
+    {
+        currentSampleRate = sampleRate;
+        blockSize = std::max(maxBlockSize, 1);
+        activeChannels = std::clamp(numChannels, 0, MAX_CHANS);
+        isaLevel = CpuDispatch::select();
+
+        // Allocated for the highest factor, so that it can be changed while
+        // playing, and only for the groups of the active channels
+        for (int group = 0; group * lanes < activeChannels; ++group)
+        {
+            oversamplers.at((size_t)group).prepare(blockSize);
+            oversamplers.at((size_t)group).setFactor(oversampling);
+        }
+        groupFrames.assign((size_t)(blockSize * lanes), 0.0f);
+        paddingData.assign((size_t)activeChannels * maxPadding, 0.0f);
+        paddingPosition = 0;
+
+        prepareFilters();
+
+        // The ladder smooths its cutoff and resonance itself, but not its drive
+        channelSmoothers.prepare(MAX_CHANS, blockSize, sampleRate, rampSeconds);
+        masterSmoothers.prepare(1, blockSize, sampleRate, rampSeconds);
+
+        setParameters(parameters);
+        channelSmoothers.jumpToTargets();
+        masterSmoothers.jumpToTargets();
+    }
+
+    void setParameters(const Parameters& newParameters)
+    {
+        setChannelParameters(newParameters);
+        setMasterParameters(newParameters.master);
+    }
+
+    // The channel and master stages can be updated separately, so that one can
+    // be changed while the other is being processed on another thread
+    void setChannelParameters(const Parameters& newParameters)
+    {
+        parameters.channels = newParameters.channels;
+
+        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            setStage(channelLadders, (int)ch, parameters.channels.at(ch));
+            channelSmoothers.setTarget((int)ch, stageDrive(parameters.channels.at(ch)));
+        }
+    }
+
+    void setMasterParameters(const StageParameters& newMaster)
+    {
+        parameters.master = newMaster;
+
+        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            setStage(masterLadders, (int)ch, parameters.master);
+        }
+
+        masterSmoothers.setTarget(0, stageDrive(parameters.master));
+    }
+
+    const Parameters& getParameters() const
+    {
+        return parameters;
+    }
+
+    // 1, 2 or 4; the filters are cleared when it changes. Realtime safe once
+    // prepared, the ladders only being given the new sample rate.
+    // With a higher latencyFactor the output is delayed to the latency of
+    // that factor, so that the oversampling can be lowered under overload
+    // without the latency reported to the host changing.
+    void setOversampling(int factor, int latencyFactor = 1)
+    {
+        factor = factor >= 4 ? 4 : (factor >= 2 ? 2 : 1);
+        const int newPadding = std::max(HalfBandOversampler::getLatencySamples(latencyFactor) - HalfBandOversampler::getLatencySamples(factor), 0);
+
+        if (newPadding != padding)
+        {
+            padding = newPadding;
+            paddingPosition = 0;
+            std::fill(paddingData.begin(), paddingData.end(), 0.0f);
+        }
+
+        if (factor == oversampling)
+        {
+            return;
+        }
+
+        oversampling = factor;
+
+        for (auto& oversampler : oversamplers)
+        {
+            oversampler.setFactor(oversampling);
+        }
+
+        prepareFilters();
+    }
+
+    int getOversampling() const
+    {
+        return oversampling;
+    }
+
+    // Computes the saturation of the ladders exactly instead of from a table
+    // (see LadderBank::setExactSaturation())
+    void setExactSaturation(bool enabled)
+    {
+        exactSaturation.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool isExactSaturation() const
+    {
+        return exactSaturation.load(std::memory_order_relaxed);
+    }
+
+    // Delay of the resamplers and of the padding, to be reported to the host
+    int getLatencySamples() const
+    {
+        return oversamplers.front().getLatencySamples() + padding;
+    }
+
+    // Ends the parameter ramps, so that the next block starts at the targets
+    void jumpToTargets()
+    {
+        channelSmoothers.jumpToTargets();
+        masterSmoothers.jumpToTargets();
+    }
+
+    // A channel sleeps when its own stage is neutral (the filter off);
+    // reported by the instance metrics
+    bool isChannelSleeping(unsigned int ch) const
+    {
+        return parameters.channels.at(ch).type == 0;
+    }
+
+    int countSleepingChannels(int numChannels) const
+    {
+        int sleeping = 0;
+
+        for (unsigned int ch = 0; ch < (unsigned int)std::clamp(numChannels, 0, MAX_CHANS); ++ch)
+        {
+            sleeping += isChannelSleeping(ch) ? 1 : 0;
+        }
+
+        return sleeping;
+    }
+
+    // Instruction set of the kernels, selected in prepare(); the per-channel
+    // functions are the kernels and are meant to be called from a
+    // CpuDispatch::run() block, as process() does
+    CpuDispatch::Level getIsaLevel() const
+    {
+        return isaLevel;
+    }
+
+    std::size_t getMemoryBytes() const
+    {
+        std::size_t bytes = sizeof(*this) + channelSmoothers.getMemoryBytes() + masterSmoothers.getMemoryBytes()
+            + (groupFrames.capacity() + paddingData.capacity()) * sizeof(float);
+
+        for (const auto& oversampler : oversamplers)
+        {
+            bytes += oversampler.getMemoryBytes() - sizeof(oversampler);
+        }
+
+        return bytes;
+    }
+
+    // Processes numChannels buffers in place; channels above MAX_CHANS are left untouched.
+    // The channels are processed in groups, their ladders running side by
+    // side on interleaved frames, which the resamplers produce when
+    // oversampling.
+    void process(float* const* channels, int numChannels, int numSamples)
+    {
+        numChannels = std::min(numChannels, activeChannels);
+
+        CpuDispatch::run(isaLevel, [&]
+        {
+            for (int offset = 0; offset < numSamples; offset += blockSize)
+            {
+                const int chunk = std::min(blockSize, numSamples - offset);
+                advanceSmoothers(chunk);
+
+                for (int first = 0; first < numChannels; first += lanes)
+                {
+                    const int group = first / lanes;
+                    const int numLanes = std::min(lanes, numChannels - first);
+
+                    if (oversampling > 1)
+                    {
+                        processOversampledGroup(channels + first, numLanes, group, offset, chunk);
+                    }
+                    else
+                    {
+                        processGroup(channels + first, numLanes, group, offset, chunk);
+                    }
+                }
+
+                if (padding > 0)
+                {
+                    padLatency(channels, numChannels, offset, chunk);
+                }
+            }
+        });
+    }
+
+    // Renders the parameter ramps of the next numSamples, at most the prepared
+    // block size, for the processChannel() calls that follow
+    void advanceSmoothers(int numSamples)
+    {
+        channelSmoothers.render(MAX_CHANS, numSamples);
+        masterSmoothers.render(1, numSamples);
+    }
+
+    // Processes samples of the block given to the last advanceSmoothers() call,
+    // starting rampOffset samples into it
+    void processChannel(unsigned int ch, float* channelData, int numSamples, int rampOffset = 0)
+    {
+        processStage(channelLadders, (int)ch, channelSmoothers.getRamp((int)ch), channelData, numSamples, rampOffset);
+        processStage(masterLadders, (int)ch, masterSmoothers.getRamp(0), channelData, numSamples, rampOffset);
+    }
+
+    void processChannelStage(unsigned int ch, float* channelData, int numSamples)
+    {
+        processStage(channelLadders, (int)ch, channelSmoothers.getRamp((int)ch), channelData, numSamples, 0);
+    }
+
+    void processMasterStage(unsigned int ch, float* channelData, int numSamples)
+    {
+        processStage(masterLadders, (int)ch, masterSmoothers.getRamp(0), channelData, numSamples, 0);
+    }
+
+    // Hooks for MasterStagePipeline: each stage renders its own ramps
+    void beginChannelStage(const float* const*, int, int numSamples)
+    {
+        channelSmoothers.render(MAX_CHANS, numSamples);
+    }
+
+    void beginMasterStage(int numSamples)
+    {
+        masterSmoothers.render(1, numSamples);
+    }
+
+private:
+    static constexpr int lanes = HalfBandOversampler::lanes;
+    static_assert(LadderBank::lanes == lanes, "The ladders must run on the frames of the resamplers");
+
+    static constexpr double rampSeconds = 0.05;
+
+    // A ramping drive is applied to the ladder every driveInterval samples
+    static constexpr int driveInterval = 32;
+
+    static constexpr int numGroups = (MAX_CHANS + lanes - 1) / lanes;
+    static constexpr std::size_t maxPadding = (std::size_t)HalfBandOversampler::getLatencySamples(HalfBandOversampler::maxFactor);
+
+    LadderBank channelLadders;
+    LadderBank masterLadders;
+    SmootherBank channelSmoothers;
+    SmootherBank masterSmoothers;
+    std::array<HalfBandOversampler, numGroups> oversamplers;
+    // The frames of a group at the base rate
+    std::vector<float> groupFrames;
+    // One ring of maxPadding samples per channel, of which padding are used
+    std::vector<float> paddingData;
+    Parameters parameters;
+    double currentSampleRate = 44100.0;
+    CpuDispatch::Level isaLevel = CpuDispatch::Level::baseline;
+    int blockSize = 1;
+    int activeChannels = 0;
+    int oversampling = 1;
+    int padding = 0;
+    int paddingPosition = 0;
+    // Also read by the master stage, which may run on the pipeline thread
+    std::atomic<bool> exactSaturation{false};
+
+    // Sets the ladders to the oversampled rate, which keeps their settings
+    // and clears their state
+    void prepareFilters()
+    {
+        channelLadders.prepare(currentSampleRate * oversampling);
+        masterLadders.prepare(currentSampleRate * oversampling);
+    }
+
+    // Delays numSamples samples of every channel from offset by padding
+    // samples, swapping them through the rings
+    void padLatency(float* const* channels, int numChannels, int offset, int numSamples)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* ring = paddingData.data() + (std::size_t)ch * maxPadding;
+            float* channelData = channels[ch] + offset;
+            int position = paddingPosition;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                std::swap(channelData[i], ring[position]);
+                position = position + 1 == padding ? 0 : position + 1;
+            }
+        }
+
+        paddingPosition = (paddingPosition + numSamples) % padding;
+    }
+
+    // Both stages of up to lanes channels, interleaved into frames and back
+    void processGroup(float* const* channels, int numChannels, int group, int offset, int numSamples)
+    {
+        float* frames = groupFrames.data();
+
+        for (int lane = 0; lane < numChannels; ++lane)
+        {
+            const float* channelData = channels[lane] + offset;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                frames[i * lanes + lane] = channelData[i];
+            }
+        }
+
+        processGroupStages(group, frames, numChannels, numSamples, 1);
+
+        for (int lane = 0; lane < numChannels; ++lane)
+        {
+            float* channelData = channels[lane] + offset;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                channelData[i] = frames[i * lanes + lane];
+            }
+        }
+    }
+
+    // Both stages of up to lanes channels, brought up to the oversampled
+    // rate and back together
+    void processOversampledGroup(float* const* channels, int numChannels, int group, int offset, int numSamples)
+    {
+        auto& oversampler = oversamplers.at((size_t)group);
+        float* frames = oversampler.upsample(channels, numChannels, offset, numSamples);
+        processGroupStages(group, frames, numChannels, numSamples * oversampling, oversampling);
+        oversampler.downsample(channels, numChannels, offset, numSamples);
+    }
+
+    // The channel stage then the master stage of the frames of a group, at
+    // factor times the base rate
+    void processGroupStages(int group, float* frames, int numLanes, int numSamples, int factor)
+    {
+        std::array<const float*, lanes> drives{};
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            drives[(size_t)lane] = channelSmoothers.getRamp(group * lanes + lane);
+        }
+
+        processGroupStage(channelLadders, group, drives, frames, numLanes, numSamples, factor);
+        drives.fill(masterSmoothers.getRamp(0));
+        processGroupStage(masterLadders, group, drives, frames, numLanes, numSamples, factor);
+    }
+
+    static inline float stageDrive(const StageParameters& stage)
+    {
+        return juce::jmap(stage.drive, 0.0f, 100.0f, 1.0f, 10.0f);
+    }
+
+    // setStage() leaves the drive on its target, so a ramp only has to be
+    // applied while it lasts, ending on the target with its last slice. The
+    // ramps are at the base rate, a factor of the samples given when
+    // oversampling
+    void processStage(LadderBank& ladders, int ch, const float* drives, float* channelData, int numSamples, int rampOffset, int factor = 1) const
+    {
+        ladders.setExactSaturation(isExactSaturation());
+        const int sliceLength = drives != nullptr ? driveInterval * factor : numSamples;
+
+        for (int start = 0; start < numSamples; start += sliceLength)
+        {
+            const int length = std::min(sliceLength, numSamples - start);
+
+            if (drives != nullptr)
+            {
+                ladders.setDrive(ch, drives[rampOffset + (start + length) / factor - 1]);
+            }
+
+            ladders.processChannel(ch, channelData + start, length);
+        }
+    }
+
+    // The same for the frames of a group, each lane with its own ramp
+    void processGroupStage(LadderBank& ladders, int group, const std::array<const float*, lanes>& drives, float* frames, int numLanes, int numSamples, int factor) const
+    {
+        ladders.setExactSaturation(isExactSaturation());
+        const bool ramping = std::any_of(drives.begin(), drives.begin() + numLanes, [](const float* ramp) { return ramp != nullptr; });
+        const int sliceLength = ramping ? driveInterval * factor : numSamples;
+
+        for (int start = 0; start < numSamples; start += sliceLength)
+        {
+            const int length = std::min(sliceLength, numSamples - start);
+
+            for (int lane = 0; lane < numLanes && ramping; ++lane)
+            {
+                if (drives[(size_t)lane] != nullptr)
+                {
+                    ladders.setDrive(group * lanes + lane, drives[(size_t)lane][(start + length) / factor - 1]);
+                }
+            }
+
+            ladders.processGroup(group, frames + (std::size_t)start * lanes, length, numLanes);
+        }
+    }
+
+    static inline void setStage(LadderBank& ladders, int ch, const StageParameters& stage)
+    {
+        ladders.setCutoff(ch, stage.cutoff);
+        ladders.setResonance(ch, stage.resonance * 0.01f);
+        ladders.setDrive(ch, stageDrive(stage));
+        ladders.setEnabled(ch, stage.type != 0);
+        if (stage.type > 0)
+        {
+            ladders.setMode(ch, static_cast<LadderBank::Mode>(stage.type - 1));
+        }
+    }
+};
@@ -0,0 +1,187 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "BlockTiling.h"
+#include "CpuDispatch.h"
+#include "SmootherBank.h"
+
+// DSP core of Gain64: a per-channel gain followed by a master gain, both
+// ramped to avoid zipper noise and applied as a single product.
+class GainEngine
+{
+public:
+    struct StageParameters
+    {
+        float gain = 0.0f;
+    };
+
+    struct Parameters
+    {
+        StageParameters master;
+        std::array<StageParameters, MAX_CHANS> channels;
+    };
+
+    void prepare(double sampleRate, int maxBlockSize, int numChannels)
+    {
+        blockSize = std::max(maxBlockSize, 1);
+        activeChannels = std::clamp(numChannels, 0, MAX_CHANS);
+        isaLevel = CpuDispatch::select();
+
+        // Linear gains
+        channelSmoothers.prepare(MAX_CHANS, blockSize, sampleRate, rampSeconds);
+        masterSmoothers.prepare(1, blockSize, sampleRate, rampSeconds);
+
+        setParameters(parameters);
+        channelSmoothers.jumpToTargets();
+        masterSmoothers.jumpToTargets();
+    }
+
+    void setParameters(const Parameters& newParameters)
+    {
+        parameters = newParameters;
+
+        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            channelSmoothers.setTarget((int)ch, juce::Decibels::decibelsToGain(parameters.channels.at(ch).gain));
+        }
+
+        masterSmoothers.setTarget(0, juce::Decibels::decibelsToGain(parameters.master.gain));
+    }
+
+    const Parameters& getParameters() const
+    {
+        return parameters;
+    }
+
+    // Ends the parameter ramps, so that the next block starts at the targets
+    void jumpToTargets()
+    {
+        channelSmoothers.jumpToTargets();
+        masterSmoothers.jumpToTargets();
+    }
+
+    // A channel sleeps when its own stage is neutral (0 dB of gain);
+    // reported by the instance metrics
+    bool isChannelSleeping(unsigned int ch) const
+    {
+        return juce::exactlyEqual(parameters.channels.at(ch).gain, 0.0f);
+    }
+
+    int countSleepingChannels(int numChannels) const
+    {
+        int sleeping = 0;
+
+        for (unsigned int ch = 0; ch < (unsigned int)std::clamp(numChannels, 0, MAX_CHANS); ++ch)
+        {
+            sleeping += isChannelSleeping(ch) ? 1 : 0;
+        }
+
+        return sleeping;
+    }
+
+    // Instruction set of the kernels, selected in prepare(); the per-channel
+    // functions are the kernels and are meant to be called from a
+    // CpuDispatch::run() block, as process() does
+    CpuDispatch::Level getIsaLevel() const
+    {
+        return isaLevel;
+    }
+
+    std::size_t getMemoryBytes() const
+    {
+        return sizeof(*this) + channelSmoothers.getMemoryBytes() + masterSmoothers.getMemoryBytes();
+    }
+
+    // Processes numChannels buffers in place; channels above MAX_CHANS are left untouched.
+    // Large blocks are processed in cache-sized tiles across groups of channels.
+    void process(float* const* channels, int numChannels, int numSamples)
+    {
+        numChannels = std::min(numChannels, activeChannels);
+
+        CpuDispatch::run(isaLevel, [&]
+        {
+            for (int offset = 0; offset < numSamples; offset += blockSize)
+            {
+                const int chunk = std::min(blockSize, numSamples - offset);
+                advanceSmoothers(chunk);
+
+                const auto tiling = BlockTiling::choose(numChannels, chunk, bytesPerChannelSample);
+                tiling.forEachTile(numChannels, chunk, [&](int ch, int startSample, int length)
+                {
+                    processChannel((unsigned int)ch, channels[ch] + offset + startSample, length, startSample);
+                });
+            }
+        });
+    }
+
+    // Renders the gain ramps of the next numSamples, at most the prepared
+    // block size, for the processChannel() calls that follow
+    void advanceSmoothers(int numSamples)
+    {
+        channelSmoothers.render(MAX_CHANS, numSamples);
+        masterSmoothers.render(1, numSamples);
+    }
+
+    // Processes samples of the block given to the last advanceSmoothers() call,
+    // starting rampOffset samples into it
+    void processChannel(unsigned int ch, float* channelData, int numSamples, int rampOffset = 0)
+    {
+        const float* chGains = channelSmoothers.getRamp((int)ch);
+        const float* masterGains = masterSmoothers.getRamp(0);
+        const float chGain = channelSmoothers.getCurrentValue((int)ch);
+        const float masterGain = masterSmoothers.getCurrentValue(0);
+
+        // A plain loop rather than juce::FloatVectorOperations, so that it is
+        // compiled into the kernel with its instruction set
+        if (chGains == nullptr && masterGains == nullptr)
+        {
+            const float gain = chGain * masterGain;
+
+            for (auto i = 0; i < numSamples; ++i)
+            {
+                channelData[i] *= gain;
+            }
+
+            return;
+        }
+
+        for (auto i = 0; i < numSamples; ++i)
+        {
+            const float gain = (chGains != nullptr ? chGains[rampOffset + i] : chGain)
+                * (masterGains != nullptr ? masterGains[rampOffset + i] : masterGain);
+            channelData[i] *= gain;
+        }
+    }
+
+private:
+    // Only the buffer is touched
+    static constexpr int bytesPerChannelSample = 4;
+    static constexpr double rampSeconds = 0.05;
+
+    SmootherBank channelSmoothers;
+    SmootherBank masterSmoothers;
+    Parameters parameters;
+    CpuDispatch::Level isaLevel = CpuDispatch::Level::baseline;
+    int blockSize = 1;
+    int activeChannels = 0;
+};
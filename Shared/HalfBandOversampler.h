@@ -0,0 +1,378 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// One linear phase half-band FIR, used to double or halve the rate of a
+// group of interleaved channels. Every other tap of a half-band filter is
+// zero and the others are symmetric around the centre one, so in polyphase
+// form a pair of high rate samples costs numTaps / 4 multiply-adds plus a
+// copy. Each tap is applied to a whole block at once, as one loop over all
+// the frames and lanes, which is the loop the compiler vectorises.
+template <int Lanes>
+class HalfBandStage
+{
+public:
+    // numTaps must be 4 * k + 3; the Kaiser window beta sets the stopband
+    void prepare(int taps, double beta, int maxInputFrames)
+    {
+        numTaps = taps;
+        evenTaps = (numTaps + 1) / 2;
+        design(beta);
+
+        const auto frames = (size_t)(evenTaps - 1 + maxInputFrames) * Lanes;
+        lowHistory.assign(frames, 0.0f);
+        evenHistory.assign(frames, 0.0f);
+        oddHistory.assign(frames, 0.0f);
+        work.assign((size_t)maxInputFrames * Lanes, 0.0f);
+    }
+
+    void reset()
+    {
+        std::fill(lowHistory.begin(), lowHistory.end(), 0.0f);
+        std::fill(evenHistory.begin(), evenHistory.end(), 0.0f);
+        std::fill(oddHistory.begin(), oddHistory.end(), 0.0f);
+    }
+
+    // Which of the two filtered samples downsample() keeps: the second one
+    // takes half a low rate sample off the delay
+    void setDecimationPhase(int newPhase)
+    {
+        phase = newPhase;
+    }
+
+    // Round trip delay in high rate samples
+    int getLatencySamples() const
+    {
+        return numTaps - 1 - phase;
+    }
+
+    // frames input frames into 2 * frames output frames
+    void upsample(const float* input, float* output, int frames)
+    {
+        float* newest = append(lowHistory, input, frames);
+
+        // The even outputs go through the side taps, with twice the gain for
+        // the zeros inserted between the samples
+        filter(newest, frames, 2.0f);
+
+        // The odd ones only through the centre tap, a plain delay
+        const float* centre = newest - (size_t)((evenTaps - 2) / 2) * Lanes;
+
+        for (int m = 0; m < frames; ++m)
+        {
+            float* pair = output + (size_t)(2 * m) * Lanes;
+            std::copy(work.data() + (size_t)m * Lanes, work.data() + (size_t)(m + 1) * Lanes, pair);
+            std::copy(centre + (size_t)m * Lanes, centre + (size_t)(m + 1) * Lanes, pair + Lanes);
+        }
+
+        shift(lowHistory, frames);
+    }
+
+    // 2 * frames input frames into frames output frames
+    void downsample(const float* input, float* output, int frames)
+    {
+        const size_t history = (size_t)(evenTaps - 1) * Lanes;
+
+        // Split into the even and the odd input frames, so that every tap
+        // reads consecutive frames
+        for (int m = 0; m < frames; ++m)
+        {
+            const float* pair = input + (size_t)(2 * m) * Lanes;
+            std::copy(pair, pair + Lanes, evenHistory.data() + history + (size_t)m * Lanes);
+            std::copy(pair + Lanes, pair + 2 * Lanes, oddHistory.data() + history + (size_t)m * Lanes);
+        }
+
+        // The side taps fall on the frames of the kept phase, the centre tap
+        // on the other ones
+        const float* same = (phase == 0 ? evenHistory : oddHistory).data() + history;
+        const float* other = (phase == 0 ? oddHistory : evenHistory).data() + history;
+        const int centre = numTaps / 2;
+        const float* middle = other - (size_t)((centre + 1 - phase) / 2) * Lanes;
+
+        filter(same, frames, 1.0f);
+
+        const size_t count = (size_t)frames * Lanes;
+        for (size_t i = 0; i < count; ++i)
+        {
+            output[i] = work[i] + 0.5f * middle[i];
+        }
+
+        shift(evenHistory, frames);
+        shift(oddHistory, frames);
+    }
+
+private:
+    std::vector<float> pairTaps;
+    std::vector<float> lowHistory;
+    std::vector<float> evenHistory;
+    std::vector<float> oddHistory;
+    std::vector<float> work;
+    int numTaps = 3;
+    int evenTaps = 2;
+    int phase = 0;
+
+    // Copies frames after the history, returning where they start
+    float* append(std::vector<float>& history, const float* input, int frames) const
+    {
+        float* newest = history.data() + (size_t)(evenTaps - 1) * Lanes;
+        std::copy(input, input + (size_t)frames * Lanes, newest);
+        return newest;
+    }
+
+    // Keeps the last frames as the history of the next block
+    void shift(std::vector<float>& history, int frames) const
+    {
+        std::copy(history.begin() + (std::ptrdiff_t)frames * Lanes, history.begin() + (std::ptrdiff_t)(frames + evenTaps - 1) * Lanes, history.begin());
+    }
+
+    // Side taps applied to frames frames starting at newest, into work. The
+    // taps are taken two pairs at a time, to halve the passes over work
+    void filter(const float* newest, int frames, float gain)
+    {
+        const size_t count = (size_t)frames * Lanes;
+        const int pairs = evenTaps / 2;
+        std::fill(work.begin(), work.begin() + (std::ptrdiff_t)count, 0.0f);
+
+        for (int p = 0; p < pairs; p += 2)
+        {
+            const float tap0 = gain * pairTaps[(size_t)p];
+            const float* a0 = newest - (size_t)p * Lanes;
+            const float* b0 = newest - (size_t)(evenTaps - 1 - p) * Lanes;
+            float* sum = work.data();
+
+            if (p + 1 == pairs)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    sum[i] += tap0 * (a0[i] + b0[i]);
+                }
+
+                break;
+            }
+
+            const float tap1 = gain * pairTaps[(size_t)p + 1];
+            const float* a1 = a0 - Lanes;
+            const float* b1 = b0 + Lanes;
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                sum[i] += tap0 * (a0[i] + b0[i]) + tap1 * (a1[i] + b1[i]);
+            }
+        }
+    }
+
+    // Windowed sinc cut at a quarter of the high rate, keeping the first
+    // half of the nonzero side taps; they are scaled so that each polyphase
+    // branch has a gain of one half at DC, like the centre tap
+    void design(double beta)
+    {
+        const int centre = (numTaps - 1) / 2;
+        pairTaps.assign((size_t)evenTaps / 2, 0.0f);
+
+        std::vector<double> taps((size_t)evenTaps / 2);
+        double sum = 0.0;
+
+        for (int p = 0; p < evenTaps / 2; ++p)
+        {
+            const double n = (double)(2 * p - centre);
+            const double ratio = n / (double)centre;
+            const double window = besselI0(beta * std::sqrt(1.0 - ratio * ratio)) / besselI0(beta);
+            const double x = 3.14159265358979323846 * n * 0.5;
+            taps[(size_t)p] = 0.5 * std::sin(x) / x * window;
+            sum += 2.0 * taps[(size_t)p];
+        }
+
+        for (size_t p = 0; p < taps.size(); ++p)
+        {
+            pairTaps[p] = (float)(taps[p] * 0.5 / sum);
+        }
+    }
+
+    static double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+
+        for (int k = 1; k < 50; ++k)
+        {
+            term *= (x * 0.5 / (double)k) * (x * 0.5 / (double)k);
+            sum += term;
+        }
+
+        return sum;
+    }
+};
+
+// Runs a group of up to `lanes` channels at 2 or 4 times the rate: a long
+// half-band stage between the base rate and twice it, which sets the
+// quality, and for 4x a shorter one above it, where the images to remove
+// are far from the audio band. The channels are interleaved on the way up
+// and back on the way down, so that both directions are shared by the whole
+// group. The round trip delays the signal by getLatencySamples() base rate
+// samples, a whole number in both modes.
+class HalfBandOversampler
+{
+public:
+    static constexpr int lanes = 8;
+    static constexpr int maxFactor = 4;
+
+    // Allocates the buffers for the highest factor, not realtime safe
+    void prepare(int maxBlockSize)
+    {
+        blockSize = std::max(maxBlockSize, 1);
+
+        firstStage.prepare(firstStageTaps, 8.0, blockSize);
+        secondStage.prepare(secondStageTaps, 8.0, 2 * blockSize);
+
+        baseData.assign((size_t)blockSize * lanes, 0.0f);
+        doubleData.assign((size_t)(2 * blockSize) * lanes, 0.0f);
+        quadrupleData.assign((size_t)(4 * blockSize) * lanes, 0.0f);
+
+        setFactor(factor);
+    }
+
+    // 1, 2 or 4; clears the filters, realtime safe
+    void setFactor(int newFactor)
+    {
+        factor = newFactor >= 4 ? 4 : (newFactor >= 2 ? 2 : 1);
+
+        // In 4x the delay of the second stage is odd at twice the rate,
+        // which the first stage then takes off when decimating
+        firstStage.setDecimationPhase(factor == 4 ? 1 : 0);
+        reset();
+    }
+
+    int getFactor() const
+    {
+        return factor;
+    }
+
+    void reset()
+    {
+        firstStage.reset();
+        secondStage.reset();
+    }
+
+    int getLatencySamples() const
+    {
+        if (factor == 1)
+        {
+            return 0;
+        }
+
+        if (factor == 2)
+        {
+            return firstStage.getLatencySamples() / 2;
+        }
+
+        return (firstStage.getLatencySamples() + secondStage.getLatencySamples() / 2) / 2;
+    }
+
+    // The same for a factor that is not the current one, from the stage
+    // lengths and the decimation phase chosen by setFactor()
+    static constexpr int getLatencySamples(int someFactor)
+    {
+        if (someFactor >= 4)
+        {
+            return ((firstStageTaps - 2) + (secondStageTaps - 1) / 2) / 2;
+        }
+
+        return someFactor >= 2 ? (firstStageTaps - 1) / 2 : 0;
+    }
+
+    // Interleaves numSamples samples of the first numChannels channels,
+    // starting at offset, and brings them up to the oversampled rate.
+    // Returns numSamples * getFactor() frames of lanes samples each, which
+    // can be processed in place before downsample()
+    float* upsample(const float* const* channels, int numChannels, int offset, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* frame = baseData.data() + (size_t)i * lanes;
+
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                frame[lane] = lane < numChannels ? channels[lane][offset + i] : 0.0f;
+            }
+        }
+
+        if (factor == 1)
+        {
+            return baseData.data();
+        }
+
+        firstStage.upsample(baseData.data(), doubleData.data(), numSamples);
+
+        if (factor == 2)
+        {
+            return doubleData.data();
+        }
+
+        secondStage.upsample(doubleData.data(), quadrupleData.data(), 2 * numSamples);
+        return quadrupleData.data();
+    }
+
+    // Brings the frames returned by upsample() back to the base rate and
+    // writes them to the channels
+    void downsample(float* const* channels, int numChannels, int offset, int numSamples)
+    {
+        if (factor == 4)
+        {
+            secondStage.downsample(quadrupleData.data(), doubleData.data(), 2 * numSamples);
+        }
+
+        if (factor >= 2)
+        {
+            firstStage.downsample(doubleData.data(), baseData.data(), numSamples);
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float* frame = baseData.data() + (size_t)i * lanes;
+
+            for (int lane = 0; lane < numChannels; ++lane)
+            {
+                channels[lane][offset + i] = frame[lane];
+            }
+        }
+    }
+
+    std::size_t getMemoryBytes() const
+    {
+        // The data buffers plus about as much again of filter history
+        return sizeof(*this) + 2 * (baseData.capacity() + doubleData.capacity() + quadrupleData.capacity()) * sizeof(float);
+    }
+
+private:
+    // Around 80 dB of rejection; the first stage has a transition band of
+    // about a sixth of the base rate, centred on its Nyquist frequency
+    static constexpr int firstStageTaps = 63;
+    static constexpr int secondStageTaps = 23;
+
+    HalfBandStage<lanes> firstStage;
+    HalfBandStage<lanes> secondStage;
+    std::vector<float> baseData;
+    std::vector<float> doubleData;
+    std::vector<float> quadrupleData;
+    int blockSize = 1;
+    int factor = 1;
+};
@@ -0,0 +1,303 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include "InstanceMetrics.h"
+#include "CpuDispatch.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PLUG64_SHARED_METRICS 1
+#else
+#define PLUG64_SHARED_METRICS 0
+#endif
+
+#if PLUG64_SHARED_METRICS
+
+MetricsSegment* MetricsSegment::open(bool create)
+{
+    const int fd = shm_open(name, create ? (O_RDWR | O_CREAT) : O_RDWR, 0600);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    // Several processes may grow the segment at once, they all set the same size
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (info.st_size < (off_t)sizeof(MetricsSegment) && (!create || ftruncate(fd, sizeof(MetricsSegment)) != 0)))
+    {
+        ::close(fd);
+        return nullptr;
+    }
+
+    void* memory = mmap(nullptr, sizeof(MetricsSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (memory == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    // A new segment is zero filled, which is a valid empty layout
+    auto* segment = static_cast<MetricsSegment*>(memory);
+    std::uint32_t expected = 0;
+    if (!segment->magic.compare_exchange_strong(expected, magicNumber) && expected != magicNumber)
+    {
+        munmap(memory, sizeof(MetricsSegment));
+        return nullptr;
+    }
+
+    return segment;
+}
+
+void MetricsSegment::close(MetricsSegment* segment)
+{
+    if (segment != nullptr)
+    {
+        munmap(segment, sizeof(MetricsSegment));
+    }
+}
+
+static bool isProcessAlive(std::int32_t pid)
+{
+    return pid > 0 && (kill((pid_t)pid, 0) == 0 || errno != ESRCH);
+}
+
+static std::int32_t currentProcessId()
+{
+    return (std::int32_t)getpid();
+}
+
+#else
+
+MetricsSegment* MetricsSegment::open(bool)
+{
+    return nullptr;
+}
+
+void MetricsSegment::close(MetricsSegment*)
+{
+}
+
+static bool isProcessAlive(std::int32_t)
+{
+    return true;
+}
+
+static std::int32_t currentProcessId()
+{
+    return 0;
+}
+
+#endif
+
+InstanceMetrics::InstanceMetrics(const char* pluginName)
+{
+    segment = MetricsSegment::open(true);
+    if (segment == nullptr)
+    {
+        return;
+    }
+
+    // The pid is the claim: a slot is taken by swapping in the pid of this
+    // process for 0, or for the pid of a process that has gone, so slots left
+    // behind by crashed hosts are recycled in whatever state they were left
+    const auto processId = currentProcessId();
+
+    for (auto& candidate : segment->slots)
+    {
+        auto owner = candidate.pid.load();
+
+        if ((owner == 0 || !isProcessAlive(owner)) && candidate.pid.compare_exchange_strong(owner, processId))
+        {
+            candidate.state.store(MetricsSlot::claimed);
+            slot = &candidate;
+            break;
+        }
+    }
+
+    if (slot == nullptr)
+    {
+        MetricsSegment::close(segment);
+        segment = nullptr;
+        return;
+    }
+
+    std::memset(slot->pluginName, 0, sizeof(slot->pluginName));
+    std::strncpy(slot->pluginName, pluginName, MetricsSlot::nameLength - 1);
+    slot->blocksProcessed.store(0);
+    slot->totalBlockNanos.store(0);
+    slot->maxBlockNanos.store(0);
+    slot->overruns.store(0);
+    slot->memoryBytes.store(0);
+    slot->sampleRate.store(0);
+    slot->blockSize.store(0);
+    slot->activeChannels.store(0);
+    slot->sleepingChannels.store(0);
+    slot->isaLevel.store(0);
+    slot->audioThread.store(0);
+    slot->governorLevel.store(0);
+    slot->governorStepDowns.store(0);
+    slot->governorRestores.store(0);
+    slot->state.store(MetricsSlot::live, std::memory_order_release);
+}
+
+InstanceMetrics::~InstanceMetrics()
+{
+    if (slot != nullptr)
+    {
+        // Giving up the pid last hands the slot over
+        slot->state.store(MetricsSlot::free, std::memory_order_release);
+        slot->pid.store(0, std::memory_order_release);
+    }
+
+    MetricsSegment::close(segment);
+}
+
+void InstanceMetrics::prepare(double sampleRate, int blockSize, std::size_t memoryBytes)
+{
+    currentSampleRate = sampleRate;
+    measureSamples = 0;
+    measured = false;
+    processLoad = 0.0;
+
+    if (slot == nullptr)
+    {
+        return;
+    }
+
+    slot->sampleRate.store((std::uint32_t)sampleRate, std::memory_order_relaxed);
+    slot->blockSize.store((std::uint32_t)std::max(blockSize, 0), std::memory_order_relaxed);
+    slot->memoryBytes.store((std::uint64_t)memoryBytes, std::memory_order_relaxed);
+    slot->isaLevel.store((std::uint32_t)CpuDispatch::select(), std::memory_order_relaxed);
+}
+
+void InstanceMetrics::endBlock(int numSamples, int activeChannels, int sleepingChannels)
+{
+    const auto now = std::chrono::steady_clock::now();
+    const auto elapsed = now - blockStart;
+    const auto nanos = (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    lastBlockNanos = nanos;
+
+    if (slot == nullptr)
+    {
+        return;
+    }
+
+    // Single writer, so load-then-store is enough for the running values
+    const auto relaxed = std::memory_order_relaxed;
+    slot->blocksProcessed.store(slot->blocksProcessed.load(relaxed) + 1, relaxed);
+    slot->totalBlockNanos.store(slot->totalBlockNanos.load(relaxed) + nanos, relaxed);
+
+    if (nanos > slot->maxBlockNanos.load(relaxed))
+    {
+        slot->maxBlockNanos.store(nanos, relaxed);
+    }
+
+    if (currentSampleRate > 0.0 && (double)nanos > (double)numSamples * 1.0e9 / currentSampleRate)
+    {
+        slot->overruns.store(slot->overruns.load(relaxed) + 1, relaxed);
+    }
+
+    slot->activeChannels.store((std::uint32_t)std::max(activeChannels, 0), relaxed);
+    slot->sleepingChannels.store((std::uint32_t)std::max(sleepingChannels, 0), relaxed);
+
+    const auto thread = (std::uint64_t)std::hash<std::thread::id>{}(std::this_thread::get_id());
+    slot->audioThread.store(thread, relaxed);
+
+    measureSamples += (std::uint64_t)std::max(numSamples, 0);
+
+    if (!measured || (double)measureSamples >= processLoadSeconds * currentSampleRate)
+    {
+        measureProcessLoad(now, thread);
+    }
+}
+
+void InstanceMetrics::measureProcessLoad(std::chrono::steady_clock::time_point now, std::uint64_t thread)
+{
+    const auto relaxed = std::memory_order_relaxed;
+    const auto processId = slot->pid.load(relaxed);
+    std::uint64_t busyNanos = 0;
+
+    for (int i = 0; i < MetricsSegment::numSlots; ++i)
+    {
+        const auto& candidate = segment->slots[i];
+        auto& previous = slotNanos.at((size_t)i);
+
+        if (candidate.state.load(std::memory_order_acquire) != MetricsSlot::live || candidate.pid.load(relaxed) != processId)
+        {
+            previous = 0;
+            continue;
+        }
+
+        // A slot taken over by a new instance starts counting from zero. The
+        // others are followed too, so that an instance moving to this
+        // thread only counts from then on.
+        const auto nanos = candidate.totalBlockNanos.load(relaxed);
+
+        if (candidate.audioThread.load(relaxed) == thread)
+        {
+            busyNanos += nanos >= previous ? nanos - previous : nanos;
+        }
+
+        previous = nanos;
+    }
+
+    // The first pass only takes the counters as they stand. The blocks of a
+    // thread run one after the other, so their time adds up to at most the
+    // time elapsed while the thread keeps up.
+    if (measured)
+    {
+        const auto wallNanos = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(now - measureStart).count();
+        processLoad = wallNanos > 0.0 ? (double)busyNanos / wallNanos : 0.0;
+    }
+
+    measured = true;
+    measureStart = now;
+    measureSamples = 0;
+}
+
+void InstanceMetrics::setGovernorLevel(int level)
+{
+    if (slot == nullptr)
+    {
+        return;
+    }
+
+    const auto relaxed = std::memory_order_relaxed;
+    const auto previous = (int)slot->governorLevel.load(relaxed);
+
+    if (level > previous)
+    {
+        slot->governorStepDowns.store(slot->governorStepDowns.load(relaxed) + 1, relaxed);
+    }
+    else if (level < previous)
+    {
+        slot->governorRestores.store(slot->governorRestores.load(relaxed) + 1, relaxed);
+    }
+
+    slot->governorLevel.store((std::uint32_t)std::max(level, 0), relaxed);
+}
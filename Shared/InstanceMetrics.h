@@ -0,0 +1,150 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Health counters of every running Plug64 instance, published to a single
+// named POSIX shared-memory segment that plug64-top reads. Each instance owns
+// one slot and is its only writer, so updates are plain relaxed atomic
+// stores with no locks. The segment does not depend on JUCE, so that the
+// monitor can be built without it.
+
+struct MetricsSlot
+{
+    enum State : std::uint32_t
+    {
+        free = 0,
+        claimed = 1,
+        live = 2
+    };
+
+    static constexpr int nameLength = 16;
+
+    std::atomic<std::uint32_t> state;
+    // Process owning the slot, 0 when it is free
+    std::atomic<std::int32_t> pid;
+    char pluginName[nameLength];
+
+    std::atomic<std::uint64_t> blocksProcessed;
+    std::atomic<std::uint64_t> totalBlockNanos;
+    std::atomic<std::uint64_t> maxBlockNanos;
+    std::atomic<std::uint64_t> overruns;
+    std::atomic<std::uint64_t> memoryBytes;
+    std::atomic<std::uint32_t> sampleRate;
+    std::atomic<std::uint32_t> blockSize;
+    std::atomic<std::uint32_t> activeChannels;
+    std::atomic<std::uint32_t> sleepingChannels;
+    std::atomic<std::uint32_t> isaLevel;
+    // Thread that processed the last block, which groups the instances
+    // sharing an audio thread
+    std::atomic<std::uint64_t> audioThread;
+
+    // Quality steps dropped by the CPU governor, and its transitions
+    std::atomic<std::uint32_t> governorLevel;
+    std::atomic<std::uint64_t> governorStepDowns;
+    std::atomic<std::uint64_t> governorRestores;
+};
+
+struct MetricsSegment
+{
+    static constexpr const char* name = "/plug64-metrics";
+    // Changed whenever the layout or the claiming of the slots changes
+    static constexpr std::uint32_t magicNumber = 0x50363405;
+    static constexpr int numSlots = 256;
+
+    std::atomic<std::uint32_t> magic;
+    MetricsSlot slots[numSlots];
+
+    // Maps the segment, creating it if needed; returns nullptr when shared
+    // memory is not available (unsupported platform, sandboxed host, ...)
+    static MetricsSegment* open(bool create);
+    static void close(MetricsSegment* segment);
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "metrics must be address-free across processes");
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "metrics must be address-free across processes");
+
+// Publisher used by the processors. Everything but the constructor and the
+// destructor is realtime safe; if no slot can be claimed all calls are no-ops.
+class InstanceMetrics
+{
+public:
+    explicit InstanceMetrics(const char* pluginName);
+    ~InstanceMetrics();
+
+    void prepare(double sampleRate, int blockSize, std::size_t memoryBytes);
+
+    void beginBlock()
+    {
+        blockStart = std::chrono::steady_clock::now();
+    }
+
+    void endBlock(int numSamples, int activeChannels, int sleepingChannels);
+
+    // Time taken by the block of the last endBlock() call, measured even when
+    // nothing is published
+    std::uint64_t getLastBlockNanos() const
+    {
+        return lastBlockNanos;
+    }
+
+    // Processing time of all the instances of this process whose last block
+    // ran on the same audio thread as this one, over about the last 100 ms,
+    // relative to that time. Instances that each take a small share of their
+    // block time can still overload their audio thread together, which only
+    // this load shows. Measured by endBlock(); 0 when nothing is published.
+    double getProcessLoad() const
+    {
+        return processLoad;
+    }
+
+    // Records a transition of the CPU governor to a new level
+    void setGovernorLevel(int level);
+
+    bool isPublishing() const
+    {
+        return slot != nullptr;
+    }
+
+private:
+    static constexpr double processLoadSeconds = 0.1;
+
+    MetricsSegment* segment = nullptr;
+    MetricsSlot* slot = nullptr;
+    double currentSampleRate = 0.0;
+    std::chrono::steady_clock::time_point blockStart;
+    std::uint64_t lastBlockNanos = 0;
+
+    // Block time of each slot of the process at the last measurement
+    std::array<std::uint64_t, MetricsSegment::numSlots> slotNanos{};
+    std::chrono::steady_clock::time_point measureStart;
+    std::uint64_t measureSamples = 0;
+    bool measured = false;
+    double processLoad = 0.0;
+
+    void measureProcessLoad(std::chrono::steady_clock::time_point now, std::uint64_t thread);
+
+    InstanceMetrics(const InstanceMetrics&) = delete;
+    InstanceMetrics& operator=(const InstanceMetrics&) = delete;
+};
@@ -0,0 +1,497 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <juce_core/juce_core.h>
+#include "CpuDispatch.h"
+
+// Ladder filters for many channels: a port of juce::dsp::LadderFilter, kept
+// in a header so that it is compiled into the CpuDispatch kernels instead of
+// running the baseline build of the JUCE modules. The settings and states
+// are stored lane by lane in groups of `lanes` channels, and processGroup()
+// runs the filters of a whole group as one vector per sample where
+// CpuDispatch is available, one lane after the other elsewhere;
+// processChannel() runs a single filter with the same arithmetic. As in
+// juce::dsp::LadderFilter, the cutoff and resonance ramp over 50 ms on their
+// own, and a disabled filter passes its input and holds its state.
+class LadderBank
+{
+public:
+    static constexpr int lanes = 8;
+    static constexpr int numGroups = (MAX_CHANS + lanes - 1) / lanes;
+
+    // In the order of juce::dsp::LadderFilterMode
+    enum class Mode
+    {
+        lpf12,
+        hpf12,
+        bpf12,
+        lpf24,
+        hpf24,
+        bpf24
+    };
+
+    // The defaults of juce::dsp::LadderFilter
+    LadderBank()
+    {
+        cutoffs.fill(200.0f);
+        modes.fill(Mode::lpf24);
+        prepare(1000.0);
+
+        for (int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            setResonance(ch, 0.0f);
+            setDrive(ch, 1.2f);
+            setMode(ch, Mode::lpf12);
+        }
+    }
+
+    // Sets the sample rate and clears the states, the cutoffs and resonances
+    // jumping to their targets; realtime safe
+    void prepare(double sampleRate)
+    {
+        cutoffScaler = (float)(-2.0 * juce::MathConstants<double>::pi) / (float)sampleRate;
+        rampLength = (int)std::floor(rampSeconds * sampleRate);
+
+        for (int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            groups.at((size_t)(ch / lanes)).cutoffTarget[ch % lanes] = std::exp(cutoffs.at((size_t)ch) * cutoffScaler);
+            reset(ch);
+        }
+    }
+
+    void setCutoff(int ch, float cutoffHz)
+    {
+        auto& group = groups.at((size_t)(ch / lanes));
+        cutoffs.at((size_t)ch) = cutoffHz;
+        setTarget(group.cutoff, group.cutoffTarget, group.cutoffStep, group.cutoffRemaining, ch % lanes, std::exp(cutoffHz * cutoffScaler));
+    }
+
+    // From 0 to 1
+    void setResonance(int ch, float resonance)
+    {
+        auto& group = groups.at((size_t)(ch / lanes));
+        setTarget(group.resonance, group.resonanceTarget, group.resonanceStep, group.resonanceRemaining, ch % lanes, juce::jmap(resonance, 0.1f, 1.0f));
+    }
+
+    // From 1 up
+    void setDrive(int ch, float drive)
+    {
+        auto& group = groups.at((size_t)(ch / lanes));
+        const int lane = ch % lanes;
+
+        if (juce::exactlyEqual(group.drive[lane], drive))
+        {
+            return;
+        }
+
+        group.drive[lane] = drive;
+        group.gain[lane] = std::pow(drive, -2.642f) * 0.6103f + 0.3903f;
+        group.drive2[lane] = drive * 0.04f + 0.96f;
+        group.gain2[lane] = std::pow(group.drive2[lane], -2.642f) * 0.6103f + 0.3903f;
+    }
+
+    void setEnabled(int ch, bool shouldBeEnabled)
+    {
+        groups.at((size_t)(ch / lanes)).enabled[ch % lanes] = shouldBeEnabled ? -1 : 0;
+    }
+
+    // Clears the state of the filter when the mode changes
+    void setMode(int ch, Mode mode)
+    {
+        if (modes.at((size_t)ch) == mode)
+        {
+            return;
+        }
+
+        static constexpr std::array<std::array<float, 5>, 6> mixes{{
+            {{0.0f, 0.0f, 1.0f, 0.0f, 0.0f}},
+            {{1.0f, -2.0f, 1.0f, 0.0f, 0.0f}},
+            {{0.0f, 0.0f, -1.0f, 1.0f, 0.0f}},
+            {{0.0f, 0.0f, 0.0f, 0.0f, 1.0f}},
+            {{1.0f, -4.0f, 6.0f, -4.0f, 1.0f}},
+            {{0.0f, 0.0f, 1.0f, -2.0f, 1.0f}}}};
+        static constexpr float outputGain = 1.2f;
+
+        auto& group = groups.at((size_t)(ch / lanes));
+        const int lane = ch % lanes;
+
+        for (size_t pole = 0; pole < 5; ++pole)
+        {
+            group.mix[pole][lane] = mixes.at((size_t)mode)[pole] * outputGain;
+        }
+
+        group.compensation[lane] = mode == Mode::hpf12 || mode == Mode::hpf24 ? 0.0f : 0.5f;
+        modes.at((size_t)ch) = mode;
+        reset(ch);
+    }
+
+    // Computes the saturation with std::tanh instead of reading it from the
+    // table, which is several times slower but exact beyond the table range
+    // and between its points
+    void setExactSaturation(bool enabled)
+    {
+        exactSaturation = enabled;
+    }
+
+    bool isExactSaturation() const
+    {
+        return exactSaturation;
+    }
+
+    // Filters numSamples frames of `lanes` interleaved samples with the
+    // filters of a group, the lanes from numLanes on being left untouched
+    void processGroup(int group, float* frames, int numSamples, int numLanes)
+    {
+        auto& g = groups.at((size_t)group);
+        IntLanes active{};
+        bool anyActive = false;
+
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            active[lane] = lane < numLanes ? g.enabled[lane] : 0;
+            anyActive = anyActive || active[lane] != 0;
+        }
+
+        if (!anyActive)
+        {
+            return;
+        }
+
+#if PLUG64_CPU_DISPATCH
+        Voice<Vector> voice{exactSaturation};
+        voice.load(g, [](Vector& vector, const Lanes& values) { std::memcpy(&vector, values.data(), sizeof(vector)); });
+        Mask mask;
+        std::memcpy(&mask, active.data(), sizeof(mask));
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* frame = frames + i * lanes;
+            Vector input;
+            std::memcpy(&input, frame, sizeof(input));
+            const Vector output = voice.process(input, mask);
+            std::memcpy(frame, &output, sizeof(output));
+        }
+
+        voice.store(g, [](Lanes& values, const Vector& vector) { std::memcpy(values.data(), &vector, sizeof(vector)); });
+#else
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            if (active[lane] == 0)
+            {
+                continue;
+            }
+
+            Voice<float> voice{exactSaturation};
+            voice.load(g, [lane](float& value, const Lanes& values) { value = values[lane]; });
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                frames[i * lanes + lane] = voice.process(frames[i * lanes + lane], true);
+            }
+
+            voice.store(g, [lane](Lanes& values, float value) { values[lane] = value; });
+        }
+#endif
+    }
+
+    // Filters numSamples samples of a single channel
+    void processChannel(int ch, float* channelData, int numSamples)
+    {
+        auto& g = groups.at((size_t)(ch / lanes));
+        const int lane = ch % lanes;
+
+        if (g.enabled[lane] == 0)
+        {
+            return;
+        }
+
+        Voice<float> voice{exactSaturation};
+        voice.load(g, [lane](float& value, const Lanes& values) { value = values[lane]; });
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            channelData[i] = voice.process(channelData[i], true);
+        }
+
+        voice.store(g, [lane](Lanes& values, float value) { values[lane] = value; });
+    }
+
+private:
+    using Lanes = std::array<float, lanes>;
+    using IntLanes = std::array<int, lanes>;
+
+#if PLUG64_CPU_DISPATCH
+    // A whole group, with the masks its comparisons give
+    using Vector = float __attribute__((vector_size(lanes * sizeof(float))));
+    using Mask = int __attribute__((vector_size(lanes * sizeof(int))));
+#endif
+
+    static constexpr double rampSeconds = 0.05;
+
+    // tanh tabulated as juce::dsp::LadderFilter does, over 128 points from
+    // -5 to 5 plus a guard point, and read with linear interpolation
+    static constexpr int saturationPoints = 128;
+    static constexpr float saturationRange = 5.0f;
+
+    struct alignas(32) Group
+    {
+        // Input of the poles and output of each of them
+        std::array<Lanes, 5> state{};
+        // Weights of the state in the output
+        std::array<Lanes, 5> mix{};
+        Lanes compensation{};
+        Lanes drive{};
+        Lanes gain{};
+        Lanes drive2{};
+        Lanes gain2{};
+        Lanes cutoff{};
+        Lanes cutoffTarget{};
+        Lanes cutoffStep{};
+        Lanes cutoffRemaining{};
+        Lanes resonance{};
+        Lanes resonanceTarget{};
+        Lanes resonanceStep{};
+        Lanes resonanceRemaining{};
+        // All bits set when enabled
+        IntLanes enabled{};
+    };
+
+    // The settings and state of one lane, or of a whole group, held in
+    // registers while a block is processed
+    template <typename Value>
+    struct Voice
+    {
+        bool exact;
+        std::array<Value, 5> state;
+        std::array<Value, 5> mix;
+        Value compensation, drive, gain, drive2, gain2;
+        Value cutoff, cutoffTarget, cutoffStep, cutoffRemaining;
+        Value resonance, resonanceTarget, resonanceStep, resonanceRemaining;
+
+        template <typename Load>
+        void load(const Group& g, Load&& read)
+        {
+            for (size_t pole = 0; pole < 5; ++pole)
+            {
+                read(state[pole], g.state[pole]);
+                read(mix[pole], g.mix[pole]);
+            }
+
+            read(compensation, g.compensation);
+            read(drive, g.drive);
+            read(gain, g.gain);
+            read(drive2, g.drive2);
+            read(gain2, g.gain2);
+            read(cutoff, g.cutoff);
+            read(cutoffTarget, g.cutoffTarget);
+            read(cutoffStep, g.cutoffStep);
+            read(cutoffRemaining, g.cutoffRemaining);
+            read(resonance, g.resonance);
+            read(resonanceTarget, g.resonanceTarget);
+            read(resonanceStep, g.resonanceStep);
+            read(resonanceRemaining, g.resonanceRemaining);
+        }
+
+        // Only the state and the ramps move
+        template <typename Store>
+        void store(Group& g, Store&& write) const
+        {
+            for (size_t pole = 0; pole < 5; ++pole)
+            {
+                write(g.state[pole], state[pole]);
+            }
+
+            write(g.cutoff, cutoff);
+            write(g.cutoffRemaining, cutoffRemaining);
+            write(g.resonance, resonance);
+            write(g.resonanceRemaining, resonanceRemaining);
+        }
+
+        // One sample; an inactive lane passes its input and keeps its state
+        template <typename Flag>
+        Value process(Value input, Flag active)
+        {
+            const Value a1 = advance(cutoff, cutoffTarget, cutoffStep, cutoffRemaining, active);
+            const Value scaledResonance = advance(resonance, resonanceTarget, resonanceStep, resonanceRemaining, active);
+            const Value feedback = 1.0f - a1;
+            const Value b0 = feedback * 0.76923076923f;
+            const Value b1 = feedback * 0.23076923076f;
+
+            const Value dx = gain * saturate(drive * input, exact);
+            const Value a = dx + scaledResonance * -4.0f * (gain2 * saturate(drive2 * state[4], exact) - dx * compensation);
+            const Value b = b1 * state[0] + a1 * state[1] + b0 * a;
+            const Value c = b1 * state[1] + a1 * state[2] + b0 * b;
+            const Value d = b1 * state[2] + a1 * state[3] + b0 * c;
+            const Value e = b1 * state[3] + a1 * state[4] + b0 * d;
+            const Value output = a * mix[0] + b * mix[1] + c * mix[2] + d * mix[3] + e * mix[4];
+
+            state[0] = select(active, a, state[0]);
+            state[1] = select(active, b, state[1]);
+            state[2] = select(active, c, state[2]);
+            state[3] = select(active, d, state[3]);
+            state[4] = select(active, e, state[4]);
+            return select(active, output, input);
+        }
+
+        // Next value of a ramp. As in SmootherBank, it is computed in closed
+        // form from the target, which ends the ramp on it exactly, rather
+        // than added up as juce::SmoothedValue does.
+        template <typename Flag>
+        static Value advance(Value& current, Value target, Value step, Value& remaining, Flag active)
+        {
+            const Value counted = remaining - 1.0f;
+            const Value left = select(counted > 0.0f, counted, Value{});
+            const Value value = target - left * step;
+
+            current = select(active, value, current);
+            remaining = select(active, left, remaining);
+            return value;
+        }
+    };
+
+    std::array<Group, numGroups> groups;
+    std::array<float, MAX_CHANS> cutoffs{};
+    std::array<Mode, MAX_CHANS> modes{};
+    float cutoffScaler = 0.0f;
+    int rampLength = 0;
+    bool exactSaturation = false;
+
+    inline static const std::array<float, saturationPoints + 1> saturationTable = []
+    {
+        std::array<float, saturationPoints + 1> table{};
+
+        for (int i = 0; i < saturationPoints; ++i)
+        {
+            table.at((size_t)i) = std::tanh(juce::jmap((float)i, 0.0f, (float)(saturationPoints - 1), -saturationRange, saturationRange));
+        }
+
+        table.back() = table.at(saturationPoints - 1);
+        return table;
+    }();
+
+    static inline float select(bool flag, float a, float b)
+    {
+        return flag ? a : b;
+    }
+
+    static inline float tanh(float x)
+    {
+        return std::tanh(x);
+    }
+
+    static inline float lookup(float index)
+    {
+        const int i = (int)index;
+        const float below = saturationTable[(size_t)i];
+        return below + (index - (float)i) * (saturationTable[(size_t)i + 1] - below);
+    }
+
+#if PLUG64_CPU_DISPATCH
+    static inline Vector select(Mask mask, Vector a, Vector b)
+    {
+        return (Vector)((mask & (Mask)a) | (~mask & (Mask)b));
+    }
+
+    static inline Vector tanh(Vector x)
+    {
+        Vector y;
+
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            y[lane] = std::tanh(x[lane]);
+        }
+
+        return y;
+    }
+
+    static inline Vector lookup(Vector index)
+    {
+        const Mask i = __builtin_convertvector(index, Mask);
+        Vector below;
+        Vector above;
+
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            below[lane] = saturationTable[(size_t)i[lane]];
+            above[lane] = saturationTable[(size_t)i[lane] + 1];
+        }
+
+        return below + (index - __builtin_convertvector(i, Vector)) * (above - below);
+    }
+#endif
+
+    template <typename Value>
+    static inline Value saturate(Value x, bool exact)
+    {
+        if (exact)
+        {
+            return tanh(x);
+        }
+
+        constexpr float scaler = (float)(saturationPoints - 1) / (2.0f * saturationRange);
+        constexpr float offset = saturationRange * scaler;
+        const Value low = Value{} - saturationRange;
+        const Value high = Value{} + saturationRange;
+
+        const Value clamped = select(x < low, low, select(x > high, high, x));
+        return lookup(clamped * scaler + offset);
+    }
+
+    void setTarget(Lanes& current, Lanes& target, Lanes& step, Lanes& remaining, int lane, float value)
+    {
+        if (juce::exactlyEqual(target[lane], value))
+        {
+            return;
+        }
+
+        target[lane] = value;
+
+        if (rampLength <= 0)
+        {
+            current[lane] = value;
+            remaining[lane] = 0.0f;
+            return;
+        }
+
+        remaining[lane] = (float)rampLength;
+        step[lane] = (value - current[lane]) / (float)rampLength;
+    }
+
+    // Clears the state and ends the ramps
+    void reset(int ch)
+    {
+        auto& group = groups.at((size_t)(ch / lanes));
+        const int lane = ch % lanes;
+
+        for (auto& pole : group.state)
+        {
+            pole[lane] = 0.0f;
+        }
+
+        group.cutoff[lane] = group.cutoffTarget[lane];
+        group.cutoffRemaining[lane] = 0.0f;
+        group.resonance[lane] = group.resonanceTarget[lane];
+        group.resonanceRemaining[lane] = 0.0f;
+    }
+};
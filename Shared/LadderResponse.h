@@ -0,0 +1,115 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <juce_core/juce_core.h>
+#include "FilterEngine.h"
+
+// Frequency response of a Filter64 stage, worked out from the coefficients
+// LadderBank computes for it: four one-pole stages with the last one fed
+// back to the input, their outputs mixed according to the mode. The
+// saturation is taken as linear, which holds at low levels, so the drive
+// only changes the gain and the depth of the feedback.
+class LadderResponse
+{
+public:
+    LadderResponse(const FilterEngine::StageParameters& stage, double sampleRate) :
+        currentSampleRate(sampleRate)
+    {
+        enabled = stage.type > 0 && stage.type <= (int)mixes.size() && sampleRate > 0.0;
+
+        if (!enabled)
+        {
+            return;
+        }
+
+        const auto& mix = mixes.at((size_t)stage.type - 1);
+        mixCoefficients = mix.coefficients;
+
+        pole = std::exp(-2.0 * juce::MathConstants<double>::pi * (double)stage.cutoff / sampleRate);
+        b0 = (1.0 - pole) * 0.76923076923;
+        b1 = (1.0 - pole) * 0.23076923076;
+
+        const double resonance = juce::jmap((double)stage.resonance * 0.01, 0.1, 1.0);
+        const double drive = juce::jmap((double)stage.drive, 0.0, 100.0, 1.0, 10.0);
+        const double drive2 = drive * 0.04 + 0.96;
+        const double inputGain = (std::pow(drive, -2.642) * 0.6103 + 0.3903) * drive;
+
+        feedback = 4.0 * resonance * (std::pow(drive2, -2.642) * 0.6103 + 0.3903) * drive2;
+        inputScale = inputGain * (1.0 + 4.0 * resonance * mix.compensation) * outputGain;
+    }
+
+    // Magnitude at frequency in Hz, in dB; a stage that is off gives 0 dB
+    float getMagnitudeDecibels(double frequency) const
+    {
+        if (!enabled)
+        {
+            return 0.0f;
+        }
+
+        const auto zInverse = std::polar(1.0, -2.0 * juce::MathConstants<double>::pi * frequency / currentSampleRate);
+        const auto onePole = (b0 + b1 * zInverse) / (1.0 - pole * zInverse);
+
+        // Input of the first one-pole stage, then the mix of the outputs
+        std::complex<double> stageGain(1.0);
+        std::complex<double> mixed = mixCoefficients[0];
+
+        for (size_t i = 1; i < mixCoefficients.size(); ++i)
+        {
+            stageGain *= onePole;
+            mixed += mixCoefficients[i] * stageGain;
+        }
+
+        const auto response = inputScale * mixed / (1.0 + feedback * zInverse * stageGain);
+
+        return (float)(20.0 * std::log10(std::max(std::abs(response), 1.0e-9)));
+    }
+
+private:
+    struct Mix
+    {
+        std::array<double, 5> coefficients;
+        double compensation;
+    };
+
+    // Mix of the outputs and resonance compensation of each mode, in the
+    // order of LadderBank::Mode
+    static constexpr std::array<Mix, 6> mixes
+    {{
+        {{0.0, 0.0, 1.0, 0.0, 0.0}, 0.5},
+        {{1.0, -2.0, 1.0, 0.0, 0.0}, 0.0},
+        {{0.0, 0.0, -1.0, 1.0, 0.0}, 0.5},
+        {{0.0, 0.0, 0.0, 0.0, 1.0}, 0.5},
+        {{1.0, -4.0, 6.0, -4.0, 1.0}, 0.0},
+        {{0.0, 0.0, 1.0, -2.0, 1.0}, 0.5}
+    }};
+
+    static constexpr double outputGain = 1.2;
+
+    double currentSampleRate;
+    std::array<double, 5> mixCoefficients{};
+    double pole = 0.0;
+    double b0 = 0.0;
+    double b1 = 0.0;
+    double feedback = 0.0;
+    double inputScale = 1.0;
+    bool enabled = false;
+};
@@ -0,0 +1,126 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include "LevelMeterStrip.h"
+
+LevelMeterStrip::LevelMeterStrip(LevelMeters& metersToShow, const CustomLookAndFeel& lookAndFeelToUse) :
+    meters(metersToShow),
+    customLookAndFeel(lookAndFeelToUse)
+{
+    setOpaque(true);
+    setInterceptsMouseClicks(false, false);
+    startTimerHz(frameRate);
+}
+
+LevelMeterStrip::~LevelMeterStrip()
+{
+    stopTimer();
+}
+
+void LevelMeterStrip::paint(juce::Graphics& g)
+{
+    g.fillAll(customLookAndFeel.backgroundColour);
+
+    const auto clip = g.getClipBounds();
+
+    for (int ch = 0; ch < MAX_CHANS; ++ch)
+    {
+        const auto cell = getCellBounds(ch);
+
+        if (!cell.intersects(clip))
+        {
+            continue;
+        }
+
+        if (ch >= shownChannels)
+        {
+            g.setColour(customLookAndFeel.backgroundColour.brighter(0.05f));
+            g.fillRect(cell);
+            continue;
+        }
+
+        g.setColour(customLookAndFeel.backgroundColour.brighter(0.15f));
+        g.fillRect(cell);
+
+        const auto rmsHeight = shownRms[(size_t)ch];
+        g.setColour(customLookAndFeel.mainChSliderColour);
+        g.fillRect(cell.withTop(cell.getBottom() - rmsHeight));
+
+        if (const auto peakHeight = shownPeaks[(size_t)ch]; peakHeight > 0)
+        {
+            g.setColour(shownClipping[(size_t)ch] ? juce::Colour(214, 108, 87) : customLookAndFeel.textColour);
+            g.fillRect(cell.getX(), cell.getBottom() - peakHeight, cell.getWidth(), 1);
+        }
+    }
+}
+
+void LevelMeterStrip::resized()
+{
+    // The heights depend on the size, so the next levels repaint everything
+    shownPeaks.fill(-1);
+    shownRms.fill(-1);
+    repaint();
+}
+
+void LevelMeterStrip::timerCallback()
+{
+    if (!meters.read(levels))
+    {
+        return;
+    }
+
+    if (levels.numChannels != shownChannels)
+    {
+        shownChannels = levels.numChannels;
+        repaint();
+    }
+
+    for (int ch = 0; ch < shownChannels; ++ch)
+    {
+        const auto index = (size_t)ch;
+        const int peak = toHeight(levels.peak[index]);
+        const int rms = toHeight(levels.rms[index]);
+        const bool clipping = levels.peak[index] >= 1.0f;
+
+        if (peak != shownPeaks[index] || rms != shownRms[index] || clipping != shownClipping[index])
+        {
+            shownPeaks[index] = peak;
+            shownRms[index] = rms;
+            shownClipping[index] = clipping;
+            repaint(getCellBounds(ch));
+        }
+    }
+}
+
+juce::Rectangle<int> LevelMeterStrip::getCellBounds(int ch) const
+{
+    const float cellWidth = (float)getWidth() / (float)MAX_CHANS;
+    const int left = juce::roundToInt(cellWidth * (float)ch);
+    const int right = juce::roundToInt(cellWidth * (float)(ch + 1));
+
+    // One pixel between the cells, when they are wide enough for it
+    return {left, 0, std::max(right - left - (cellWidth >= 3.0f ? 1 : 0), 1), getHeight()};
+}
+
+int LevelMeterStrip::toHeight(float level) const
+{
+    const float decibels = juce::Decibels::gainToDecibels(level, floorDecibels);
+    const float proportion = juce::jlimit(0.0f, 1.0f, (decibels - floorDecibels) / -floorDecibels);
+
+    return juce::roundToInt(proportion * (float)getHeight());
+}
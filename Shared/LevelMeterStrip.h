@@ -0,0 +1,56 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <array>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "CustomLookAndFeel.h"
+#include "LevelMeters.h"
+
+// One cell per channel showing its RMS as a bar and its peak as a line, on a
+// dB scale. The levels are polled at a capped frame rate and only the cells
+// whose bar or line moved by at least a pixel are repainted.
+class LevelMeterStrip : public juce::Component, private juce::Timer
+{
+public:
+    LevelMeterStrip(LevelMeters& metersToShow, const CustomLookAndFeel& lookAndFeelToUse);
+    ~LevelMeterStrip() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    static constexpr int frameRate = 30;
+    static constexpr float floorDecibels = -60.0f;
+
+    LevelMeters& meters;
+    const CustomLookAndFeel& customLookAndFeel;
+    LevelMeters::Levels levels;
+    // Heights shown in pixels, compared with the new ones to find what to repaint
+    std::array<int, MAX_CHANS> shownPeaks{};
+    std::array<int, MAX_CHANS> shownRms{};
+    std::array<bool, MAX_CHANS> shownClipping{};
+    int shownChannels = 0;
+
+    void timerCallback() override;
+    juce::Rectangle<int> getCellBounds(int ch) const;
+    int toHeight(float level) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeterStrip)
+};
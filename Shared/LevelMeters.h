@@ -0,0 +1,152 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "CpuDispatch.h"
+#include "TripleBuffer.h"
+
+// Per-channel levels of the processed signal, for the editor meters. They
+// are measured once per block on the audio thread, with a decaying peak and
+// an RMS averaged over a few hundred milliseconds so that the editor, which
+// only takes the latest levels, misses nothing between two frames. The
+// levels are handed over through a TripleBuffer, so neither side waits.
+class LevelMeters
+{
+public:
+    struct Levels
+    {
+        // Linear levels of the first numChannels channels
+        std::array<float, MAX_CHANS> peak{};
+        std::array<float, MAX_CHANS> rms{};
+        int numChannels = 0;
+    };
+
+    void prepare(double sampleRate, int numChannels)
+    {
+        currentSampleRate = sampleRate;
+        activeChannels = std::clamp(numChannels, 0, MAX_CHANS);
+        isaLevel = CpuDispatch::select();
+
+        peaks.fill(0.0f);
+        meanSquares.fill(0.0f);
+    }
+
+    // Called at the end of processBlock() with the output channels; channels
+    // above MAX_CHANS are not measured
+    void process(const float* const* channels, int numChannels, int numSamples)
+    {
+        numChannels = std::min(numChannels, activeChannels);
+
+        if (numSamples <= 0 || currentSampleRate <= 0.0)
+        {
+            return;
+        }
+
+        const float seconds = (float)((double)numSamples / currentSampleRate);
+        const float peakDecay = std::exp(-seconds / peakReleaseSeconds);
+        const float rmsCoefficient = 1.0f - std::exp(-seconds / rmsSeconds);
+        const float inverseLength = 1.0f / (float)numSamples;
+
+        CpuDispatch::run(isaLevel, [&]
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                float blockPeak = 0.0f;
+                float sumSquares = 0.0f;
+                measure(channels[ch], numSamples, blockPeak, sumSquares);
+
+                peaks[(size_t)ch] = std::max(blockPeak, peaks[(size_t)ch] * peakDecay);
+                meanSquares[(size_t)ch] += rmsCoefficient * (sumSquares * inverseLength - meanSquares[(size_t)ch]);
+            }
+        });
+
+        auto& levels = buffer.getWriteBuffer();
+        levels.numChannels = numChannels;
+
+        for (size_t ch = 0; ch < (size_t)numChannels; ++ch)
+        {
+            levels.peak[ch] = peaks[ch];
+            levels.rms[ch] = std::sqrt(meanSquares[ch]);
+        }
+
+        buffer.publish();
+    }
+
+    // Called by the editor; copies the latest levels, returning whether they
+    // changed since the last call
+    bool read(Levels& levels)
+    {
+        if (!buffer.update())
+        {
+            return false;
+        }
+
+        levels = buffer.getReadBuffer();
+        return true;
+    }
+
+    // Peak and sum of squares of a block, with one accumulator per lane so
+    // that the loop vectorises without reordering float additions
+    static inline void measure(const float* data, int numSamples, float& peak, float& sumSquares)
+    {
+        constexpr int lanes = 8;
+        float lanePeaks[lanes] = {};
+        float laneSums[lanes] = {};
+        int i = 0;
+
+        for (; i + lanes <= numSamples; i += lanes)
+        {
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                const float sample = data[i + lane];
+                lanePeaks[lane] = std::max(lanePeaks[lane], std::abs(sample));
+                laneSums[lane] += sample * sample;
+            }
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            lanePeaks[0] = std::max(lanePeaks[0], std::abs(data[i]));
+            laneSums[0] += data[i] * data[i];
+        }
+
+        peak = 0.0f;
+        sumSquares = 0.0f;
+
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            peak = std::max(peak, lanePeaks[lane]);
+            sumSquares += laneSums[lane];
+        }
+    }
+
+private:
+    static constexpr float peakReleaseSeconds = 0.5f;
+    static constexpr float rmsSeconds = 0.3f;
+
+    TripleBuffer<Levels> buffer;
+    std::array<float, MAX_CHANS> peaks{};
+    std::array<float, MAX_CHANS> meanSquares{};
+    double currentSampleRate = 0.0;
+    CpuDispatch::Level isaLevel = CpuDispatch::Level::baseline;
+    int activeChannels = 0;
+};
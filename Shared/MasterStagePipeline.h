@@ -0,0 +1,375 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "CpuDispatch.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+// Runs the master stage of an engine on a helper thread, one block behind the
+// channel stage running on the audio thread, at the cost of exactly one
+// prepared block of latency. The engine must provide processChannelStage(),
+// processMasterStage(), setMasterParameters(), beginChannelStage(),
+// beginMasterStage() and getIsaLevel(), and its channel and master stages must
+// not share state.
+//
+// Host blocks are split into chunks of at most the prepared size, and the
+// results go through a FIFO primed with one block of silence, so the latency
+// stays the same whatever the size of the blocks the host sends.
+//
+// The helper thread only runs while setEnabled() is on, at realtime priority
+// where the system permits it. The hand-off is a single atomic state: the
+// audio thread never locks or makes a system call. It waits for the helper
+// for at most half a block, then runs a master stage the helper has not
+// started itself, still a block later, so the output is the same either way.
+// Between blocks the helper spins for a while, then backs off to short
+// sleeps, and once the host has stopped processing it parks on an event
+// until the message thread wakes it.
+template <typename Engine>
+class MasterStagePipeline : private juce::Thread
+{
+public:
+    explicit MasterStagePipeline(Engine& engineToUse) :
+        juce::Thread("Plug64 master stage"),
+        engine(engineToUse)
+    {
+    }
+
+    ~MasterStagePipeline() override
+    {
+        release();
+    }
+
+    // Allocates the buffers, not realtime safe; the helper thread is stopped
+    // until setEnabled() is called
+    void prepare(double sampleRate, int maxBlockSize, int numChannels)
+    {
+        release();
+
+        blockSize = std::max(maxBlockSize, 1);
+        channels = std::max(numChannels, 0);
+
+        blockMs = 1000.0 * (double)blockSize / std::max(sampleRate, 1.0);
+        waitNanos = (std::int64_t)(0.5e6 * blockMs);
+        parkNanos = std::max((std::int64_t)(4.0e6 * blockMs), (std::int64_t)50000000);
+
+        for (auto& stageBuffer : stageBuffers)
+        {
+            stageBuffer.setSize(channels, blockSize);
+        }
+
+        fifo.setSize(channels, 2 * blockSize);
+        reset();
+        prepared = true;
+    }
+
+    void release()
+    {
+        prepared = false;
+        stopHelper();
+        waitForMasterStage();
+    }
+
+    // Starts or stops the helper thread with the pipelined mode, and wakes it
+    // when the host processes again after it parked; called from the message
+    // thread, e.g. by a timer
+    void setEnabled(bool shouldRun)
+    {
+        if (!shouldRun || !prepared)
+        {
+            stopHelper();
+            return;
+        }
+
+        if (!isThreadRunning())
+        {
+            if (!startRealtimeThread(juce::Thread::RealtimeOptions{}.withMaximumProcessingTimeMs(blockMs)))
+            {
+                startThread(juce::Thread::Priority::highest);
+            }
+        }
+        else if (wakeRequested.exchange(false))
+        {
+            wakeUp.signal();
+        }
+    }
+
+    // Drops the block in flight and primes the FIFO with silence again
+    void reset()
+    {
+        waitForMasterStage();
+
+        fifo.clear();
+        fifoRead = 0;
+        fifoCount = blockSize;
+        pendingSamples = 0;
+    }
+
+    int getLatencySamples() const
+    {
+        return blockSize;
+    }
+
+    std::size_t getMemoryBytes() const
+    {
+        // Two stage buffers plus a FIFO of two blocks
+        return sizeof(*this) + 4 * (std::size_t)channels * (std::size_t)blockSize * sizeof(float);
+    }
+
+    // Processes numChannels buffers in place, delayed by getLatencySamples();
+    // numChannels must not exceed the channel count given to prepare()
+    void process(float* const* buffers, int numChannels, int numSamples, const typename Engine::StageParameters& master)
+    {
+        numChannels = std::min(numChannels, channels);
+
+        for (int offset = 0; offset < numSamples; offset += blockSize)
+        {
+            processChunk(buffers, numChannels, offset, std::min(blockSize, numSamples - offset), master);
+        }
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // The master stage handed over is pending until the helper thread or the
+    // audio thread claims it
+    enum State
+    {
+        idle,
+        pending,
+        running
+    };
+
+    Engine& engine;
+    std::array<juce::AudioBuffer<float>, 2> stageBuffers;
+    juce::AudioBuffer<float> fifo;
+    std::atomic<int> state{idle};
+    // True while the helper thread is parked or not running at all
+    std::atomic<bool> parked{true};
+    std::atomic<bool> wakeRequested{false};
+    juce::WaitableEvent wakeUp;
+    bool prepared = false;
+    double blockMs = 0.0;
+    std::int64_t waitNanos = 0;
+    std::int64_t parkNanos = 0;
+    int blockSize = 1;
+    int channels = 0;
+    int channelBuffer = 0;
+    int fifoRead = 0;
+    int fifoCount = 0;
+    int pendingChannels = 0;
+    int pendingSamples = 0;
+
+    void processChunk(float* const* buffers, int numChannels, int offset, int numSamples, const typename Engine::StageParameters& master)
+    {
+        auto& channelStage = stageBuffers.at((size_t)channelBuffer);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            channelStage.copyFrom(ch, 0, buffers[ch] + offset, numSamples);
+        }
+
+        // Channel stage of this chunk, while the helper thread may still be
+        // running the master stage of the previous one
+        engine.beginChannelStage(channelStage.getArrayOfReadPointers(), numChannels, numSamples);
+
+        CpuDispatch::run(engine.getIsaLevel(), [&]
+        {
+            for (unsigned int ch = 0; ch < (unsigned int)std::min(numChannels, MAX_CHANS); ++ch)
+            {
+                engine.processChannelStage(ch, channelStage.getWritePointer((int)ch), numSamples);
+            }
+        });
+
+        waitForMasterStage();
+        pushToFifo(stageBuffers.at((size_t)(channelBuffer ^ 1)), pendingChannels, pendingSamples);
+
+        // Hand this chunk over, the master parameters can be changed safely
+        // here since no thread is running the master stage
+        engine.setMasterParameters(master);
+        engine.beginMasterStage(numSamples);
+        pendingChannels = numChannels;
+        pendingSamples = numSamples;
+        channelBuffer ^= 1;
+        state.store(pending, std::memory_order_release);
+
+        popFromFifo(buffers, numChannels, offset, numSamples);
+    }
+
+    void runMasterStage()
+    {
+        auto& masterStage = stageBuffers.at((size_t)(channelBuffer ^ 1));
+
+        CpuDispatch::run(engine.getIsaLevel(), [&]
+        {
+            for (unsigned int ch = 0; ch < (unsigned int)std::min(pendingChannels, MAX_CHANS); ++ch)
+            {
+                engine.processMasterStage(ch, masterStage.getWritePointer((int)ch), pendingSamples);
+            }
+        });
+
+        state.store(idle, std::memory_order_release);
+    }
+
+    bool claim()
+    {
+        int expected = pending;
+        return state.compare_exchange_strong(expected, running, std::memory_order_acq_rel);
+    }
+
+    void run() override
+    {
+        parked = false;
+        auto lastBlock = Clock::now();
+        int idleRounds = 0;
+
+        while (!threadShouldExit())
+        {
+            if (claim())
+            {
+                runMasterStage();
+                lastBlock = Clock::now();
+                idleRounds = 0;
+                continue;
+            }
+
+            if (std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - lastBlock).count() < parkNanos)
+            {
+                backOff(idleRounds++);
+                continue;
+            }
+
+            // The host has stopped processing; the audio thread runs the
+            // master stages itself meanwhile
+            parked = true;
+            wakeUp.wait(-1);
+            parked = false;
+            lastBlock = Clock::now();
+            idleRounds = 0;
+        }
+
+        parked = true;
+    }
+
+    void stopHelper()
+    {
+        if (isThreadRunning())
+        {
+            signalThreadShouldExit();
+            wakeUp.signal();
+            stopThread(1000);
+        }
+
+        wakeRequested = false;
+    }
+
+    // Audio thread side: waits for the helper for at most half a block, or
+    // not at all while it is parked, then runs the master stage itself
+    // unless the helper has started it. A started one is waited for, since
+    // the helper finishes it within the block at its priority.
+    void waitForMasterStage()
+    {
+        const auto deadline = Clock::now() + std::chrono::nanoseconds(waitNanos);
+
+        while (state.load(std::memory_order_acquire) != idle)
+        {
+            const bool helperParked = parked.load();
+
+            if ((helperParked || Clock::now() >= deadline) && claim())
+            {
+                if (helperParked)
+                {
+                    wakeRequested = true;
+                }
+
+                runMasterStage();
+                return;
+            }
+
+            pause();
+        }
+    }
+
+    static void backOff(int idleRounds)
+    {
+        if (idleRounds < 20000)
+        {
+            pause();
+        }
+        else if (idleRounds < 21000)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    static inline void pause()
+    {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    // The FIFO holds exactly blockSize samples between a push and the next
+    // pop, so a chunk never exceeds either its free space or its content
+    void pushToFifo(const juce::AudioBuffer<float>& source, int numChannels, int numSamples)
+    {
+        const int capacity = fifo.getNumSamples();
+        const int write = (fifoRead + fifoCount) % capacity;
+        const int first = std::min(numSamples, capacity - write);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            fifo.copyFrom(ch, write, source, ch, 0, first);
+            fifo.copyFrom(ch, 0, source, ch, first, numSamples - first);
+        }
+
+        fifoCount += numSamples;
+    }
+
+    void popFromFifo(float* const* buffers, int numChannels, int offset, int numSamples)
+    {
+        const int capacity = fifo.getNumSamples();
+        const int first = std::min(numSamples, capacity - fifoRead);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* source = fifo.getReadPointer(ch);
+            std::copy(source + fifoRead, source + fifoRead + first, buffers[ch] + offset);
+            std::copy(source, source + numSamples - first, buffers[ch] + offset + first);
+        }
+
+        fifoRead = (fifoRead + numSamples) % capacity;
+        fifoCount -= numSamples;
+    }
+};
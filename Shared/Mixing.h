@@ -0,0 +1,125 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+
+// Block-wise wet/dry crossfades shared by the engines, with a constant mix
+// or a per-sample ramp (e.g. from a SmootherBank). The output may be the dry
+// or the wet buffer, for in-place processing. The loops are plain so that the
+// compiler vectorises them for the level CpuDispatch selected; the mixes are
+// clamped to [0, 1].
+//
+// The linear crossfade keeps the amplitude of correlated signals, the
+// equal-power one keeps the power of uncorrelated ones.
+struct Mixing
+{
+    // out = dry + mix * (wet - dry)
+    static void crossfade(float* out, const float* dry, const float* wet, float mix, int numSamples)
+    {
+        mix = std::clamp(mix, 0.0f, 1.0f);
+
+        if (mix <= 0.0f)
+        {
+            copy(out, dry, numSamples);
+            return;
+        }
+
+        if (mix >= 1.0f)
+        {
+            copy(out, wet, numSamples);
+            return;
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            out[i] = dry[i] + mix * (wet[i] - dry[i]);
+        }
+    }
+
+    static void crossfade(float* out, const float* dry, const float* wet, const float* mixes, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float mix = std::clamp(mixes[i], 0.0f, 1.0f);
+            out[i] = dry[i] + mix * (wet[i] - dry[i]);
+        }
+    }
+
+    // In place on the dry signal
+    static void crossfade(float* dryAndOut, const float* wet, float mix, int numSamples)
+    {
+        crossfade(dryAndOut, dryAndOut, wet, mix, numSamples);
+    }
+
+    static void crossfade(float* dryAndOut, const float* wet, const float* mixes, int numSamples)
+    {
+        crossfade(dryAndOut, dryAndOut, wet, mixes, numSamples);
+    }
+
+    // out = dry * cos(mix * pi / 2) + wet * sin(mix * pi / 2)
+    static void equalPowerCrossfade(float* out, const float* dry, const float* wet, float mix, int numSamples)
+    {
+        mix = std::clamp(mix, 0.0f, 1.0f);
+        const float dryGain = quarterSine(1.0f - mix);
+        const float wetGain = quarterSine(mix);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            out[i] = dry[i] * dryGain + wet[i] * wetGain;
+        }
+    }
+
+    static void equalPowerCrossfade(float* out, const float* dry, const float* wet, const float* mixes, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float mix = std::clamp(mixes[i], 0.0f, 1.0f);
+            out[i] = dry[i] * quarterSine(1.0f - mix) + wet[i] * quarterSine(mix);
+        }
+    }
+
+    static void equalPowerCrossfade(float* dryAndOut, const float* wet, float mix, int numSamples)
+    {
+        equalPowerCrossfade(dryAndOut, dryAndOut, wet, mix, numSamples);
+    }
+
+    static void equalPowerCrossfade(float* dryAndOut, const float* wet, const float* mixes, int numSamples)
+    {
+        equalPowerCrossfade(dryAndOut, dryAndOut, wet, mixes, numSamples);
+    }
+
+    // sin(x * pi / 2) for x in [0, 1], as an odd polynomial up to the ninth
+    // order (error below 4e-6) so that ramped gains vectorise
+    static inline float quarterSine(float x)
+    {
+        const float t = x * 1.57079632679f;
+        const float t2 = t * t;
+        return t * (1.0f + t2 * (-1.0f / 6.0f + t2 * (1.0f / 120.0f + t2 * (-1.0f / 5040.0f + t2 * (1.0f / 362880.0f)))));
+    }
+
+private:
+    static inline void copy(float* out, const float* source, int numSamples)
+    {
+        if (out != source)
+        {
+            std::copy(source, source + numSamples, out);
+        }
+    }
+};
@@ -0,0 +1,155 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+// Routing of the Ring64 channel stages: the stage of a channel can be
+// modulated by a weighted sum of input channels and internal sine
+// oscillators instead of its own modulator. Most channels take no route or
+// a handful, so the routes are kept as compressed rows, one per channel,
+// in fixed storage that can be copied to the audio thread without
+// allocating. The rows are evaluated block-wise by RingEngine.
+class ModulationMatrix
+{
+public:
+    static constexpr int maxRoutes = 256;
+    static constexpr int numOscillators = 4;
+
+    struct Route
+    {
+        // Modulated channel, from 0
+        int channel = 0;
+        // Input channel, from 0, or internal oscillator
+        int source = 0;
+        bool oscillator = false;
+        float weight = 1.0f;
+    };
+
+    // Source of a row entry: an input channel, or -1 - index for an
+    // oscillator
+    struct Entry
+    {
+        int source = 0;
+        float weight = 0.0f;
+    };
+
+    // Replaces the routes, given in any order. Routes to channels outside
+    // MAX_CHANS, to oscillators that do not exist or beyond maxRoutes are
+    // dropped, in which case false is returned.
+    bool setRoutes(const Route* routes, int numRoutes)
+    {
+        std::array<int, MAX_CHANS + 1> counts{};
+        bool complete = true;
+        numEntries = 0;
+
+        for (int i = 0; i < numRoutes; ++i)
+        {
+            if (isValid(routes[i]) && numEntries < maxRoutes)
+            {
+                ++counts.at((size_t)routes[i].channel + 1);
+                ++numEntries;
+            }
+            else
+            {
+                complete = false;
+            }
+        }
+
+        // Counting sort into the rows, keeping the order within each row
+        rowStart.fill(0);
+        for (size_t ch = 1; ch <= MAX_CHANS; ++ch)
+        {
+            rowStart.at(ch) = rowStart.at(ch - 1) + counts.at(ch);
+        }
+
+        std::array<int, MAX_CHANS> fill{};
+        int added = 0;
+
+        for (int i = 0; i < numRoutes && added < numEntries; ++i)
+        {
+            const auto& route = routes[i];
+
+            if (!isValid(route))
+            {
+                continue;
+            }
+
+            const auto ch = (size_t)route.channel;
+            auto& entry = entries.at((size_t)(rowStart.at(ch) + fill.at(ch)++));
+            entry.source = route.oscillator ? -1 - route.source : route.source;
+            entry.weight = route.weight;
+            ++added;
+        }
+
+        return complete;
+    }
+
+    void setOscillatorFrequency(int oscillator, float frequency)
+    {
+        oscillatorFrequencies.at((size_t)oscillator) = std::max(frequency, 0.0f);
+    }
+
+    float getOscillatorFrequency(int oscillator) const
+    {
+        return oscillatorFrequencies.at((size_t)oscillator);
+    }
+
+    int getNumRoutes() const
+    {
+        return numEntries;
+    }
+
+    // The routes, rebuilt from the rows, e.g. to store them
+    Route getRoute(int index) const
+    {
+        const auto& entry = entries.at((size_t)index);
+        const auto row = std::upper_bound(rowStart.begin(), rowStart.end(), index) - rowStart.begin() - 1;
+        const bool oscillator = entry.source < 0;
+
+        return {(int)row, oscillator ? -1 - entry.source : entry.source, oscillator, entry.weight};
+    }
+
+    bool hasRow(unsigned int ch) const
+    {
+        return rowStart.at(ch + 1) > rowStart.at(ch);
+    }
+
+    const Entry* rowBegin(unsigned int ch) const
+    {
+        return entries.data() + rowStart.at(ch);
+    }
+
+    const Entry* rowEnd(unsigned int ch) const
+    {
+        return entries.data() + rowStart.at(ch + 1);
+    }
+
+private:
+    // Row of each channel, from rowStart[ch] to rowStart[ch + 1]
+    std::array<int, MAX_CHANS + 1> rowStart{};
+    std::array<Entry, maxRoutes> entries{};
+    std::array<float, numOscillators> oscillatorFrequencies{{440.0f, 440.0f, 440.0f, 440.0f}};
+    int numEntries = 0;
+
+    static bool isValid(const Route& route)
+    {
+        return route.channel >= 0 && route.channel < MAX_CHANS && route.source >= 0 && (!route.oscillator || route.source < numOscillators);
+    }
+};
@@ -0,0 +1,187 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <array>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+// Field of a stage, e.g. the cutoff of a filter, from which the master and
+// channel parameters are generated
+struct ParameterSpec
+{
+    const char* id;
+    const char* name;
+    float start;
+    float end;
+    float interval;
+    float skew;
+    float masterDefault;
+    float chDefault;
+    // The channel parameters default to the number of their channel
+    bool chDefaultIsChannel = false;
+
+    juce::NormalisableRange<float> getRange() const
+    {
+        return juce::NormalisableRange<float>(start, end, interval, skew, false);
+    }
+};
+
+// Parameter tables of the stages, shared by the single plugins and Chain64.
+// The layouts are generated from them and the processors then take the
+// parameters back by index, in the order they were added, instead of
+// looking each one up by ID: with 257 parameters per instance, this is most
+// of the time spent constructing one.
+//
+// IDs are "master" or "ch" followed by the field and the channel number,
+// e.g. "mastertime" or "chcutoff12", prefixed by the stage in Chain64.
+struct ParameterTable
+{
+    using Layout = juce::AudioProcessorValueTreeState::ParameterLayout;
+
+    template <size_t N>
+    using Specs = std::array<ParameterSpec, N>;
+
+    // Master and per-channel parameters of a stage, the master first and then
+    // one entry per channel, with the fields in the order of the table
+    template <size_t N>
+    using StageParameters = std::array<std::array<juce::AudioParameterFloat*, N>, MAX_CHANS + 1>;
+
+    static constexpr Specs<1> gainSpecs
+    {{
+        {"gain", "Gain", -70.0f, 12.0f, 0.01f, 3.0f, 0.0f, 0.0f}
+    }};
+
+    static constexpr Specs<4> filterSpecs
+    {{
+        {"type", "Filter", 0.0f, 6.0f, 1.0f, 1.0f, 0.0f, 0.0f},
+        {"cutoff", "Cutoff", 20.0f, 20000.0f, 1.0f, 0.4f, 20000.0f, 20000.0f},
+        {"resonance", "Resonance", 0.0f, 100.0f, 0.1f, 1.0f, 5.0f, 5.0f},
+        {"drive", "Drive", 0.0f, 100.0f, 0.1f, 1.0f, 0.0f, 0.0f}
+    }};
+
+    static constexpr Specs<4> ringSpecs
+    {{
+        {"mod", "Modulator", 0.0f, 4.0f, 1.0f, 1.0f, 0.0f, 0.0f},
+        {"freq", "Frequency", 0.0f, 20000.0f, 1.0f, 1.0f, 440.0f, 440.0f},
+        {"modch", "Mod Channel", 1.0f, 64.0f, 1.0f, 1.0f, 1.0f, 0.0f, true},
+        {"wet", "Wet", 0.0f, 100.0f, 0.1f, 1.0f, 100.0f, 0.0f}
+    }};
+
+    // Ring64 only: whether the CH INPUT modulator of a stage reads the main
+    // input (0) or the sidechain (1)
+    static constexpr Specs<1> ringSourceSpecs
+    {{
+        {"modsrc", "Mod Source", 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f}
+    }};
+
+    static constexpr Specs<4> delaySpecs
+    {{
+        {"sync", "Sync", 0.0f, 16.0f, 1.0f, 1.0f, 0.0f, 0.0f},
+        {"time", "Time", 0.0f, 5000.0f, 1.0f, 1.0f, 1000.0f, 1000.0f},
+        {"feedback", "Feedback", 0.0f, 100.0f, 0.1f, 1.0f, 25.0f, 0.0f},
+        {"wet", "Wet", 0.0f, 100.0f, 0.1f, 1.0f, 25.0f, 0.0f}
+    }};
+
+    // "Master Cutoff", or "Filter Master Cutoff" with a stage name
+    template <size_t N>
+    static void addMaster(Layout& layout, const Specs<N>& specs, const juce::String& prefix = {}, const juce::String& stageName = {})
+    {
+        const auto namePrefix = stageName.isEmpty() ? juce::String("Master ") : stageName + " Master ";
+
+        for (const auto& spec : specs)
+        {
+            layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "master" + spec.id, namePrefix + spec.name, spec.getRange(), spec.masterDefault));
+        }
+    }
+
+    // Channel by channel, with the fields of each channel next to each other
+    template <size_t N>
+    static void addChannels(Layout& layout, const Specs<N>& specs, const juce::String& prefix = {}, const juce::String& stageName = {})
+    {
+        const auto namePrefix = stageName.isEmpty() ? juce::String("Channel ") : stageName + " Channel ";
+
+        for (int ch = 1; ch <= MAX_CHANS; ++ch)
+        {
+            const juce::String chString(ch);
+
+            for (const auto& spec : specs)
+            {
+                const float chDefault = spec.chDefaultIsChannel ? (float)ch : spec.chDefault;
+                layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "ch" + spec.id + chString, namePrefix + chString + " " + spec.name, spec.getRange(), chDefault));
+            }
+        }
+    }
+
+    template <size_t N>
+    static void addStage(Layout& layout, const Specs<N>& specs, const juce::String& prefix = {}, const juce::String& stageName = {})
+    {
+        addMaster(layout, specs, prefix, stageName);
+        addChannels(layout, specs, prefix, stageName);
+    }
+
+    // Takes the parameters of a processor in the order they were added to
+    // its layout
+    class Cursor
+    {
+    public:
+        explicit Cursor(const juce::AudioProcessor& processor) :
+            parameters(processor.getParameters())
+        {
+        }
+
+        juce::AudioParameterFloat* next()
+        {
+            auto* parameter = dynamic_cast<juce::AudioParameterFloat*>(parameters[index++]);
+            jassert(parameter != nullptr);
+            return parameter;
+        }
+
+        // The parameters added by addMaster()
+        template <size_t N>
+        void nextMaster(std::array<juce::AudioParameterFloat*, N>& master)
+        {
+            for (auto& parameter : master)
+            {
+                parameter = next();
+            }
+        }
+
+        // The parameters added by addChannels(), one array per channel
+        template <size_t N, size_t Size>
+        void nextChannels(std::array<std::array<juce::AudioParameterFloat*, N>, Size>& channels, size_t first = 0)
+        {
+            for (size_t ch = first; ch < first + MAX_CHANS; ++ch)
+            {
+                nextMaster(channels.at(ch));
+            }
+        }
+
+        // The parameters added by addStage()
+        template <size_t N>
+        void nextStage(StageParameters<N>& stage)
+        {
+            nextMaster(stage.at(0));
+            nextChannels(stage, 1);
+        }
+
+    private:
+        const juce::Array<juce::AudioProcessorParameter*>& parameters;
+        int index = 0;
+    };
+};
@@ -0,0 +1,654 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#ifndef PLUG64_CONTROL_INTERVAL
+#define PLUG64_CONTROL_INTERVAL 32
+#endif
+
+// Scenes of a processor, decoded in advance into snapshots of its parameter
+// values, so that switching to one needs no parsing nor allocation. A switch
+// publishes the snapshot with an atomic pointer: from the next block the
+// audio thread reads its values through a Reader, while the parameters are
+// set and the host notified, after which the snapshot is withdrawn. A slow
+// message thread delays what the host and the editor show, not the audio.
+// Bulk edits of the parameters go through the same path.
+//
+// Two presets can also be assigned as morph scenes A and B: the "morph"
+// parameter, when the processor has one, then interpolates the parameters
+// that differ between them, as read through a Reader, on the audio thread and
+// without touching the parameters themselves. Parameters marked as discrete
+// switch from A to B halfway instead. A morphed parameter that changes after
+// the scenes are assigned, through the host, the editor, a preset switch or
+// a bulk edit, leaves the morph until scenes are assigned again.
+//
+// Hosts with large buffers send automation once per block, so a block is
+// processed in steps of controlInterval samples when parameters changed
+// since the last one: the continuous ones move from their previous value to
+// the new one across the steps, and choices switch at the start. A block
+// where nothing changed is processed in one step.
+//
+// The bank is stored in the plugin state, as PRESET elements holding the
+// same PARAM elements as the parameter tree; parameters missing from a
+// preset take their default value.
+class PresetBank
+{
+public:
+    struct Preset
+    {
+        juce::String name;
+        // Denormalised values, in the order of the processor parameters
+        std::vector<float> values;
+    };
+
+    static constexpr const char* morphParameterID = "morph";
+
+    // Samples of a step of a block where parameters changed (the
+    // ControlInterval build option)
+    static constexpr int controlInterval = PLUG64_CONTROL_INTERVAL;
+
+    // Reads the parameter values on the audio thread: those of a state being
+    // restored, otherwise those of the preset being switched to, if any, or
+    // the current ones, overridden by the morph between the scenes, if
+    // assigned. With a step, reads those of that step of the block begun by
+    // beginRamp() instead. Only one Reader may exist at a time.
+    class Reader
+    {
+    public:
+        explicit Reader(PresetBank& bankToUse, int step = -1) :
+            bank(bankToUse)
+        {
+            bank.readers.fetch_add(1);
+            values = step >= 0 ? bank.getRampStep(step) : bank.resolveValues();
+        }
+
+        ~Reader()
+        {
+            bank.readers.fetch_sub(1);
+        }
+
+        float operator()(const juce::AudioParameterFloat* parameter) const
+        {
+            return values != nullptr ? bank.getValue(values, parameter) : parameter->get();
+        }
+
+    private:
+        PresetBank& bank;
+        const float* values = nullptr;
+
+        JUCE_DECLARE_NON_COPYABLE(Reader)
+    };
+
+    explicit PresetBank(juce::AudioProcessorValueTreeState& stateToUse)
+    {
+        for (auto* parameter : stateToUse.processor.getParameters())
+        {
+            auto* floatParameter = dynamic_cast<juce::AudioParameterFloat*>(parameter);
+            indices.push_back(floatParameter != nullptr ? (int)parameters.size() : -1);
+
+            if (floatParameter != nullptr)
+            {
+                parameters.push_back(floatParameter);
+
+                if (floatParameter->getParameterID() == morphParameterID)
+                {
+                    morphParameter = floatParameter;
+                }
+            }
+        }
+
+        rampStart.assign(parameters.size(), 0.0f);
+        rampEnd.assign(parameters.size(), 0.0f);
+        rampValues.assign(parameters.size(), 0.0f);
+        rampDiscrete.assign(parameters.size(), 0);
+        rampChanged.reserve(parameters.size());
+        morphValues.assign(parameters.size(), 0.0f);
+        morphAnchors.assign(parameters.size(), 0.0f);
+        morphReleased.assign(parameters.size(), 0);
+        editValues.assign(parameters.size(), 0.0f);
+        changedIndices.reserve(parameters.size());
+    }
+
+    // Marks a parameter holding a choice, which is not interpolated by the
+    // morph nor within a block; called by the processor constructor
+    void setDiscrete(const juce::AudioProcessorParameter* parameter)
+    {
+        if (const int index = indexOf(parameter); index >= 0)
+        {
+            discreteIndices.push_back(index);
+            rampDiscrete[(size_t)index] = 1;
+        }
+    }
+
+    int getNumPresets() const
+    {
+        return (int)presets.size();
+    }
+
+    // -1 until a preset is selected
+    int getCurrentIndex() const
+    {
+        return currentIndex;
+    }
+
+    juce::String getName(int index) const
+    {
+        return juce::isPositiveAndBelow(index, getNumPresets()) ? presets[(size_t)index]->name : juce::String();
+    }
+
+    void setName(int index, const juce::String& newName)
+    {
+        if (juce::isPositiveAndBelow(index, getNumPresets()))
+        {
+            presets[(size_t)index]->name = newName;
+        }
+    }
+
+    // When off, a switch jumps to the new values instead of ramping to them
+    // through the parameter smoothers
+    bool getCrossfade() const
+    {
+        return crossfade;
+    }
+
+    void setCrossfade(bool shouldCrossfade)
+    {
+        crossfade = shouldCrossfade;
+    }
+
+    int getMorphScene(int scene) const
+    {
+        return scene == 0 ? morphA : morphB;
+    }
+
+    // Assigns the presets morphed between, or stops morphing when either
+    // index is not a preset
+    void setMorphScenes(int indexA, int indexB)
+    {
+        std::unique_ptr<MorphScenes> newScenes;
+
+        if (juce::isPositiveAndBelow(indexA, getNumPresets()) && juce::isPositiveAndBelow(indexB, getNumPresets()))
+        {
+            newScenes = std::make_unique<MorphScenes>();
+            newScenes->id = ++lastScenesId;
+            newScenes->start = presets[(size_t)indexA]->values;
+            newScenes->delta = presets[(size_t)indexB]->values;
+
+            for (size_t i = 0; i < newScenes->delta.size(); ++i)
+            {
+                newScenes->delta[i] -= newScenes->start[i];
+
+                // The morph does not morph itself
+                if (juce::exactlyEqual(newScenes->delta[i], 0.0f) || parameters[i] == morphParameter)
+                {
+                    continue;
+                }
+
+                const bool discrete = std::find(discreteIndices.begin(), discreteIndices.end(), (int)i) != discreteIndices.end();
+                (discrete ? newScenes->discrete : newScenes->continuous).push_back(i);
+            }
+
+            morphA = indexA;
+            morphB = indexB;
+        }
+        else
+        {
+            morphA = -1;
+            morphB = -1;
+        }
+
+        morphScenes.store(newScenes.get());
+        waitForReaders();
+        currentScenes = std::move(newScenes);
+    }
+
+    // Denormalised values of all the parameters, in their order
+    std::vector<float> getCurrentValues() const
+    {
+        std::vector<float> values;
+        values.reserve(parameters.size());
+
+        for (const auto* parameter : parameters)
+        {
+            values.push_back(parameter->get());
+        }
+
+        return values;
+    }
+
+    // Index of a parameter in the values, or -1 if it is not in the bank
+    int indexOf(const juce::AudioProcessorParameter* parameter) const
+    {
+        const int index = parameter->getParameterIndex();
+        return juce::isPositiveAndBelow(index, (int)indices.size()) ? indices[(size_t)index] : -1;
+    }
+
+    juce::AudioParameterFloat* getParameter(int index) const
+    {
+        return parameters[(size_t)index];
+    }
+
+    // Stores the current parameter values as a new preset, which becomes the
+    // current one, returning its index
+    int add(const juce::String& name)
+    {
+        auto preset = std::make_unique<Preset>();
+        preset->name = name;
+        preset->values = getCurrentValues();
+
+        presets.push_back(std::move(preset));
+        currentIndex = getNumPresets() - 1;
+        return currentIndex;
+    }
+
+    // Values of all the parameters stored in PARAM elements, the way the
+    // parameter tree and the presets store them; safe to call from any thread
+    std::vector<float> decodeValues(const juce::XmlElement& xml) const
+    {
+        std::vector<float> values;
+        values.reserve(parameters.size());
+
+        for (const auto* parameter : parameters)
+        {
+            float value = parameter->convertFrom0to1(parameter->getDefaultValue());
+
+            if (const auto* parameterXml = xml.getChildByAttribute("id", parameter->getParameterID()))
+            {
+                value = (float)parameterXml->getDoubleAttribute("value", value);
+            }
+
+            values.push_back(parameter->getNormalisableRange().snapToLegalValue(value));
+        }
+
+        return values;
+    }
+
+    // Makes the audio thread jump to values (as returned by decodeValues()),
+    // until called again with nullptr once the parameters hold them; used by
+    // StateLoader. values must stay valid until the next call.
+    void restore(const float* values)
+    {
+        restoring.store(values);
+
+        if (values != nullptr)
+        {
+            jumpPending.store(true);
+        }
+
+        waitForReaders();
+    }
+
+    // Sets all the parameters to values (as returned by getCurrentValues())
+    // in one step, the same way a preset is switched to; used by BulkEdit and
+    // StateLoader
+    void apply(const std::vector<float>& values, bool jump = false)
+    {
+        if (values.size() != editValues.size())
+        {
+            return;
+        }
+
+        // A Reader may still be using the values of the last edit
+        waitForReaders();
+        std::copy(values.begin(), values.end(), editValues.begin());
+        publish(editValues.data(), jump);
+    }
+
+    // Switches to a preset; called from the message thread, or wherever the
+    // host calls setCurrentProgram()
+    void select(int index)
+    {
+        if (!juce::isPositiveAndBelow(index, getNumPresets()))
+        {
+            return;
+        }
+
+        currentIndex = index;
+        publish(presets[(size_t)index]->values.data(), !crossfade);
+    }
+
+    // Takes the values of the block to come and returns the number of steps
+    // to process it in, each read by a Reader of that step: 1 when no
+    // continuous parameter changed since the last block, or when the engines
+    // are to jump to the new values. Called on the audio thread.
+    int beginRamp(int numSamples)
+    {
+        std::swap(rampStart, rampEnd);
+
+        {
+            const Reader read(*this);
+
+            for (size_t i = 0; i < parameters.size(); ++i)
+            {
+                rampEnd[i] = read(parameters[i]);
+            }
+        }
+
+        std::copy(rampEnd.begin(), rampEnd.end(), rampValues.begin());
+        rampChanged.clear();
+
+        if (rampPrimed && restoring.load() == nullptr && !jumpPending.load())
+        {
+            for (size_t i = 0; i < parameters.size(); ++i)
+            {
+                if (rampDiscrete[i] == 0 && !juce::exactlyEqual(rampStart[i], rampEnd[i]))
+                {
+                    rampChanged.push_back(i);
+                }
+            }
+        }
+
+        rampPrimed = true;
+        rampSteps = rampChanged.empty() || controlInterval <= 0 ? 1 : std::max((numSamples + controlInterval - 1) / controlInterval, 1);
+        return rampSteps;
+    }
+
+    // Processes a block in the steps of beginRamp(): update(step) reads the
+    // parameters of each step through a Reader of that step, then
+    // render(channels, numChannels, numSamples) processes its samples, with
+    // the channels moved to its start
+    template <typename Update, typename Render>
+    void processSteps(float* const* channels, int numChannels, int numSamples, Update&& update, Render&& render)
+    {
+        const int numSteps = beginRamp(numSamples);
+
+        if (numSteps == 1)
+        {
+            update(0);
+            render(channels, numChannels, numSamples);
+            return;
+        }
+
+        std::array<float*, MAX_CHANS> stepChannels{};
+        numChannels = std::clamp(numChannels, 0, MAX_CHANS);
+
+        for (int start = 0, step = 0; start < numSamples; start += controlInterval, ++step)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                stepChannels[(size_t)ch] = channels[ch] + start;
+            }
+
+            update(step);
+            render(stepChannels.data(), numChannels, std::min(controlInterval, numSamples - start));
+        }
+    }
+
+    // Whether the engines should jump to the values of a preset just
+    // switched to; called on the audio thread after the parameters are read
+    bool takeJump()
+    {
+        return jumpPending.exchange(false);
+    }
+
+    void writeTo(juce::XmlElement& stateXml) const
+    {
+        auto* bankXml = stateXml.createNewChildElement(tagName);
+        bankXml->setAttribute("crossfade", crossfade ? 1 : 0);
+        bankXml->setAttribute("morpha", morphA);
+        bankXml->setAttribute("morphb", morphB);
+
+        for (const auto& preset : presets)
+        {
+            auto* presetXml = bankXml->createNewChildElement("PRESET");
+            presetXml->setAttribute("name", preset->name);
+
+            for (size_t i = 0; i < parameters.size(); ++i)
+            {
+                auto* parameterXml = presetXml->createNewChildElement("PARAM");
+                parameterXml->setAttribute("id", parameters[i]->getParameterID());
+                parameterXml->setAttribute("value", preset->values[i]);
+            }
+        }
+    }
+
+    // Replaces the bank with the one stored in stateXml, removing it from
+    // there so that it does not end up in the parameter tree
+    void readFrom(juce::XmlElement& stateXml)
+    {
+        std::vector<std::unique_ptr<Preset>> newPresets;
+        bool newCrossfade = true;
+        int newMorphA = -1;
+        int newMorphB = -1;
+
+        if (const auto* bankXml = stateXml.getChildByName(tagName))
+        {
+            newCrossfade = bankXml->getIntAttribute("crossfade", 1) != 0;
+            newMorphA = bankXml->getIntAttribute("morpha", -1);
+            newMorphB = bankXml->getIntAttribute("morphb", -1);
+
+            for (const auto* presetXml : bankXml->getChildWithTagNameIterator("PRESET"))
+            {
+                newPresets.push_back(decode(*presetXml));
+            }
+
+            stateXml.deleteAllChildElementsWithTagName(tagName);
+        }
+
+        // A Reader may still be using a preset taken before the last switch ended
+        waitForReaders();
+
+        presets = std::move(newPresets);
+        crossfade = newCrossfade;
+        currentIndex = -1;
+        setMorphScenes(newMorphA, newMorphB);
+    }
+
+private:
+    static constexpr const char* tagName = "PRESETS";
+
+    // Scene A, the difference to scene B, and the indices of the values that
+    // differ, interpolated or switched halfway
+    struct MorphScenes
+    {
+        int id = 0;
+        std::vector<float> start;
+        std::vector<float> delta;
+        std::vector<size_t> continuous;
+        std::vector<size_t> discrete;
+    };
+
+    std::vector<juce::AudioParameterFloat*> parameters;
+    // Index in the values of each processor parameter, -1 if not in the bank
+    std::vector<int> indices;
+    std::vector<std::unique_ptr<Preset>> presets;
+    // Values of the preset or edit being applied, and the copy of the last edit
+    std::atomic<const float*> switching{nullptr};
+    std::atomic<const float*> restoring{nullptr};
+    std::vector<float> editValues;
+    std::atomic<int> readers{0};
+    std::atomic<bool> jumpPending{false};
+    std::atomic<const MorphScenes*> morphScenes{nullptr};
+    std::unique_ptr<MorphScenes> currentScenes;
+    const juce::AudioParameterFloat* morphParameter = nullptr;
+    int lastScenesId = 0;
+    // Written by the Reader on the audio thread: the values read, those the
+    // morphed parameters had when the scenes were first read, and whether
+    // each has changed since
+    std::vector<float> morphValues;
+    std::vector<float> morphAnchors;
+    std::vector<char> morphReleased;
+    int anchoredScenesId = 0;
+    std::vector<int> discreteIndices;
+    // Values at the end of the last block and of this one, those of the step
+    // being read, and the continuous parameters that changed in between
+    std::vector<float> rampStart;
+    std::vector<float> rampEnd;
+    std::vector<float> rampValues;
+    std::vector<char> rampDiscrete;
+    std::vector<size_t> rampChanged;
+    int rampSteps = 1;
+    bool rampPrimed = false;
+    std::vector<size_t> changedIndices;
+    int currentIndex = -1;
+    int morphA = -1;
+    int morphB = -1;
+    bool crossfade = true;
+
+    float getValue(const float* values, const juce::AudioParameterFloat* parameter) const
+    {
+        const int index = indexOf(parameter);
+        return index >= 0 ? values[index] : parameter->get();
+    }
+
+    // The audio thread reads the new values from the next block, while the
+    // parameters that changed are set. Their gestures enclose the whole
+    // change, so that hosts can record it as one edit.
+    void publish(const float* values, bool jump)
+    {
+        switching.store(values);
+        jumpPending.store(jump);
+
+        changedIndices.clear();
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+        {
+            if (!juce::exactlyEqual(parameters[i]->convertTo0to1(values[i]), parameters[i]->getValue()))
+            {
+                changedIndices.push_back(i);
+            }
+        }
+
+        for (const auto i : changedIndices)
+        {
+            parameters[i]->beginChangeGesture();
+        }
+
+        for (const auto i : changedIndices)
+        {
+            parameters[i]->setValueNotifyingHost(parameters[i]->convertTo0to1(values[i]));
+        }
+
+        for (const auto i : changedIndices)
+        {
+            parameters[i]->endChangeGesture();
+        }
+
+        switching.store(nullptr);
+    }
+
+    // The values a Reader reads outside a ramp, nullptr for the current ones
+    const float* resolveValues()
+    {
+        if (const auto* restored = restoring.load())
+        {
+            return restored;
+        }
+
+        if (const auto* scenes = morphScenes.load())
+        {
+            return renderMorph(*scenes, switching.load());
+        }
+
+        return switching.load();
+    }
+
+    // Values of a step of the ramp, the changed ones interpolated up to the
+    // end of the step
+    const float* getRampStep(int step)
+    {
+        if (rampSteps > 1)
+        {
+            const float amount = (float)std::min(step + 1, rampSteps) / (float)rampSteps;
+
+            for (const auto i : rampChanged)
+            {
+                rampValues[i] = rampStart[i] + (rampEnd[i] - rampStart[i]) * amount;
+            }
+        }
+
+        return rampValues.data();
+    }
+
+    // The values switched to, or the current ones, with those of the morphed
+    // parameters that have not changed since the scenes were first read
+    // replaced by the morph
+    const float* renderMorph(const MorphScenes& scenes, const float* values)
+    {
+        const float amount = morphParameter != nullptr ? juce::jlimit(0.0f, 1.0f, morphParameter->get() * 0.01f) : 0.0f;
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+        {
+            morphValues[i] = values != nullptr ? values[i] : parameters[i]->get();
+        }
+
+        if (scenes.id != anchoredScenesId)
+        {
+            anchoredScenesId = scenes.id;
+            std::copy(morphValues.begin(), morphValues.end(), morphAnchors.begin());
+            std::fill(morphReleased.begin(), morphReleased.end(), 0);
+        }
+
+        for (const auto i : scenes.continuous)
+        {
+            if (morph(i))
+            {
+                morphValues[i] = scenes.start[i] + scenes.delta[i] * amount;
+            }
+        }
+
+        for (const auto i : scenes.discrete)
+        {
+            if (morph(i))
+            {
+                morphValues[i] = amount < 0.5f ? scenes.start[i] : scenes.start[i] + scenes.delta[i];
+            }
+        }
+
+        return morphValues.data();
+    }
+
+    // Whether the morph still drives the value at index, which it stops
+    // doing for good once the value changes
+    bool morph(size_t index)
+    {
+        if (morphReleased[index] == 0 && !juce::exactlyEqual(morphValues[index], morphAnchors[index]))
+        {
+            morphReleased[index] = 1;
+        }
+
+        return morphReleased[index] == 0;
+    }
+
+    void waitForReaders() const
+    {
+        while (readers.load() != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    std::unique_ptr<Preset> decode(const juce::XmlElement& presetXml) const
+    {
+        auto preset = std::make_unique<Preset>();
+        preset->name = presetXml.getStringAttribute("name");
+        preset->values = decodeValues(presetXml);
+
+        return preset;
+    }
+};
@@ -0,0 +1,131 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+// Quality tier of a plugin, set by its "Quality" parameter. Eco takes the
+// cheap path of each engine for live use, Standard the regular one and High
+// the most accurate one for renders, while Auto, the default, runs Standard
+// while playing and High while the host renders offline
+// (AudioProcessor::isNonRealtime()).
+struct QualityTier
+{
+    enum class Tier
+    {
+        eco,
+        standard,
+        high
+    };
+
+    static constexpr const char* parameterID = "quality";
+
+    // Auto, Eco, Standard or High, appended to the layouts after the other
+    // parameters so that their indices do not change
+    static std::unique_ptr<juce::AudioParameterFloat> createParameter()
+    {
+        return std::make_unique<juce::AudioParameterFloat>(parameterID, "Quality", juce::NormalisableRange<float>(0.0f, 3.0f, 1.0f), 0.0f);
+    }
+
+    static bool isAuto(const juce::AudioParameterFloat& parameter)
+    {
+        return juce::roundToInt(parameter.get()) <= 0;
+    }
+
+    // The tier of the parameter, Auto following offline rendering, lowered by
+    // stepsDown tiers (at most to Eco) by the CPU governor under overload
+    static Tier resolve(const juce::AudioParameterFloat& parameter, bool nonRealtime, int stepsDown = 0)
+    {
+        int tier = 0;
+
+        switch (juce::jlimit(0, 3, juce::roundToInt(parameter.get())))
+        {
+            case 1:
+                tier = (int)Tier::eco;
+                break;
+            case 2:
+                tier = (int)Tier::standard;
+                break;
+            case 3:
+                tier = (int)Tier::high;
+                break;
+            default:
+                tier = (int)(nonRealtime ? Tier::high : Tier::standard);
+                break;
+        }
+
+        return (Tier)std::max(tier - std::max(stepsDown, 0), (int)Tier::eco);
+    }
+
+    // The tier whose latency is reported to the host: Auto takes that of
+    // High whether rendering or not, so that the latency does not move when
+    // a render starts
+    static Tier resolveLatency(const juce::AudioParameterFloat& parameter)
+    {
+        return isAuto(parameter) ? Tier::high : resolve(parameter, false);
+    }
+
+    // Samples between the updates of a ramping delay time or modulator
+    // frequency: Eco steps them, the other tiers set them on every sample
+    static int getRampStride(Tier tier)
+    {
+        return tier == Tier::eco ? 16 : 1;
+    }
+
+    // Whether the delay lines and the oscillator modulators of the ring
+    // modulator run at half the host rate, halving their cost: Eco only
+    static bool runsAtHalfRate(Tier tier)
+    {
+        return tier == Tier::eco;
+    }
+
+    // The accurate paths of High: cubic interpolation of the delay lines,
+    // band-limited ring modulator oscillators and the exact saturation of the
+    // ladders
+    static bool interpolatesCubically(Tier tier)
+    {
+        return tier == Tier::high;
+    }
+
+    static bool usesPreciseOscillators(Tier tier)
+    {
+        return tier == Tier::high;
+    }
+
+    static bool usesExactSaturation(Tier tier)
+    {
+        return tier == Tier::high;
+    }
+
+    // Oversampling of the Filter64 ladders: Eco runs them at the host rate
+    // and High at 4x, while Standard follows the "Oversampling" parameter
+    static int getOversampling(Tier tier, int requested)
+    {
+        switch (tier)
+        {
+            case Tier::eco:
+                return 1;
+            case Tier::high:
+                return 4;
+            default:
+                return requested;
+        }
+    }
+};
@@ -0,0 +1,782 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <vector>
+#include "soutel/include/soutel/ringmod.h"
+#include "CpuDispatch.h"
+#include "Mixing.h"
+#include "ModulationMatrix.h"
+#include "RingOscillator.h"
+#include "SmootherBank.h"
+
+// DSP core of Ring64: a per-channel ring modulator followed by a master ring
+// modulator in series. With the CH INPUT modulator (mode 4) a stage is
+// modulated by another input channel, and with the modulation matrix
+// enabled the stage of a channel with a row is modulated by the weighted sum
+// of its sources instead. The input channels used as modulators are
+// snapshotted when they would be overwritten in place before being read,
+// and read where they are otherwise. Each stage chooses whether its CH INPUT
+// modulator reads the main input or the sidechain, which is read where it
+// is; without a sidechain set, every stage reads the main input.
+class RingEngine
+{
+public:
+    struct StageParameters
+    {
+        int mod = 0;
+        float freq = 440.0f;
+        int modCh = 1;
+        float wet = 0.0f;
+        // The CH INPUT modulator reads modCh of the sidechain
+        bool sidechain = false;
+    };
+
+    struct Parameters
+    {
+        StageParameters master{0, 440.0f, 1, 100.0f};
+        std::array<StageParameters, MAX_CHANS> channels;
+
+        Parameters()
+        {
+            for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+            {
+                channels.at(ch).modCh = (int)ch + 1;
+            }
+        }
+    };
+
+    void prepare(double sampleRate, int maxBlockSize, int numChannels, int numSidechainChannels = 0)
+    {
+        activeChannels = std::clamp(numChannels, 0, MAX_CHANS);
+        isaLevel = CpuDispatch::select();
+        inputChannels = std::max(numChannels, 0);
+        blockSize = std::max(maxBlockSize, 1);
+        // Two snapshot slots, so that a pipelined master stage can still read the
+        // inputs of the previous block while the next one is being snapshotted
+        inputCopy.assign(2 * (size_t)inputChannels * (size_t)blockSize, 0.0f);
+        channelSlot = 0;
+        masterSlot = 0;
+        snapshotChannels = 0;
+        sourceChannels.assign(2 * (size_t)inputChannels, nullptr);
+
+        // The sidechain is only copied for a pipelined master stage, which
+        // reads it a block later, once the host has reused its buffers
+        sidechainCapacity = std::clamp(numSidechainChannels, 0, MAX_CHANS);
+        sidechainCopy.assign(2 * (size_t)sidechainCapacity * (size_t)blockSize, 0.0f);
+        sidechainChannels.assign(2 * (size_t)sidechainCapacity, nullptr);
+        sidechainSlots.fill(false);
+        setSidechain(nullptr, 0);
+
+        // The matrix rows are summed into modulationData, from the inputs and
+        // the oscillators of the block
+        currentSampleRate = sampleRate;
+        modulationData.assign((size_t)blockSize, 0.0f);
+        oscillatorData.assign((size_t)ModulationMatrix::numOscillators * (size_t)blockSize, 0.0f);
+        oscillatorPhases.fill(0.0f);
+
+        for (unsigned int ch = 0; ch < (unsigned int)activeChannels; ++ch)
+        {
+            chRings.at(ch).set_sample_rate(static_cast<float>(sampleRate));
+            masterRings.at(ch).set_sample_rate(static_cast<float>(sampleRate));
+            chOscillators.at(ch).setSampleRate(sampleRate);
+            masterOscillators.at(ch).setSampleRate(sampleRate);
+            chOscillators.at(ch).reset();
+            masterOscillators.at(ch).reset();
+        }
+
+        // Frequencies and wet amounts, the channel rows first then the wet ones
+        channelSmoothers.prepare(2 * MAX_CHANS, blockSize, sampleRate, rampSeconds);
+        masterSmoothers.prepare(2, blockSize, sampleRate, rampSeconds);
+
+        // One scratch buffer per stage, since the pipelined stages run at once
+        channelWetData.assign((size_t)blockSize, 0.0f);
+        masterWetData.assign((size_t)blockSize, 0.0f);
+        chHalfRate.fill({});
+        masterHalfRate.fill({});
+
+        setParameters(parameters);
+        channelSmoothers.jumpToTargets();
+        masterSmoothers.jumpToTargets();
+    }
+
+    void setParameters(const Parameters& newParameters)
+    {
+        setChannelParameters(newParameters);
+        setMasterParameters(newParameters.master);
+    }
+
+    // The channel and master stages can be updated separately, so that one can
+    // be changed while the other is being processed on another thread
+    void setChannelParameters(const Parameters& newParameters)
+    {
+        parameters.channels = newParameters.channels;
+
+        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            setStage(chRings.at(ch), chOscillators.at(ch), parameters.channels.at(ch));
+            channelSmoothers.setTarget((int)ch, parameters.channels.at(ch).freq);
+            channelSmoothers.setTarget(MAX_CHANS + (int)ch, parameters.channels.at(ch).wet * 0.01f);
+        }
+    }
+
+    void setMasterParameters(const StageParameters& newMaster)
+    {
+        parameters.master = newMaster;
+
+        for (unsigned int ch = 0; ch < MAX_CHANS; ++ch)
+        {
+            setStage(masterRings.at(ch), masterOscillators.at(ch), parameters.master);
+        }
+
+        masterSmoothers.setTarget(0, parameters.master.freq);
+        masterSmoothers.setTarget(1, parameters.master.wet * 0.01f);
+    }
+
+    const Parameters& getParameters() const
+    {
+        return parameters;
+    }
+
+    // Copies the matrix, without allocating. Only the channel stages read
+    // it, so it is set with their parameters.
+    void setModulationMatrix(const ModulationMatrix& newMatrix)
+    {
+        matrix = newMatrix;
+    }
+
+    void setMatrixEnabled(bool enabled)
+    {
+        matrixEnabled = enabled;
+    }
+
+    // Channels the CH INPUT modulators read instead of the inputs, at most as
+    // many as given to prepare(), or nullptr to read the inputs again. They
+    // are read by the next process() call, or in order by the pipelined
+    // channel stages that follow, and must stay valid meanwhile.
+    void setSidechain(const float* const* channels, int numChannels)
+    {
+        sidechain = numChannels > 0 ? channels : nullptr;
+        sidechainSize = sidechain != nullptr ? std::min(numChannels, sidechainCapacity) : 0;
+        sidechainPosition = 0;
+    }
+
+    // Ends the parameter ramps, so that the next block starts at the targets
+    void jumpToTargets()
+    {
+        channelSmoothers.jumpToTargets();
+        masterSmoothers.jumpToTargets();
+    }
+
+    // A channel sleeps when its own stage is neutral (a zero wet amount);
+    // reported by the instance metrics
+    bool isChannelSleeping(unsigned int ch) const
+    {
+        return parameters.channels.at(ch).wet <= 0.0f;
+    }
+
+    int countSleepingChannels(int numChannels) const
+    {
+        int sleeping = 0;
+
+        for (unsigned int ch = 0; ch < (unsigned int)std::clamp(numChannels, 0, MAX_CHANS); ++ch)
+        {
+            sleeping += isChannelSleeping(ch) ? 1 : 0;
+        }
+
+        return sleeping;
+    }
+
+    // Samples between the updates of a ramping modulator frequency: larger
+    // strides step the frequency, which is cheaper, instead of setting it on
+    // every sample
+    void setRampStride(int samples)
+    {
+        rampStride.store(std::max(samples, 1), std::memory_order_relaxed);
+    }
+
+    int getRampStride() const
+    {
+        return rampStride.load(std::memory_order_relaxed);
+    }
+
+    // Runs the oscillator modulators once every two samples, at twice their
+    // frequency, and interpolates them, which halves their cost but limits
+    // them to a quarter of the sample rate. The CH INPUT and matrix
+    // modulators are read on every sample either way.
+    void setHalfRate(bool enabled)
+    {
+        halfRate.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool isHalfRate() const
+    {
+        return halfRate.load(std::memory_order_relaxed);
+    }
+
+    // Runs the oscillator modulators on RingOscillator, with an exact sine
+    // and a band-limited triangle, instead of the ring modulators of soutel;
+    // it takes precedence over the half rate. A switch restarts each
+    // modulator from the phase its other oscillator was left at.
+    void setPreciseOscillators(bool enabled)
+    {
+        preciseOscillators.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool isPreciseOscillators() const
+    {
+        return preciseOscillators.load(std::memory_order_relaxed);
+    }
+
+    // Instruction set of the kernels, selected in prepare(); the per-channel
+    // functions are the kernels and are meant to be called from a
+    // CpuDispatch::run() block, as process() does
+    CpuDispatch::Level getIsaLevel() const
+    {
+        return isaLevel;
+    }
+
+    std::size_t getMemoryBytes() const
+    {
+        return sizeof(*this) + (inputCopy.capacity() + channelWetData.capacity() + masterWetData.capacity()
+                                + modulationData.capacity() + oscillatorData.capacity()) * sizeof(float)
+            + sidechainCopy.capacity() * sizeof(float)
+            + (sourceChannels.capacity() + sidechainChannels.capacity()) * sizeof(const float*)
+            + channelSmoothers.getMemoryBytes() + masterSmoothers.getMemoryBytes();
+    }
+
+    // Processes numChannels buffers in place; channels above MAX_CHANS are left
+    // untouched but can still be used as modulators. numChannels must not exceed
+    // the channel count given to prepare(), while blocks longer than the prepared
+    // size are split internally.
+    void process(float* const* channels, int numChannels, int numSamples)
+    {
+        CpuDispatch::run(isaLevel, [&]
+        {
+            for (int offset = 0; offset < numSamples; offset += blockSize)
+            {
+                const int chunk = std::min(blockSize, numSamples - offset);
+
+                snapshotInputs(channels, numChannels, offset, chunk);
+                advanceSmoothers(chunk);
+
+                for (unsigned int ch = 0; ch < (unsigned int)std::min(snapshotChannels, activeChannels); ++ch)
+                {
+                    processChannel(ch, channels[ch] + offset, chunk);
+                }
+            }
+        });
+
+        sidechainPosition += numSamples;
+    }
+
+    // Takes the modulators of numSamples (at most the prepared block size)
+    // from startSample, so that they read the unprocessed signal even when the
+    // buffers are overwritten in place by processChannel(). Only the channels
+    // some stage reads are taken, and only those processChannel() overwrites
+    // before their last reader are copied; the others are read where they
+    // are, so the buffers must stay valid until the channels are processed.
+    void snapshotInputs(const float* const* channels, int numChannels, int startSample, int numSamples)
+    {
+        snapshotChannels = std::min(numChannels, inputChannels);
+        const float** sources = sourceChannels.data() + (size_t)channelSlot * (size_t)inputChannels;
+        std::fill(sources, sources + inputChannels, nullptr);
+
+        // Last channel whose stages read each processed channel, -1 if none
+        std::array<int, MAX_CHANS> lastReaders;
+        lastReaders.fill(-1);
+
+        auto take = [&](int ch, int reader)
+        {
+            if (ch < 0 || ch >= snapshotChannels)
+            {
+                return;
+            }
+
+            if (ch < activeChannels)
+            {
+                lastReaders.at((size_t)ch) = std::max(lastReaders.at((size_t)ch), reader);
+            }
+            else
+            {
+                sources[ch] = channels[ch] + startSample;
+            }
+        };
+
+        for (unsigned int ch = 0; ch < (unsigned int)activeChannels; ++ch)
+        {
+            if (usesMatrix(ch))
+            {
+                for (const auto* entry = matrix.rowBegin(ch); entry != matrix.rowEnd(ch); ++entry)
+                {
+                    take(entry->source, (int)ch);
+                }
+            }
+            else if (parameters.channels.at(ch).mod == 4 && !readsSidechain(parameters.channels.at(ch)))
+            {
+                take(parameters.channels.at(ch).modCh - 1, (int)ch);
+            }
+        }
+
+        // The master stage of every channel reads its modulator
+        if (parameters.master.mod == 4 && !readsSidechain(parameters.master))
+        {
+            take(parameters.master.modCh - 1, activeChannels - 1);
+        }
+
+        // The channels are processed in ascending order, so a channel read
+        // only by those before it is read before it is overwritten
+        for (int ch = 0; ch < std::min(activeChannels, snapshotChannels); ++ch)
+        {
+            const int lastReader = lastReaders.at((size_t)ch);
+
+            if (lastReader >= ch)
+            {
+                std::copy(channels[ch] + startSample, channels[ch] + startSample + numSamples, snapshotData(channelSlot, ch));
+                sources[ch] = snapshotData(channelSlot, ch);
+            }
+            else if (lastReader >= 0)
+            {
+                sources[ch] = channels[ch] + startSample;
+            }
+        }
+
+        // The sidechain is never overwritten, so it is read where it is
+        const float** sidechainSources = sidechainChannels.data() + (size_t)channelSlot * (size_t)sidechainCapacity;
+        std::fill(sidechainSources, sidechainSources + sidechainCapacity, nullptr);
+        sidechainSlots.at((size_t)channelSlot) = sidechain != nullptr;
+
+        for (int ch = 0; ch < sidechainSize; ++ch)
+        {
+            sidechainSources[ch] = sidechain[ch] + sidechainPosition + startSample;
+        }
+
+        renderOscillators(numSamples);
+    }
+
+    // Renders the parameter ramps of the next numSamples, at most the prepared
+    // block size, for the processChannel() calls that follow
+    void advanceSmoothers(int numSamples)
+    {
+        channelSmoothers.render(2 * MAX_CHANS, numSamples);
+        masterSmoothers.render(2, numSamples);
+    }
+
+    // Processes the samples matching the last snapshotInputs() and
+    // advanceSmoothers() calls
+    void processChannel(unsigned int ch, float* channelData, int numSamples)
+    {
+        const float* masterModData = modulatorChannel(parameters.master, channelSlot);
+
+        processChannelStage(ch, channelData, numSamples);
+        processStage(masterRings.at(ch), masterOscillators.at(ch), masterHalfRate.at(ch), masterModData, masterSmoothers, 0, 1, masterWetData.data(), channelData, numSamples);
+    }
+
+    void processChannelStage(unsigned int ch, float* channelData, int numSamples)
+    {
+        if (usesMatrix(ch))
+        {
+            processMatrixStage(evaluateRow(ch, numSamples), channelSmoothers, MAX_CHANS + (int)ch, channelWetData.data(), channelData, numSamples);
+            return;
+        }
+
+        const float* chModData = modulatorChannel(parameters.channels.at(ch), channelSlot);
+        processStage(chRings.at(ch), chOscillators.at(ch), chHalfRate.at(ch), chModData, channelSmoothers, (int)ch, MAX_CHANS + (int)ch, channelWetData.data(), channelData, numSamples);
+    }
+
+    // Reads its modulators from the snapshot handed over by beginMasterStage()
+    void processMasterStage(unsigned int ch, float* channelData, int numSamples)
+    {
+        const float* masterModData = modulatorChannel(parameters.master, masterSlot);
+        processStage(masterRings.at(ch), masterOscillators.at(ch), masterHalfRate.at(ch), masterModData, masterSmoothers, 0, 1, masterWetData.data(), channelData, numSamples);
+    }
+
+    // Hooks for MasterStagePipeline: the channel stage snapshots the unprocessed
+    // block, then the snapshot is handed over to the master stage and the next
+    // block is written to the other slot. Each stage renders its own ramps.
+    // Every channel is copied here, since the master stage reads them a block
+    // later and its modulator may change on the other thread meanwhile.
+    void beginChannelStage(const float* const* channels, int numChannels, int numSamples)
+    {
+        snapshotChannels = std::min(numChannels, inputChannels);
+        const float** sources = sourceChannels.data() + (size_t)channelSlot * (size_t)inputChannels;
+        std::fill(sources, sources + inputChannels, nullptr);
+
+        for (int ch = 0; ch < snapshotChannels; ++ch)
+        {
+            std::copy(channels[ch], channels[ch] + numSamples, snapshotData(channelSlot, ch));
+            sources[ch] = snapshotData(channelSlot, ch);
+        }
+
+        const float** sidechainSources = sidechainChannels.data() + (size_t)channelSlot * (size_t)sidechainCapacity;
+        std::fill(sidechainSources, sidechainSources + sidechainCapacity, nullptr);
+        sidechainSlots.at((size_t)channelSlot) = sidechain != nullptr;
+
+        for (int ch = 0; ch < sidechainSize; ++ch)
+        {
+            float* copy = sidechainCopy.data() + ((size_t)channelSlot * (size_t)sidechainCapacity + (size_t)ch) * (size_t)blockSize;
+            std::copy(sidechain[ch] + sidechainPosition, sidechain[ch] + sidechainPosition + numSamples, copy);
+            sidechainSources[ch] = copy;
+        }
+
+        sidechainPosition += numSamples;
+        renderOscillators(numSamples);
+        channelSmoothers.render(2 * MAX_CHANS, numSamples);
+    }
+
+    void beginMasterStage(int numSamples)
+    {
+        masterSlot = channelSlot;
+        channelSlot ^= 1;
+        masterSmoothers.render(2, numSamples);
+    }
+
+private:
+    static constexpr double rampSeconds = 0.05;
+
+    // An oscillator modulator at half rate: its last two values, as gains of
+    // the input, interpolated between
+    struct HalfRateModulator
+    {
+        float previous = 0.0f;
+        float current = 0.0f;
+        bool odd = false;
+        bool active = false;
+    };
+
+    std::array<soutel::RingMod<float>, MAX_CHANS> chRings;
+    std::array<soutel::RingMod<float>, MAX_CHANS> masterRings;
+    std::array<HalfRateModulator, MAX_CHANS> chHalfRate;
+    std::array<HalfRateModulator, MAX_CHANS> masterHalfRate;
+    std::array<RingOscillator, MAX_CHANS> chOscillators;
+    std::array<RingOscillator, MAX_CHANS> masterOscillators;
+    Parameters parameters;
+    std::vector<float> inputCopy;
+    SmootherBank channelSmoothers;
+    SmootherBank masterSmoothers;
+    std::vector<float> channelWetData;
+    std::vector<float> masterWetData;
+    // Modulator of each input channel per slot, in the snapshot or in place,
+    // nullptr when no stage reads it
+    std::vector<const float*> sourceChannels;
+    // The same for the sidechain channels, and whether each slot has a
+    // sidechain for the stages that choose it
+    std::vector<const float*> sidechainChannels;
+    std::vector<float> sidechainCopy;
+    std::array<bool, 2> sidechainSlots{};
+    const float* const* sidechain = nullptr;
+    int sidechainCapacity = 0;
+    int sidechainSize = 0;
+    int sidechainPosition = 0;
+    ModulationMatrix matrix;
+    std::vector<float> modulationData;
+    std::vector<float> oscillatorData;
+    std::array<float, ModulationMatrix::numOscillators> oscillatorPhases{};
+    double currentSampleRate = 44100.0;
+    bool matrixEnabled = false;
+    CpuDispatch::Level isaLevel = CpuDispatch::Level::baseline;
+    int activeChannels = 0;
+    int inputChannels = 0;
+    int snapshotChannels = 0;
+    int channelSlot = 0;
+    int masterSlot = 0;
+    int blockSize = 1;
+    // Also read by the master stage, which may run on the pipeline thread
+    std::atomic<int> rampStride{1};
+    std::atomic<bool> halfRate{false};
+    std::atomic<bool> preciseOscillators{false};
+
+    inline float* snapshotData(int slot, int ch)
+    {
+        return inputCopy.data() + ((size_t)slot * (size_t)inputChannels + (size_t)ch) * (size_t)blockSize;
+    }
+
+    inline const float* sourceData(int slot, int ch) const
+    {
+        return ch >= 0 && ch < inputChannels ? sourceChannels[(size_t)slot * (size_t)inputChannels + (size_t)ch] : nullptr;
+    }
+
+    inline const float* sidechainData(int slot, int ch) const
+    {
+        return ch >= 0 && ch < sidechainCapacity ? sidechainChannels[(size_t)slot * (size_t)sidechainCapacity + (size_t)ch] : nullptr;
+    }
+
+    inline const float* modulatorChannel(const StageParameters& stage, int slot) const
+    {
+        if (stage.mod != 4)
+        {
+            return nullptr;
+        }
+
+        return stage.sidechain && sidechainSlots.at((size_t)slot) ? sidechainData(slot, stage.modCh - 1) : sourceData(slot, stage.modCh - 1);
+    }
+
+    inline bool readsSidechain(const StageParameters& stage) const
+    {
+        return stage.sidechain && sidechain != nullptr;
+    }
+
+    inline bool usesMatrix(unsigned int ch) const
+    {
+        return matrixEnabled && matrix.hasRow(ch);
+    }
+
+    // The oscillators some row reads, as sines from a folded phase so that
+    // each one is a single vectorisable loop
+    void renderOscillators(int numSamples)
+    {
+        if (!matrixEnabled)
+        {
+            return;
+        }
+
+        std::array<bool, ModulationMatrix::numOscillators> used{};
+
+        for (unsigned int ch = 0; ch < (unsigned int)activeChannels; ++ch)
+        {
+            for (const auto* entry = matrix.rowBegin(ch); entry != matrix.rowEnd(ch); ++entry)
+            {
+                if (entry->source < 0)
+                {
+                    used.at((size_t)(-1 - entry->source)) = true;
+                }
+            }
+        }
+
+        for (int oscillator = 0; oscillator < ModulationMatrix::numOscillators; ++oscillator)
+        {
+            if (!used.at((size_t)oscillator))
+            {
+                continue;
+            }
+
+            float* output = oscillatorData.data() + (size_t)oscillator * (size_t)blockSize;
+            const float increment = (float)(matrix.getOscillatorFrequency(oscillator) / currentSampleRate);
+            const float start = oscillatorPhases.at((size_t)oscillator);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                // A triangle from -1 to 1, peaking a quarter of the way through
+                // the cycle, bent into a sine
+                float phase = start + 0.75f + (float)i * increment;
+                phase -= std::floor(phase);
+                output[i] = Mixing::quarterSine(2.0f * std::abs(2.0f * phase - 1.0f) - 1.0f);
+            }
+
+            const float end = start + (float)numSamples * increment;
+            oscillatorPhases.at((size_t)oscillator) = end - std::floor(end);
+        }
+    }
+
+    // Sums the sources of the row of a channel into modulationData, one
+    // block-wise pass per source
+    const float* evaluateRow(unsigned int ch, int numSamples)
+    {
+        float* sum = modulationData.data();
+        std::fill(sum, sum + numSamples, 0.0f);
+
+        for (const auto* entry = matrix.rowBegin(ch); entry != matrix.rowEnd(ch); ++entry)
+        {
+            const float* source = entry->source < 0 ? oscillatorData.data() + (size_t)(-1 - entry->source) * (size_t)blockSize
+                                                    : sourceData(channelSlot, entry->source);
+
+            if (source == nullptr)
+            {
+                continue;
+            }
+
+            const float weight = entry->weight;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                sum[i] += weight * source[i];
+            }
+        }
+
+        return sum;
+    }
+
+    // The ring modulated signal goes through wetData, then is mixed in by
+    // block. While the frequency ramps, it is set every rampStride samples;
+    // once settled, once per block
+    void processStage(soutel::RingMod<float>& ring, RingOscillator& oscillator, HalfRateModulator& modulator, const float* modData, const SmootherBank& smoothers,
+                      int freqRow, int wetRow, float* wetData, float* channelData, int numSamples) const
+    {
+        const int stride = getRampStride();
+        const bool precise = modData == nullptr && isPreciseOscillators() && oscillator.isUsed();
+        const bool half = modData == nullptr && isHalfRate() && !precise;
+
+        // At half rate the oscillator advances once per two samples
+        const float freqScale = half ? 2.0f : 1.0f;
+
+        auto run = [&](float freq, int start, int length)
+        {
+            if (precise)
+            {
+                oscillator.setFrequency(freq);
+                oscillator.process(channelData + start, wetData + start, length);
+                modulator.active = false;
+                return;
+            }
+
+            ring.set_frequency(freq * freqScale);
+            runRing(ring, modulator, half, modData != nullptr ? modData + start : nullptr, channelData + start, wetData + start, length);
+        };
+
+        if (const float* freqs = smoothers.getRamp(freqRow))
+        {
+            for (auto start = 0; start < numSamples; start += stride)
+            {
+                run(freqs[start], start, std::min(stride, numSamples - start));
+            }
+        }
+        else
+        {
+            run(smoothers.getCurrentValue(freqRow), 0, numSamples);
+        }
+
+        mixWet(smoothers, wetRow, wetData, channelData, numSamples);
+    }
+
+    // Runs the ring modulator over numSamples, with the oscillator at the host
+    // rate or at half of it. Ring modulation is linear in the input, so a
+    // unit input gives the gain the oscillator applies.
+    static void runRing(soutel::RingMod<float>& ring, HalfRateModulator& modulator, bool half, const float* modData,
+                        const float* input, float* output, int numSamples)
+    {
+        if (!half)
+        {
+            for (auto i = 0; i < numSamples; ++i)
+            {
+                output[i] = ring.run(input[i], modData != nullptr ? modData[i] : 0.0f);
+            }
+
+            modulator.active = false;
+            return;
+        }
+
+        if (!modulator.active)
+        {
+            modulator.current = ring.run(1.0f, 0.0f);
+            modulator.previous = modulator.current;
+            modulator.odd = false;
+            modulator.active = true;
+        }
+
+        auto firstOfPair = [&](int i)
+        {
+            output[i] = input[i] * 0.5f * (modulator.previous + modulator.current);
+        };
+
+        auto secondOfPair = [&](int i)
+        {
+            modulator.previous = modulator.current;
+            modulator.current = ring.run(1.0f, 0.0f);
+            output[i] = input[i] * modulator.previous;
+        };
+
+        auto i = 0;
+
+        if (modulator.odd && numSamples > 0)
+        {
+            secondOfPair(i++);
+        }
+
+        for (; i + 1 < numSamples; i += 2)
+        {
+            firstOfPair(i);
+            secondOfPair(i + 1);
+        }
+
+        modulator.odd = i < numSamples;
+
+        if (modulator.odd)
+        {
+            firstOfPair(i);
+        }
+    }
+
+    // Ring modulation by the summed sources of a matrix row
+    static void processMatrixStage(const float* modData, const SmootherBank& smoothers, int wetRow,
+                                   float* wetData, float* channelData, int numSamples)
+    {
+        for (auto i = 0; i < numSamples; ++i)
+        {
+            wetData[i] = channelData[i] * modData[i];
+        }
+
+        mixWet(smoothers, wetRow, wetData, channelData, numSamples);
+    }
+
+    static void mixWet(const SmootherBank& smoothers, int wetRow, const float* wetData, float* channelData, int numSamples)
+    {
+        if (const float* wets = smoothers.getRamp(wetRow))
+        {
+            Mixing::crossfade(channelData, wetData, wets, numSamples);
+        }
+        else
+        {
+            Mixing::crossfade(channelData, wetData, smoothers.getCurrentValue(wetRow), numSamples);
+        }
+    }
+
+    static inline void setStage(soutel::RingMod<float>& ring, RingOscillator& oscillator, const StageParameters& stage)
+    {
+        soutel::RModulators modulator = soutel::RModulators::oscillator;
+        soutel::BLWaveforms waveform = soutel::BLWaveforms::sine;
+        bool am = false;
+
+        switch (stage.mod)
+        {
+            case 0:
+                modulator = soutel::RModulators::oscillator;
+                waveform = soutel::BLWaveforms::sine;
+                break;
+            case 1:
+                modulator = soutel::RModulators::oscillator;
+                waveform = soutel::BLWaveforms::triangle;
+                break;
+            case 2:
+                modulator = soutel::RModulators::oscillator;
+                waveform = soutel::BLWaveforms::sine;
+                am = true;
+                break;
+            case 3:
+                modulator = soutel::RModulators::oscillator;
+                waveform = soutel::BLWaveforms::triangle;
+                am = true;
+                break;
+            case 4:
+                modulator = soutel::RModulators::input;
+                break;
+        }
+
+        ring.set_modulator(modulator);
+        ring.set_modulator_wave(waveform);
+        ring.set_am(am);
+
+        oscillator.setUsed(modulator == soutel::RModulators::oscillator);
+        oscillator.setWaveform(waveform == soutel::BLWaveforms::triangle ? RingOscillator::Waveform::triangle : RingOscillator::Waveform::sine);
+        oscillator.setAm(am);
+    }
+};
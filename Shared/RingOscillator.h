@@ -0,0 +1,150 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <cmath>
+#include <juce_core/juce_core.h>
+
+// The oscillator modulators of the ring modulators at the High quality tier:
+// the sine is computed exactly from a double precision phase, and the
+// triangle has its corners rounded off by PolyBLAMP residuals (the
+// integrated PolyBLEP), which removes most of the aliasing of a naive
+// triangle at high frequencies. Both start at zero and rise, the triangle
+// peaking a quarter of the way through the cycle. In AM the modulator is
+// moved to [0, 1].
+class RingOscillator
+{
+public:
+    enum class Waveform
+    {
+        sine,
+        triangle
+    };
+
+    void setSampleRate(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        setFrequency(frequency);
+    }
+
+    // At most half the sample rate
+    void setFrequency(float hz)
+    {
+        frequency = hz;
+        increment = juce::jlimit(0.0, 0.5, (double)hz / sampleRate);
+    }
+
+    void setWaveform(Waveform newWaveform)
+    {
+        waveform = newWaveform;
+    }
+
+    void setAm(bool enabled)
+    {
+        am = enabled;
+    }
+
+    void reset()
+    {
+        phase = 0.0;
+    }
+
+    // Whether the stage is modulated by the oscillator, rather than by an
+    // input channel
+    void setUsed(bool shouldBeUsed)
+    {
+        used = shouldBeUsed;
+    }
+
+    bool isUsed() const
+    {
+        return used;
+    }
+
+    // output = input * modulator, over numSamples
+    void process(const float* input, float* output, int numSamples)
+    {
+        if (waveform == Waveform::sine)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                output[i] = input[i] * shape((float)std::sin(juce::MathConstants<double>::twoPi * advance()));
+            }
+
+            return;
+        }
+
+        const float slopeChange = 8.0f * (float)increment;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Peak at 0 and trough at a half of this phase
+            double peakPhase = advance() + 0.75;
+            peakPhase -= peakPhase >= 1.0 ? 1.0 : 0.0;
+            double troughPhase = peakPhase + 0.5;
+            troughPhase -= troughPhase >= 1.0 ? 1.0 : 0.0;
+
+            const float naive = 2.0f * std::abs(2.0f * (float)peakPhase - 1.0f) - 1.0f;
+            const float rounded = naive + slopeChange * (blamp(troughPhase) - blamp(peakPhase));
+            output[i] = input[i] * shape(rounded);
+        }
+    }
+
+private:
+    double sampleRate = 44100.0;
+    double phase = 0.0;
+    double increment = 0.0;
+    float frequency = 0.0f;
+    Waveform waveform = Waveform::sine;
+    bool am = false;
+    bool used = true;
+
+    // The phase of this sample, moving on to the next
+    inline double advance()
+    {
+        const double current = phase;
+        phase += increment;
+        phase -= phase >= 1.0 ? 1.0 : 0.0;
+        return current;
+    }
+
+    inline float shape(float value) const
+    {
+        return am ? 0.5f * (value + 1.0f) : value;
+    }
+
+    // Residual of a corner at phase zero, for a change of slope of one per
+    // sample, within a sample on either side of it
+    inline float blamp(double cornerPhase) const
+    {
+        double distance = 1.0;
+
+        if (cornerPhase < increment)
+        {
+            distance = cornerPhase / increment;
+        }
+        else if (cornerPhase > 1.0 - increment)
+        {
+            distance = (1.0 - cornerPhase) / increment;
+        }
+
+        const float remaining = 1.0f - (float)distance;
+        return remaining * remaining * remaining * (1.0f / 6.0f);
+    }
+};
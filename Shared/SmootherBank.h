@@ -0,0 +1,224 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <juce_core/juce_core.h>
+
+// Linear parameter smoothers for many channels, stored as separate arrays of
+// current values, targets, steps and remaining samples. render() advances all
+// of them by a block at once and writes the ramps of the ones that are moving
+// into contiguous rows, computed in closed form so that every row is a single
+// vectorisable loop; settled smoothers are skipped through a bit mask and hold
+// a constant value. Like juce::SmoothedValue in linear mode, a new target is
+// reached in the ramp length from the current value.
+class SmootherBank
+{
+public:
+    // Allocates the ramps and zeroes every smoother, not realtime safe; the
+    // initial values are then given with setCurrentAndTarget()
+    void prepare(int numSmoothers, int maxBlockSize, double sampleRate, double rampSeconds)
+    {
+        size = std::max(numSmoothers, 0);
+        blockSize = std::max(maxBlockSize, 1);
+        rampLength = (int)std::floor(rampSeconds * sampleRate);
+
+        current.assign((size_t)size, 0.0f);
+        target.assign((size_t)size, 0.0f);
+        step.assign((size_t)size, 0.0f);
+        remaining.assign((size_t)size, 0);
+        activeMask.assign(((size_t)size + 63) / 64, 0);
+        rampMask.assign(activeMask.size(), 0);
+        ramps.assign((size_t)size * (size_t)blockSize, 0.0f);
+    }
+
+    // Ignored before prepare(), which is expected to be followed by the
+    // initial values
+    void setTarget(int index, float value)
+    {
+        const auto i = (size_t)index;
+
+        if (index >= size || juce::exactlyEqual(target[i], value))
+        {
+            return;
+        }
+
+        if (rampLength <= 0)
+        {
+            setCurrentAndTarget(index, value);
+            return;
+        }
+
+        target[i] = value;
+        remaining[i] = rampLength;
+        step[i] = (value - current[i]) / (float)rampLength;
+        activeMask[i / 64] |= bit(i);
+    }
+
+    // Jumps to the value, e.g. when the processing is reset
+    void setCurrentAndTarget(int index, float value)
+    {
+        const auto i = (size_t)index;
+
+        if (index >= size)
+        {
+            return;
+        }
+
+        current[i] = value;
+        target[i] = value;
+        remaining[i] = 0;
+        activeMask[i / 64] &= ~bit(i);
+    }
+
+    // Ends every ramp on its target
+    void jumpToTargets()
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            setCurrentAndTarget(i, target[(size_t)i]);
+        }
+    }
+
+    float getTarget(int index) const
+    {
+        return target[(size_t)index];
+    }
+
+    // Value reached at the end of the last rendered block
+    float getCurrentValue(int index) const
+    {
+        return current[(size_t)index];
+    }
+
+    bool isSmoothing(int index) const
+    {
+        return remaining[(size_t)index] > 0;
+    }
+
+    // Advances the first numSmoothers smoothers by numSamples, which must not
+    // exceed the prepared block size. Realtime safe
+    void render(int numSmoothers, int numSamples)
+    {
+        numSmoothers = std::min(numSmoothers, size);
+        numSamples = std::clamp(numSamples, 0, blockSize);
+
+        for (size_t word = 0; word < activeMask.size(); ++word)
+        {
+            rampMask[word] = activeMask[word] & lowBits(word, numSmoothers);
+            auto moving = rampMask[word];
+
+            while (moving != 0)
+            {
+                const auto i = word * 64 + (size_t)countTrailingZeros(moving);
+                moving &= moving - 1;
+
+                renderRamp(i, numSamples);
+            }
+        }
+    }
+
+    // Ramp rendered by the last render() call, or nullptr when the smoother
+    // held getCurrentValue() for the whole block
+    const float* getRamp(int index) const
+    {
+        const auto i = (size_t)index;
+        return (rampMask[i / 64] & bit(i)) != 0 ? ramps.data() + i * (size_t)blockSize : nullptr;
+    }
+
+    std::size_t getMemoryBytes() const
+    {
+        return (current.capacity() + target.capacity() + step.capacity() + ramps.capacity()) * sizeof(float)
+            + remaining.capacity() * sizeof(int) + (activeMask.capacity() + rampMask.capacity()) * sizeof(std::uint64_t);
+    }
+
+private:
+    std::vector<float> current;
+    std::vector<float> target;
+    std::vector<float> step;
+    std::vector<int> remaining;
+    std::vector<std::uint64_t> activeMask;
+    std::vector<std::uint64_t> rampMask;
+    std::vector<float> ramps;
+    int size = 0;
+    int blockSize = 1;
+    int rampLength = 0;
+
+    void renderRamp(size_t i, int numSamples)
+    {
+        float* ramp = ramps.data() + i * (size_t)blockSize;
+        const float start = current[i];
+        const float increment = step[i];
+        const int moving = std::min(remaining[i], numSamples);
+
+        for (int k = 0; k < moving; ++k)
+        {
+            ramp[k] = start + increment * (float)(k + 1);
+        }
+
+        remaining[i] -= moving;
+
+        if (remaining[i] > 0)
+        {
+            current[i] = start + increment * (float)numSamples;
+            return;
+        }
+
+        // The last step lands exactly on the target
+        std::fill(ramp + std::max(moving - 1, 0), ramp + numSamples, target[i]);
+        current[i] = target[i];
+        activeMask[i / 64] &= ~bit(i);
+    }
+
+    static inline std::uint64_t bit(size_t i)
+    {
+        return std::uint64_t{1} << (i % 64);
+    }
+
+    // Bits of the given mask word that belong to the first count smoothers
+    static inline std::uint64_t lowBits(size_t word, int count)
+    {
+        const auto first = (int)(word * 64);
+
+        if (count <= first)
+        {
+            return 0;
+        }
+
+        return count - first >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << (count - first)) - 1;
+    }
+
+    static inline int countTrailingZeros(std::uint64_t value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(value);
+#else
+        int count = 0;
+        while ((value & 1) == 0)
+        {
+            value >>= 1;
+            ++count;
+        }
+        return count;
+#endif
+    }
+};
@@ -0,0 +1,220 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <vector>
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include "TripleBuffer.h"
+
+// Audio side of the spectrum analyser: copies one channel of the processed
+// signal into a lock-free FIFO, and nothing else. Samples that do not fit
+// are dropped, so a stalled analyser never holds up the audio thread.
+class SpectrumTap
+{
+public:
+    // Channel to copy from 0, or -1 to copy nothing; set by the editor
+    void setChannel(int ch)
+    {
+        channel.store(ch, std::memory_order_relaxed);
+    }
+
+    // Audio thread
+    void push(const float* const* channels, int numChannels, int numSamples)
+    {
+        const int ch = channel.load(std::memory_order_relaxed);
+
+        if (ch < 0 || ch >= numChannels)
+        {
+            return;
+        }
+
+        const auto scope = fifo.write(std::min(numSamples, fifo.getFreeSpace()));
+        std::copy(channels[ch], channels[ch] + scope.blockSize1, buffer.data() + scope.startIndex1);
+        std::copy(channels[ch] + scope.blockSize1, channels[ch] + scope.blockSize1 + scope.blockSize2, buffer.data() + scope.startIndex2);
+    }
+
+    // Analyser thread: moves up to numSamples samples into destination,
+    // returning how many there were
+    int pull(float* destination, int numSamples)
+    {
+        const auto scope = fifo.read(std::min(numSamples, fifo.getNumReady()));
+        std::copy(buffer.data() + scope.startIndex1, buffer.data() + scope.startIndex1 + scope.blockSize1, destination);
+        std::copy(buffer.data() + scope.startIndex2, buffer.data() + scope.startIndex2 + scope.blockSize2, destination + scope.blockSize1);
+
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    // About a third of a second at 96 kHz, several frames of the analyser
+    static constexpr int capacity = 1 << 15;
+
+private:
+    juce::AbstractFifo fifo{capacity};
+    std::vector<float> buffer = std::vector<float>((size_t)capacity, 0.0f);
+    std::atomic<int> channel{-1};
+};
+
+// Transforms the samples of a SpectrumTap on its own thread, at a capped
+// frame rate, and hands the magnitudes to the editor through a TripleBuffer.
+// The thread only runs while the spectrum is shown.
+class SpectrumAnalyser : private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = fftSize / 2;
+
+    struct Spectrum
+    {
+        // Level of each bin in dB relative to a full scale sine, bin i being
+        // centred on i * sampleRate / fftSize
+        std::array<float, numBins> decibels{};
+    };
+
+    explicit SpectrumAnalyser(SpectrumTap& tapToRead) :
+        juce::Thread("Plug64 spectrum"),
+        tap(tapToRead)
+    {
+        window.resize((size_t)fftSize);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t)fftSize, juce::dsp::WindowingFunction<float>::hann, false);
+
+        // A full scale sine peaks at the sum of the window over two
+        float windowSum = 0.0f;
+        for (const auto w : window)
+        {
+            windowSum += w;
+        }
+        normalisation = 2.0f / windowSum;
+    }
+
+    ~SpectrumAnalyser() override
+    {
+        stop();
+    }
+
+    // Starts analysing channel ch from 0, or switches to it when running
+    void start(int ch)
+    {
+        tap.setChannel(ch);
+
+        if (!isThreadRunning())
+        {
+            startThread(juce::Thread::Priority::low);
+        }
+    }
+
+    void stop()
+    {
+        tap.setChannel(-1);
+        stopThread(1000);
+    }
+
+    bool isRunning() const
+    {
+        return isThreadRunning();
+    }
+
+    // Message thread: takes the latest spectrum, if newer than the one held,
+    // returning whether it was
+    bool read(Spectrum& spectrum)
+    {
+        if (!spectra.update())
+        {
+            return false;
+        }
+
+        spectrum = spectra.getReadBuffer();
+        return true;
+    }
+
+private:
+    static constexpr int frameRate = 30;
+    static constexpr float floorDecibels = -120.0f;
+    // Fall of a bin between two frames, so that the peaks stay readable
+    static constexpr float releaseDecibels = 3.0f;
+
+    SpectrumTap& tap;
+    juce::dsp::FFT fft{fftOrder};
+    std::vector<float> window;
+    float normalisation = 1.0f;
+    // The latest fftSize samples, oldest first, and the FFT work buffer
+    std::array<float, fftSize> history{};
+    std::array<float, 2 * fftSize> fftData{};
+    std::array<float, SpectrumTap::capacity> incoming{};
+    std::array<float, numBins> smoothed{};
+    TripleBuffer<Spectrum> spectra;
+
+    void run() override
+    {
+        smoothed.fill(floorDecibels);
+
+        while (!threadShouldExit())
+        {
+            if (collect())
+            {
+                transform();
+            }
+
+            wait(1000 / frameRate);
+        }
+    }
+
+    // Appends what the tap holds to the history, returning whether anything
+    // new arrived
+    bool collect()
+    {
+        bool arrived = false;
+
+        for (int count = tap.pull(incoming.data(), (int)incoming.size()); count > 0; count = tap.pull(incoming.data(), (int)incoming.size()))
+        {
+            arrived = true;
+            const int kept = std::min(count, fftSize);
+
+            std::move(history.begin() + kept, history.end(), history.begin());
+            std::copy(incoming.begin() + (count - kept), incoming.begin() + count, history.end() - kept);
+        }
+
+        return arrived;
+    }
+
+    void transform()
+    {
+        for (size_t i = 0; i < (size_t)fftSize; ++i)
+        {
+            fftData[i] = history[i] * window[i];
+        }
+        std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+        fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+        auto& spectrum = spectra.getWriteBuffer();
+
+        for (size_t bin = 0; bin < (size_t)numBins; ++bin)
+        {
+            const float decibels = juce::Decibels::gainToDecibels(fftData[bin] * normalisation, floorDecibels);
+            smoothed[bin] = std::max(decibels, smoothed[bin] - releaseDecibels);
+            spectrum.decibels[bin] = smoothed[bin];
+        }
+
+        spectra.publish();
+    }
+};
@@ -0,0 +1,271 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "PresetBank.h"
+
+// Restores the plugin state without blocking the thread that calls
+// setStateInformation(). The data is decoded on a thread pool shared by all
+// the instances into a snapshot of the parameter values, which the audio
+// thread jumps to from its next block through the preset bank. The parameter
+// tree and the preset bank are then replaced on the message thread in one
+// go, after which onRestored is called and the snapshot is withdrawn.
+//
+// The parameters are set through the preset bank first, which notifies the
+// host and the editor of those that changed within one gesture, so the tree
+// then already holds their values and replacing it notifies nothing more.
+// Should the message loop not run, the state is applied from the pool
+// instead once the call has been waited for long enough.
+//
+// Until then getPendingState() returns the data being restored, so that a
+// host saving the state right after restoring it gets the new one.
+//
+// Offline renders load synchronously instead, since the host expects the
+// state to be in place for the next block and may not run the message loop.
+class StateLoader
+{
+public:
+    // Called on the message thread once a state has been restored
+    std::function<void()> onRestored;
+
+    StateLoader(juce::AudioProcessorValueTreeState& stateToUse, PresetBank& bankToUse) :
+        context(std::make_shared<Context>(stateToUse, bankToUse))
+    {
+        context->owner = this;
+    }
+
+    ~StateLoader()
+    {
+        // Waits for a decode in progress; queued work finds the loader gone
+        const std::lock_guard<std::mutex> guard(context->lock);
+        context->owner = nullptr;
+        context->bank.restore(nullptr);
+    }
+
+    void load(const void* data, int sizeInBytes, bool synchronous)
+    {
+        if (synchronous)
+        {
+            loadNow(data, sizeInBytes);
+            return;
+        }
+
+        int generation = 0;
+
+        {
+            const std::lock_guard<std::mutex> guard(context->lock);
+            context->pendingData.replaceAll(data, (size_t)sizeInBytes);
+            generation = ++context->generation;
+        }
+
+        pool->threads.addJob([weakContext = std::weak_ptr<Context>(context), generation]
+        {
+            decode(weakContext, generation);
+        });
+    }
+
+    bool getPendingState(juce::MemoryBlock& destData) const
+    {
+        const std::lock_guard<std::mutex> guard(context->lock);
+
+        if (context->pendingData.isEmpty())
+        {
+            return false;
+        }
+
+        destData = context->pendingData;
+        return true;
+    }
+
+private:
+    struct Pool
+    {
+        juce::ThreadPool threads{2};
+    };
+
+    // Shared with the queued work, which may outlive the loader
+    struct Context
+    {
+        Context(juce::AudioProcessorValueTreeState& stateToUse, PresetBank& bankToUse) :
+            state(stateToUse),
+            bank(bankToUse)
+        {
+        }
+
+        std::mutex lock;
+        StateLoader* owner = nullptr;
+        juce::AudioProcessorValueTreeState& state;
+        PresetBank& bank;
+        juce::MemoryBlock pendingData;
+        std::unique_ptr<std::vector<float>> restoredValues;
+        int generation = 0;
+        int appliedGeneration = 0;
+        juce::WaitableEvent applied;
+    };
+
+    // How long the pool waits for the message thread before applying a
+    // state itself
+    static constexpr int messageLoopTimeoutMs = 1000;
+
+    std::shared_ptr<Context> context;
+    juce::SharedResourcePointer<Pool> pool;
+
+    void loadNow(const void* data, int sizeInBytes)
+    {
+        const auto xml = parse(*context, data, sizeInBytes);
+        std::function<void()> restored;
+
+        {
+            const std::lock_guard<std::mutex> guard(context->lock);
+
+            // Supersedes any state still being decoded
+            ++context->generation;
+            withdraw(*context);
+
+            if (xml == nullptr)
+            {
+                return;
+            }
+
+            replace(*context, *xml, context->bank.decodeValues(*xml));
+            restored = onRestored;
+        }
+
+        if (restored != nullptr)
+        {
+            restored();
+        }
+    }
+
+    static std::unique_ptr<juce::XmlElement> parse(const Context& context, const void* data, int sizeInBytes)
+    {
+        auto xml = juce::AudioProcessor::getXmlFromBinary(data, sizeInBytes);
+
+        if (xml == nullptr || !xml->hasTagName(context.state.state.getType()))
+        {
+            return nullptr;
+        }
+
+        return xml;
+    }
+
+    // Sets the parameters, then the preset bank and the tree
+    static void replace(Context& context, juce::XmlElement& xml, const std::vector<float>& values)
+    {
+        context.bank.apply(values, true);
+        context.bank.readFrom(xml);
+        context.state.replaceState(juce::ValueTree::fromXml(xml));
+    }
+
+    // Withdraws the snapshot and the data of the state being restored
+    static void withdraw(Context& context)
+    {
+        context.bank.restore(nullptr);
+        context.restoredValues.reset();
+        context.pendingData.reset();
+    }
+
+    static void decode(const std::weak_ptr<Context>& weakContext, int generation)
+    {
+        const auto context = weakContext.lock();
+
+        if (context == nullptr)
+        {
+            return;
+        }
+
+        std::shared_ptr<juce::XmlElement> xml;
+
+        {
+            const std::lock_guard<std::mutex> guard(context->lock);
+
+            // A newer state supersedes this one
+            if (context->owner == nullptr || generation != context->generation)
+            {
+                return;
+            }
+
+            xml = parse(*context, context->pendingData.getData(), (int)context->pendingData.getSize());
+
+            // Nothing may keep playing the snapshot of an earlier state
+            if (xml == nullptr)
+            {
+                withdraw(*context);
+                return;
+            }
+
+            auto values = std::make_unique<std::vector<float>>(context->bank.decodeValues(*xml));
+            context->bank.restore(values->data());
+            context->restoredValues = std::move(values);
+            context->applied.reset();
+        }
+
+        const bool posted = juce::MessageManager::callAsync([weakContext, generation, xml]
+        {
+            apply(weakContext, generation, *xml);
+        });
+
+        // Hosts rendering without a message loop never make the call; the
+        // late one then finds the state applied
+        if (!posted || !context->applied.wait(messageLoopTimeoutMs))
+        {
+            apply(weakContext, generation, *xml);
+        }
+    }
+
+    static void apply(const std::weak_ptr<Context>& weakContext, int generation, juce::XmlElement& xml)
+    {
+        const auto context = weakContext.lock();
+
+        if (context == nullptr)
+        {
+            return;
+        }
+
+        std::function<void()> onRestored;
+
+        {
+            const std::lock_guard<std::mutex> guard(context->lock);
+
+            if (context->owner == nullptr || generation != context->generation || generation == context->appliedGeneration)
+            {
+                return;
+            }
+
+            replace(*context, xml, *context->restoredValues);
+            context->appliedGeneration = generation;
+
+            // The parameters now hold the restored values
+            withdraw(*context);
+            onRestored = context->owner->onRestored;
+        }
+
+        context->applied.signal();
+
+        if (onRestored != nullptr)
+        {
+            onRestored();
+        }
+    }
+};
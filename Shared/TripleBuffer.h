@@ -0,0 +1,72 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Hands the latest value from one writer thread to one reader thread without
+// locks nor waiting: the writer fills its own buffer and swaps it with the
+// middle one, the reader swaps its own with the middle one when a newer
+// value is there. Values published between two reads are skipped, so T
+// should hold a state rather than a sequence of events.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Writer side
+    T& getWriteBuffer()
+    {
+        return buffers[(size_t)writeIndex];
+    }
+
+    void publish()
+    {
+        writeIndex = middle.exchange(writeIndex | newBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Reader side: takes the latest published value, if newer than the one
+    // held, returning whether it was
+    bool update()
+    {
+        if ((middle.load(std::memory_order_relaxed) & newBit) == 0)
+        {
+            return false;
+        }
+
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    const T& getReadBuffer() const
+    {
+        return buffers[(size_t)readIndex];
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int newBit = 4;
+
+    std::array<T, 3> buffers{};
+    // Index of the middle buffer, with newBit set when it holds a value the
+    // reader has not taken yet
+    std::atomic<int> middle{1};
+    int writeIndex = 0;
+    int readIndex = 2;
+};
@@ -0,0 +1,63 @@
+# Records the reference renders of the regression suite from a baseline
+# build, by default the commit that added the suite, so that they describe
+# the output from before the DSP optimisations that followed it:
+#
+#   cmake [-DBaseline=<commit>] -P Tests/RecordReferences.cmake
+#
+# The current Tests folder is built against the plugins of the baseline in a
+# temporary worktree, the render runners are run with
+# PLUG64_UPDATE_REFERENCES=1, and the renders are copied to Tests/References.
+
+cmake_minimum_required(VERSION 3.19)
+
+get_filename_component(RepoDir "${CMAKE_CURRENT_LIST_DIR}/.." ABSOLUTE)
+set(WorkDir "${RepoDir}/_references")
+set(SourceDir "${WorkDir}/source")
+set(BuildDir "${WorkDir}/build")
+
+find_package(Git REQUIRED)
+
+if (NOT Baseline)
+    execute_process(COMMAND ${GIT_EXECUTABLE} log --diff-filter=A --format=%H -- Tests/Source/ReferenceTests.cpp
+            WORKING_DIRECTORY "${RepoDir}"
+            OUTPUT_VARIABLE Baseline
+            OUTPUT_STRIP_TRAILING_WHITESPACE
+            COMMAND_ERROR_IS_FATAL ANY)
+
+    # The oldest commit is listed last
+    string(REGEX REPLACE ".*\n" "" Baseline "${Baseline}")
+endif ()
+
+message(STATUS "Recording the references from ${Baseline}")
+
+file(REMOVE_RECURSE "${WorkDir}")
+execute_process(COMMAND ${GIT_EXECUTABLE} worktree add --detach "${SourceDir}" ${Baseline}
+        WORKING_DIRECTORY "${RepoDir}"
+        COMMAND_ERROR_IS_FATAL ANY)
+execute_process(COMMAND ${GIT_EXECUTABLE} submodule update --init --recursive
+        WORKING_DIRECTORY "${SourceDir}"
+        COMMAND_ERROR_IS_FATAL ANY)
+
+file(REMOVE_RECURSE "${SourceDir}/Tests")
+file(COPY "${RepoDir}/Tests" DESTINATION "${SourceDir}")
+file(REMOVE_RECURSE "${SourceDir}/Tests/References")
+
+execute_process(COMMAND ${CMAKE_COMMAND} -S "${SourceDir}" -B "${BuildDir}" -DBuildTests=ON -DCMAKE_BUILD_TYPE=Release
+        COMMAND_ERROR_IS_FATAL ANY)
+
+foreach (plugin Chain64 Delay64 Filter64 Gain64 Ring64)
+    execute_process(COMMAND ${CMAKE_COMMAND} --build "${BuildDir}" --config Release --target ${plugin}RenderTests
+            COMMAND_ERROR_IS_FATAL ANY)
+
+    file(GLOB_RECURSE runner LIST_DIRECTORIES false "${BuildDir}/Tests/${plugin}RenderTests" "${BuildDir}/Tests/${plugin}RenderTests.exe")
+    list(GET runner 0 runner)
+
+    execute_process(COMMAND ${CMAKE_COMMAND} -E env PLUG64_UPDATE_REFERENCES=1 "${runner}" "Renders match the stored references"
+            COMMAND_ERROR_IS_FATAL ANY)
+endforeach ()
+
+file(COPY "${SourceDir}/Tests/References" DESTINATION "${RepoDir}/Tests")
+
+execute_process(COMMAND ${GIT_EXECUTABLE} worktree remove --force "${SourceDir}"
+        WORKING_DIRECTORY "${RepoDir}")
+file(REMOVE_RECURSE "${WorkDir}")
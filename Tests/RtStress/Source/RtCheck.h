@@ -0,0 +1,66 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <dlfcn.h>
+
+// Optional link to the plug64rtcheck interposer. The functions are looked up
+// at runtime, so the stress runner still works (without the allocation, lock
+// and system call checks) when the library is not preloaded.
+struct RtCheck
+{
+    using Function = void (*)();
+    using Counter = unsigned long (*)();
+
+    Function enter = reinterpret_cast<Function>(dlsym(RTLD_DEFAULT, "plug64_rtcheck_enter"));
+    Function leave = reinterpret_cast<Function>(dlsym(RTLD_DEFAULT, "plug64_rtcheck_leave"));
+    Counter violations = reinterpret_cast<Counter>(dlsym(RTLD_DEFAULT, "plug64_rtcheck_violations"));
+
+    bool isLoaded() const
+    {
+        return enter != nullptr && leave != nullptr && violations != nullptr;
+    }
+
+    // Marks the calling thread as realtime for the lifetime of the object
+    struct Section
+    {
+        explicit Section(const RtCheck& check) : rtCheck(check)
+        {
+            if (rtCheck.isLoaded())
+            {
+                rtCheck.enter();
+            }
+        }
+
+        ~Section()
+        {
+            if (rtCheck.isLoaded())
+            {
+                rtCheck.leave();
+            }
+        }
+
+        const RtCheck& rtCheck;
+    };
+
+    unsigned long getViolations() const
+    {
+        return isLoaded() ? violations() : 0;
+    }
+};
@@ -0,0 +1,323 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+// LD_PRELOAD library reporting every allocation, lock, blocking wait and
+// common system call made by a thread while it is inside a realtime section
+// (between plug64_rtcheck_enter() and plug64_rtcheck_leave()). Each violation
+// is counted, and the first ones are printed to stderr with a backtrace.
+// glibc only: the allocator is forwarded to its __libc_* entry points.
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+extern "C"
+{
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pointer);
+}
+
+namespace
+{
+constexpr int maxReports = 20;
+
+__thread int realtimeDepth __attribute__((tls_model("initial-exec"))) = 0;
+__thread int reporting __attribute__((tls_model("initial-exec"))) = 0;
+
+std::atomic<unsigned long> violations{0};
+std::atomic<int> reports{0};
+
+struct RealFunctions
+{
+    int (*mutexLock)(pthread_mutex_t*);
+    int (*rwlockRead)(pthread_rwlock_t*);
+    int (*rwlockWrite)(pthread_rwlock_t*);
+    int (*condWait)(pthread_cond_t*, pthread_mutex_t*);
+    int (*condTimedWait)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*);
+    int (*semWait)(sem_t*);
+    int (*open)(const char*, int, ...);
+    int (*close)(int);
+    ssize_t (*read)(int, void*, size_t);
+    ssize_t (*write)(int, const void*, size_t);
+    int (*nanosleep)(const struct timespec*, struct timespec*);
+    int (*usleep)(useconds_t);
+    int (*schedYield)();
+    void* (*mmap)(void*, size_t, int, int, int, off_t);
+    int (*munmap)(void*, size_t);
+    long (*syscall)(long, ...);
+};
+
+RealFunctions real{};
+
+template <typename Function>
+void resolve(Function& function, const char* name)
+{
+    function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+}
+
+// Other libraries may call in before initialise() has run
+template <typename Function>
+Function next(Function& function, const char* name)
+{
+    if (function == nullptr)
+    {
+        resolve(function, name);
+    }
+
+    return function;
+}
+
+// Resolved once at load time, so that no lookup (and no allocation) happens
+// later inside a realtime section
+__attribute__((constructor)) void initialise()
+{
+    resolve(real.mutexLock, "pthread_mutex_lock");
+    resolve(real.rwlockRead, "pthread_rwlock_rdlock");
+    resolve(real.rwlockWrite, "pthread_rwlock_wrlock");
+    resolve(real.condWait, "pthread_cond_wait");
+    resolve(real.condTimedWait, "pthread_cond_timedwait");
+    resolve(real.semWait, "sem_wait");
+    resolve(real.open, "open");
+    resolve(real.close, "close");
+    resolve(real.read, "read");
+    resolve(real.write, "write");
+    resolve(real.nanosleep, "nanosleep");
+    resolve(real.usleep, "usleep");
+    resolve(real.schedYield, "sched_yield");
+    resolve(real.mmap, "mmap");
+    resolve(real.munmap, "munmap");
+    resolve(real.syscall, "syscall");
+
+    // The first backtrace() loads libgcc, which allocates
+    void* frames[1];
+    backtrace(frames, 1);
+}
+
+void check(const char* function)
+{
+    if (realtimeDepth == 0 || reporting != 0)
+    {
+        return;
+    }
+
+    reporting = 1;
+    violations.fetch_add(1, std::memory_order_relaxed);
+
+    if (reports.fetch_add(1, std::memory_order_relaxed) < maxReports)
+    {
+        char message[160];
+        const int length = std::snprintf(message, sizeof(message), "plug64-rtcheck: %s called inside the realtime section\n", function);
+        next(real.write, "write")(STDERR_FILENO, message, (size_t)length);
+
+        void* frames[32];
+        backtrace_symbols_fd(frames, backtrace(frames, 32), STDERR_FILENO);
+    }
+
+    reporting = 0;
+}
+}
+
+extern "C"
+{
+void plug64_rtcheck_enter()
+{
+    ++realtimeDepth;
+}
+
+void plug64_rtcheck_leave()
+{
+    --realtimeDepth;
+}
+
+unsigned long plug64_rtcheck_violations()
+{
+    return violations.load();
+}
+
+void* malloc(size_t size)
+{
+    check("malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    check("calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size)
+{
+    check("realloc");
+    return __libc_realloc(pointer, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    check("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    check("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, size_t alignment, size_t size)
+{
+    check("posix_memalign");
+    *pointer = __libc_memalign(alignment, size);
+    return *pointer != nullptr || size == 0 ? 0 : ENOMEM;
+}
+
+void free(void* pointer)
+{
+    check("free");
+    __libc_free(pointer);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    check("pthread_mutex_lock");
+    return next(real.mutexLock, "pthread_mutex_lock")(mutex);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* lock)
+{
+    check("pthread_rwlock_rdlock");
+    return next(real.rwlockRead, "pthread_rwlock_rdlock")(lock);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* lock)
+{
+    check("pthread_rwlock_wrlock");
+    return next(real.rwlockWrite, "pthread_rwlock_wrlock")(lock);
+}
+
+int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+{
+    check("pthread_cond_wait");
+    return next(real.condWait, "pthread_cond_wait")(condition, mutex);
+}
+
+int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* time)
+{
+    check("pthread_cond_timedwait");
+    return next(real.condTimedWait, "pthread_cond_timedwait")(condition, mutex, time);
+}
+
+int sem_wait(sem_t* semaphore)
+{
+    check("sem_wait");
+    return next(real.semWait, "sem_wait")(semaphore);
+}
+
+int open(const char* path, int flags, ...)
+{
+    check("open");
+
+    va_list arguments;
+    va_start(arguments, flags);
+    const mode_t mode = (flags & (O_CREAT | O_TMPFILE)) != 0 ? (mode_t)va_arg(arguments, int) : 0;
+    va_end(arguments);
+
+    return next(real.open, "open")(path, flags, mode);
+}
+
+int close(int descriptor)
+{
+    check("close");
+    return next(real.close, "close")(descriptor);
+}
+
+ssize_t read(int descriptor, void* buffer, size_t count)
+{
+    check("read");
+    return next(real.read, "read")(descriptor, buffer, count);
+}
+
+ssize_t write(int descriptor, const void* buffer, size_t count)
+{
+    check("write");
+    return next(real.write, "write")(descriptor, buffer, count);
+}
+
+int nanosleep(const struct timespec* duration, struct timespec* remaining)
+{
+    check("nanosleep");
+    return next(real.nanosleep, "nanosleep")(duration, remaining);
+}
+
+int usleep(useconds_t microseconds)
+{
+    check("usleep");
+    return next(real.usleep, "usleep")(microseconds);
+}
+
+int sched_yield()
+{
+    check("sched_yield");
+    return next(real.schedYield, "sched_yield")();
+}
+
+void* mmap(void* address, size_t length, int protection, int flags, int descriptor, off_t offset)
+{
+    check("mmap");
+    return next(real.mmap, "mmap")(address, length, protection, flags, descriptor, offset);
+}
+
+int munmap(void* address, size_t length)
+{
+    check("munmap");
+    return next(real.munmap, "munmap")(address, length);
+}
+
+long syscall(long number, ...)
+{
+    check("syscall");
+
+    va_list arguments;
+    va_start(arguments, number);
+    long values[6];
+    for (auto& value : values)
+    {
+        value = va_arg(arguments, long);
+    }
+    va_end(arguments);
+
+    return next(real.syscall, "syscall")(number, values[0], values[1], values[2], values[3], values[4], values[5]);
+}
+}
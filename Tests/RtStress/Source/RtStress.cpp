@@ -0,0 +1,306 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+// Realtime-safety stress runner, built once per plugin against its shared
+// code. It hosts the processor with a SCHED_FIFO audio thread and, round after
+// round, picks a random bus layout, sample rate and announced block size, then
+// processes random block sizes (including blocks longer than announced) while
+// another thread changes parameters and saves and restores the state, while
+// the main thread dispatches messages.
+//
+// Preloaded with libplug64rtcheck.so, any allocation, lock or system call made
+// inside processBlock() is reported. The run fails on such violations and on
+// non-finite output.
+//
+// Usage: <Plugin>RtStress [--seconds N] [--seed N]
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+#include <random>
+#include <sched.h>
+#include <thread>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "RtCheck.h"
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+constexpr int maxChannels = 72;
+constexpr int maxBlockSize = 4 * 2048;
+constexpr double roundAudioSeconds = 0.5;
+
+struct Round
+{
+    int numChannels = 2;
+    // Channels of the auxiliary input buses, such as the Ring64 sidechain,
+    // 0 to disable them
+    int numAuxChannels = 0;
+    double sampleRate = 48000.0;
+    int samplesPerBlock = 512;
+};
+
+struct Results
+{
+    unsigned long rounds = 0;
+    unsigned long blocks = 0;
+    unsigned long nonFinite = 0;
+    bool realtimeGranted = true;
+};
+
+template <typename Container>
+auto pick(std::mt19937& rng, const Container& values)
+{
+    return values[rng() % (sizeof(values) / sizeof(values[0]))];
+}
+
+Round chooseRound(std::mt19937& rng)
+{
+    // More channels than MAX_CHANS are included on purpose
+    static constexpr int channelCounts[] = {1, 2, 4, 6, 8, 16, 32, 64, maxChannels};
+    static constexpr double sampleRates[] = {22050.0, 44100.0, 48000.0, 88200.0, 96000.0, 192000.0};
+    static constexpr int blockSizes[] = {16, 32, 64, 100, 128, 256, 480, 512, 1024, 2048};
+    static constexpr int auxChannelCounts[] = {0, 0, 1, 2, 8, 64};
+
+    Round round;
+    round.numChannels = pick(rng, channelCounts);
+    round.numAuxChannels = pick(rng, auxChannelCounts);
+    round.sampleRate = pick(rng, sampleRates);
+    round.samplesPerBlock = pick(rng, blockSizes);
+    return round;
+}
+
+juce::AudioChannelSet getChannelSet(int numChannels)
+{
+    if (numChannels == 1)
+    {
+        return juce::AudioChannelSet::mono();
+    }
+
+    if (numChannels == 2)
+    {
+        return juce::AudioChannelSet::stereo();
+    }
+
+    return juce::AudioChannelSet::discreteChannels(numChannels);
+}
+
+bool makeRealtime()
+{
+    sched_param parameters{};
+    parameters.sched_priority = sched_get_priority_max(SCHED_FIFO) - 10;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters) == 0;
+}
+
+// Host-sized blocks most of the time, then shorter ones, empty ones and
+// blocks longer than the size announced in prepareToPlay()
+int chooseBlockSize(std::mt19937& rng, int samplesPerBlock)
+{
+    const auto choice = rng() % 10;
+
+    if (choice < 6)
+    {
+        return samplesPerBlock;
+    }
+
+    if (choice < 8)
+    {
+        return (int)(rng() % (unsigned int)samplesPerBlock);
+    }
+
+    return std::min(samplesPerBlock + 1 + (int)(rng() % (unsigned int)(3 * samplesPerBlock)), maxBlockSize);
+}
+
+void runRound(juce::AudioProcessor& processor, const Round& round, unsigned int seed, const RtCheck& rtCheck, Results& results)
+{
+    // Starts from the buses the processor has, so that the auxiliary ones
+    // are kept
+    auto layout = processor.getBusesLayout();
+    layout.getChannelSet(true, 0) = getChannelSet(round.numChannels);
+    layout.getChannelSet(false, 0) = getChannelSet(round.numChannels);
+
+    for (int bus = 1; bus < layout.inputBuses.size(); ++bus)
+    {
+        layout.getChannelSet(true, bus) = round.numAuxChannels > 0 ? getChannelSet(round.numAuxChannels) : juce::AudioChannelSet::disabled();
+    }
+
+    processor.releaseResources();
+
+    if (!processor.setBusesLayout(layout))
+    {
+        return;
+    }
+
+    processor.setRateAndBufferSizeDetails(round.sampleRate, round.samplesPerBlock);
+    processor.prepareToPlay(round.sampleRate, round.samplesPerBlock);
+
+    const int numBufferChannels = std::max(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+
+    const int numBlocks = std::max(1, (int)(round.sampleRate * roundAudioSeconds) / round.samplesPerBlock);
+    std::atomic<bool> audioDone{false};
+
+    std::thread control([&]
+    {
+        std::mt19937 rng(seed * 7919u);
+        std::uniform_real_distribution<float> value(0.0f, 1.0f);
+        const auto& parameters = processor.getParameters();
+        juce::MemoryBlock state;
+        processor.getStateInformation(state);
+
+        while (!audioDone.load())
+        {
+            const auto action = rng() % 100;
+
+            if (action < 90 && !parameters.isEmpty())
+            {
+                parameters[(int)(rng() % (unsigned int)parameters.size())]->setValueNotifyingHost(value(rng));
+            }
+            else if (action < 95)
+            {
+                processor.getStateInformation(state);
+            }
+            else
+            {
+                processor.setStateInformation(state.getData(), (int)state.getSize());
+            }
+
+            std::this_thread::sleep_for(std::chrono::microseconds(rng() % 500));
+        }
+    });
+
+    std::thread audio([&]
+    {
+        results.realtimeGranted = makeRealtime() && results.realtimeGranted;
+
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+        juce::AudioBuffer<float> storage(numBufferChannels, maxBlockSize);
+        juce::MidiBuffer midi;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            const int numSamples = chooseBlockSize(rng, round.samplesPerBlock);
+
+            for (int ch = 0; ch < numBufferChannels; ++ch)
+            {
+                float* data = storage.getWritePointer(ch);
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    data[i] = noise(rng);
+                }
+            }
+
+            // Wraps the preallocated storage, outside of the checked section
+            juce::AudioBuffer<float> buffer(storage.getArrayOfWritePointers(), numBufferChannels, numSamples);
+
+            {
+                RtCheck::Section section(rtCheck);
+                processor.processBlock(buffer, midi);
+            }
+
+            for (int ch = 0; ch < round.numChannels; ++ch)
+            {
+                const float* data = buffer.getReadPointer(ch);
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    if (!std::isfinite(data[i]))
+                    {
+                        ++results.nonFinite;
+                        break;
+                    }
+                }
+            }
+
+            ++results.blocks;
+        }
+
+        audioDone = true;
+    });
+
+    audio.join();
+    control.join();
+
+    ++results.rounds;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    double seconds = 10.0;
+    unsigned int seed = 1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            seconds = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            std::printf("Usage: %s [--seconds N] [--seed N]\n", argv[0]);
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    std::unique_ptr<juce::AudioProcessor> processor(createPluginFilter());
+
+    const RtCheck rtCheck;
+    if (!rtCheck.isLoaded())
+    {
+        std::printf("libplug64rtcheck.so is not preloaded: allocations, locks and system calls are not checked\n");
+    }
+
+    std::mt19937 rng(seed);
+    Results results;
+    const auto start = std::chrono::steady_clock::now();
+
+    // The main thread dispatches messages meanwhile, as the plugins complete
+    // state restores and report latency from the message thread
+    std::thread rounds([&]
+    {
+        while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds)
+        {
+            runRound(*processor, chooseRound(rng), (unsigned int)rng(), rtCheck, results);
+        }
+
+        processor->releaseResources();
+        juce::MessageManager::getInstance()->stopDispatchLoop();
+    });
+
+    juce::MessageManager::getInstance()->runDispatchLoop();
+    rounds.join();
+
+    const auto violations = rtCheck.getViolations();
+
+    std::printf("%s: %lu rounds, %lu blocks, %lu realtime violations, %lu blocks with non-finite output%s\n",
+                processor->getName().toRawUTF8(), results.rounds, results.blocks, violations, results.nonFinite,
+                results.realtimeGranted ? "" : " (SCHED_FIFO not permitted, ran at normal priority)");
+
+    return violations == 0 && results.nonFinite == 0 ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include "RenderHelpers.h"
+
+using Scenario = PLUG64_SCENARIO;
+
+TEST_CASE("Output does not depend on the block size", "[blocksize]")
+{
+    const auto stimulus = GENERATE(Stimulus::impulse, Stimulus::sweep, Stimulus::noise, Stimulus::automation);
+    const int numChannels = GENERATE(channelVariants, MAX_CHANS);
+    const int blockSize = GENERATE(1, 32, 480, renderLength);
+    INFO(Scenario::name << " / " << getStimulusName(stimulus) << " / " << numChannels << " channels / " << blockSize << " samples");
+
+    const auto expected = renderScenario<Scenario>(stimulus, numChannels, referenceBlockSize);
+    const auto render = renderScenario<Scenario>(stimulus, numChannels, blockSize);
+
+    CHECK(maxDifference(render, expected) <= Scenario::tolerance);
+}
+
+TEST_CASE("Pipelined master stage only adds one block of latency", "[blocksize][pipeline]")
+{
+    if (!Scenario::hasPipeline)
+    {
+        SKIP(Scenario::name << " has no pipelined master stage");
+    }
+
+    constexpr int pipelineBlockSize = 256;
+
+    const auto stimulus = GENERATE(Stimulus::impulse, Stimulus::sweep, Stimulus::noise, Stimulus::automation);
+    const int blockSize = GENERATE(100, pipelineBlockSize, 1000);
+    INFO(Scenario::name << " / " << getStimulusName(stimulus) << " / " << blockSize << " samples");
+
+    const auto expected = renderScenario<Scenario>(stimulus, channelVariants, referenceBlockSize);
+    const auto render = renderScenario<Scenario>(stimulus, channelVariants, blockSize, pipelineBlockSize, true);
+
+    for (int ch = 0; ch < render.numChannels; ++ch)
+    {
+        for (int i = 0; i < pipelineBlockSize; ++i)
+        {
+            REQUIRE(render.channel(ch)[i] == 0.0f);
+        }
+    }
+
+    CHECK(maxDifference(render, expected, pipelineBlockSize) <= Scenario::tolerance);
+}
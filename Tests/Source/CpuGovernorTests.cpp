@@ -0,0 +1,118 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include <cstdint>
+#include <catch2/catch_test_macros.hpp>
+#include "CpuGovernor.h"
+
+// The governor must lower the quality only under sustained overload, and
+// raise it back only once the load has stayed well below the budget
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 480;
+
+// Feeds the governor blockCount blocks taking load times their duration,
+// with the host process at processLoad, returning the number of level changes
+int run(CpuGovernor& governor, double load, int blockCount, double processLoad = 0.0)
+{
+    const auto blockNanos = (std::uint64_t)(load * (double)blockSize / sampleRate * 1.0e9);
+    int changes = 0;
+
+    for (int i = 0; i < blockCount; ++i)
+    {
+        changes += governor.endBlock(blockNanos, blockSize, false, processLoad) ? 1 : 0;
+    }
+
+    return changes;
+}
+}
+
+TEST_CASE("CPU governor steps down under sustained overload", "[governor]")
+{
+    CpuGovernor governor;
+    governor.prepare(sampleRate);
+
+    // A single late block in a window of ten is averaged away
+    run(governor, 0.3, 9);
+    run(governor, 2.0, 1);
+    CHECK(governor.getLevel() == 0);
+
+    // One step per overloaded window, down to the lowest level
+    run(governor, 0.95, 10);
+    CHECK(governor.getLevel() == 1);
+
+    run(governor, 0.95, 100);
+    CHECK(governor.getLevel() == CpuGovernor::maxLevel);
+}
+
+TEST_CASE("CPU governor restores quality with hysteresis", "[governor]")
+{
+    CpuGovernor governor;
+    governor.prepare(sampleRate);
+    run(governor, 0.95, 20);
+    REQUIRE(governor.getLevel() == 2);
+
+    // Between the two thresholds nothing moves, however long
+    CHECK(run(governor, 0.6, 1000) == 0);
+
+    // Headroom must last restoreSeconds before each step up
+    const int blocksToRestore = (int)(CpuGovernor::restoreSeconds * sampleRate / blockSize);
+    run(governor, 0.2, blocksToRestore - 10);
+    CHECK(governor.getLevel() == 2);
+    run(governor, 0.2, 10);
+    CHECK(governor.getLevel() == 1);
+
+    // A busy window starts the wait again
+    run(governor, 0.2, blocksToRestore - 10);
+    run(governor, 0.6, 10);
+    run(governor, 0.2, blocksToRestore - 10);
+    CHECK(governor.getLevel() == 1);
+    run(governor, 0.2, 10);
+    CHECK(governor.getLevel() == 0);
+}
+
+TEST_CASE("CPU governor steps down when the host process is overloaded", "[governor]")
+{
+    CpuGovernor governor;
+    governor.prepare(sampleRate);
+
+    // Light instances step down together once the process fills the cores
+    run(governor, 0.01, 10, 0.95);
+    CHECK(governor.getLevel() == 1);
+
+    // and come back once the process has headroom again
+    const int blocksToRestore = (int)(CpuGovernor::restoreSeconds * sampleRate / blockSize);
+    run(governor, 0.01, blocksToRestore, 0.6);
+    CHECK(governor.getLevel() == 1);
+    run(governor, 0.01, blocksToRestore, 0.2);
+    CHECK(governor.getLevel() == 0);
+}
+
+TEST_CASE("CPU governor runs offline renders at full quality", "[governor]")
+{
+    CpuGovernor governor;
+    governor.prepare(sampleRate);
+    run(governor, 0.95, 20);
+    REQUIRE(governor.getLevel() == 2);
+
+    CHECK(governor.endBlock(10 * (std::uint64_t)1.0e9, blockSize, true));
+    CHECK(governor.getLevel() == 0);
+    CHECK_FALSE(governor.endBlock(10 * (std::uint64_t)1.0e9, blockSize, true));
+}
@@ -0,0 +1,120 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "DelayEngine.h"
+#include "RingEngine.h"
+
+// The Eco tier runs the delay lines and the ring modulator oscillators at
+// half rate: the delay times and the modulator pitches must not change, also
+// when the pairs of samples are split across process() calls
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+
+// Processes one channel in calls of odd lengths, so that pairs straddle them
+template <typename Engine>
+void processInChunks(Engine& engine, std::vector<float>& channel)
+{
+    const int numSamples = (int)channel.size();
+
+    for (int start = 0, length = 1; start < numSamples; start += length, length += 2)
+    {
+        length = std::min(length, numSamples - start);
+        float* data = channel.data() + start;
+        engine.process(&data, 1, length);
+    }
+}
+
+int countZeroCrossings(const std::vector<float>& data)
+{
+    int crossings = 0;
+
+    for (size_t i = 1; i < data.size(); ++i)
+    {
+        crossings += (data[i - 1] < 0.0f) != (data[i] < 0.0f) ? 1 : 0;
+    }
+
+    return crossings;
+}
+}
+
+TEST_CASE("Delay at half rate keeps the delay time", "[halfrate]")
+{
+    DelayEngine::Parameters parameters;
+    parameters.master.wet = 0.0f;
+    parameters.channels.at(0).time = 10.0f;
+    parameters.channels.at(0).wet = 100.0f;
+
+    DelayEngine engine;
+    engine.prepare(sampleRate, blockSize, 1);
+    engine.setParameters(parameters);
+    engine.jumpToTargets();
+    engine.setHalfRate(true);
+
+    std::vector<float> channel(2000, 0.0f);
+    channel[0] = 1.0f;
+    processInChunks(engine, channel);
+
+    const auto peak = std::max_element(channel.begin(), channel.end(), [](float a, float b) { return std::abs(a) < std::abs(b); });
+    const auto position = (int)(peak - channel.begin());
+
+    // Ten milliseconds, give or take the pair and the interpolation
+    CHECK(position >= 480);
+    CHECK(position <= 484);
+    CHECK(std::abs(*peak) > 0.2f);
+}
+
+TEST_CASE("Ring at half rate keeps the pitch of the oscillators", "[halfrate]")
+{
+    RingEngine::Parameters parameters;
+    parameters.master.wet = 0.0f;
+    parameters.channels.at(0).mod = 0;
+    parameters.channels.at(0).freq = 440.0f;
+    parameters.channels.at(0).wet = 100.0f;
+
+    std::vector<std::vector<float>> outputs;
+
+    for (const bool halfRate : {false, true})
+    {
+        RingEngine engine;
+        engine.prepare(sampleRate, blockSize, 1);
+        engine.setParameters(parameters);
+        engine.jumpToTargets();
+        engine.setHalfRate(halfRate);
+
+        std::vector<float> channel(4800, 1.0f);
+        processInChunks(engine, channel);
+        outputs.push_back(channel);
+    }
+
+    CHECK(std::abs(countZeroCrossings(outputs[0]) - countZeroCrossings(outputs[1])) <= 1);
+
+    // Off by the lag of the interpolation, of about a sample and a half
+    float maxError = 0.0f;
+    for (size_t i = 0; i < outputs[0].size(); ++i)
+    {
+        maxError = std::max(maxError, std::abs(outputs[0][i] - outputs[1][i]));
+    }
+
+    CHECK(maxError < 0.15f);
+}
@@ -0,0 +1,200 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <juce_dsp/juce_dsp.h>
+#include "LadderResponse.h"
+
+// The response Filter64 draws must be the one its ladders have: a quiet
+// sine, which keeps the saturation linear, is run through a ladder and its
+// level at the output compared with the computed magnitude. The ladders
+// themselves are a port of juce::dsp::LadderFilter, which they must follow.
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 480;
+constexpr float amplitude = 1.0e-3f;
+
+// Level in dB of a sine at frequency through a filter set up the way
+// FilterEngine sets up its stages, measured over a whole number of cycles
+// once the filter has settled
+float measureDecibels(const FilterEngine::StageParameters& stage, double frequency)
+{
+    // Prepared last, which starts it at its settings with a clear state
+    auto ladders = std::make_unique<LadderBank>();
+    ladders->setMode(0, static_cast<LadderBank::Mode>(stage.type - 1));
+    ladders->setCutoff(0, stage.cutoff);
+    ladders->setResonance(0, stage.resonance * 0.01f);
+    ladders->setDrive(0, juce::jmap(stage.drive, 0.0f, 100.0f, 1.0f, 10.0f));
+    ladders->setEnabled(0, true);
+    ladders->prepare(sampleRate);
+
+    const int settleSamples = (int)sampleRate / 4;
+    const int measureSamples = (int)sampleRate;
+    const double omega = 2.0 * juce::MathConstants<double>::pi * frequency / sampleRate;
+
+    std::vector<float> block((size_t)blockSize);
+    double real = 0.0;
+    double imaginary = 0.0;
+
+    for (int start = 0; start < settleSamples + measureSamples; start += blockSize)
+    {
+        for (int i = 0; i < blockSize; ++i)
+        {
+            block[(size_t)i] = amplitude * (float)std::sin(omega * (start + i));
+        }
+
+        ladders->processChannel(0, block.data(), blockSize);
+
+        for (int i = 0; i < blockSize && start >= settleSamples; ++i)
+        {
+            real += block[(size_t)i] * std::cos(omega * (start + i));
+            imaginary += block[(size_t)i] * std::sin(omega * (start + i));
+        }
+    }
+
+    const double level = 2.0 * std::hypot(real, imaginary) / measureSamples / amplitude;
+    return (float)(20.0 * std::log10(level));
+}
+}
+
+TEST_CASE("Ladder response matches the ladder filter", "[filter]")
+{
+    FilterEngine::StageParameters stage;
+    stage.type = GENERATE(1, 2, 3, 4, 5, 6);
+    stage.resonance = GENERATE(5.0f, 50.0f, 90.0f);
+    stage.drive = GENERATE(0.0f, 50.0f, 100.0f);
+    stage.cutoff = 1000.0f;
+
+    const LadderResponse response(stage, sampleRate);
+
+    for (const double frequency : {100.0, 250.0, 500.0, 1000.0, 2000.0, 4000.0, 10000.0})
+    {
+        INFO("type " << stage.type << ", resonance " << stage.resonance << ", drive " << stage.drive << ", " << frequency << " Hz");
+        const float expected = response.getMagnitudeDecibels(frequency);
+
+        // Deep in the stopband the level is too low to measure reliably
+        if (expected > -40.0f)
+        {
+            CHECK(std::abs(measureDecibels(stage, frequency) - expected) <= 0.5f);
+        }
+    }
+}
+
+TEST_CASE("Ladder response of a stage that is off is flat", "[filter]")
+{
+    const FilterEngine::StageParameters stage;
+    const LadderResponse response(stage, sampleRate);
+
+    CHECK(response.getMagnitudeDecibels(100.0) == 0.0f);
+    CHECK(response.getMagnitudeDecibels(10000.0) == 0.0f);
+}
+
+TEST_CASE("Ladder bank follows the JUCE ladder filter", "[filter]")
+{
+    const int mode = GENERATE(0, 1, 2, 3, 4, 5);
+    constexpr int numSamples = 4800;
+    constexpr float tolerance = 1.0e-2f;
+
+    // Driven hard with noise, the cutoff and resonance ramping halfway
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    std::vector<float> input((size_t)numSamples);
+
+    for (auto& sample : input)
+    {
+        sample = noise(generator);
+    }
+
+    juce::dsp::LadderFilter<float> filter;
+    filter.prepare({sampleRate, (juce::uint32)blockSize, 1});
+    auto ladders = std::make_unique<LadderBank>();
+    ladders->prepare(sampleRate);
+
+    auto setUp = [&](float cutoff, float resonance)
+    {
+        filter.setCutoffFrequencyHz(cutoff);
+        filter.setResonance(resonance);
+
+        for (int ch = 0; ch < 2 * LadderBank::lanes; ++ch)
+        {
+            ladders->setCutoff(ch, cutoff);
+            ladders->setResonance(ch, resonance);
+        }
+    };
+
+    filter.setMode(static_cast<juce::dsp::LadderFilterMode>(mode));
+    filter.setDrive(4.0f);
+
+    for (int ch = 0; ch < 2 * LadderBank::lanes; ++ch)
+    {
+        ladders->setMode(ch, static_cast<LadderBank::Mode>(mode));
+        ladders->setDrive(ch, 4.0f);
+        ladders->setEnabled(ch, ch != LadderBank::lanes + 2);
+    }
+
+    setUp(800.0f, 0.7f);
+
+    // Channel 0 runs alone, and the second group its lanes 0 to 5, lane 2
+    // being disabled
+    constexpr int numLanes = 6;
+    std::vector<float> expected = input;
+    std::vector<float> channel = input;
+    std::vector<float> frames((size_t)numSamples * LadderBank::lanes);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        for (int lane = 0; lane < LadderBank::lanes; ++lane)
+        {
+            frames[(size_t)(i * LadderBank::lanes + lane)] = input[(size_t)i];
+        }
+    }
+
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        if (start == numSamples / 2)
+        {
+            setUp(5000.0f, 0.2f);
+        }
+
+        float* data = expected.data() + start;
+        juce::dsp::AudioBlock<float> audioBlock(&data, 1, (size_t)blockSize);
+        juce::dsp::ProcessContextReplacing<float> context(audioBlock);
+        filter.process(context);
+
+        ladders->processChannel(0, channel.data() + start, blockSize);
+        ladders->processGroup(1, frames.data() + (size_t)start * LadderBank::lanes, blockSize, numLanes);
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        INFO("mode " << mode << ", sample " << i);
+        REQUIRE(std::abs(channel[(size_t)i] - expected[(size_t)i]) <= tolerance);
+
+        for (int lane = 0; lane < LadderBank::lanes; ++lane)
+        {
+            const float passed = lane == 2 || lane >= numLanes ? input[(size_t)i] : expected[(size_t)i];
+            REQUIRE(std::abs(frames[(size_t)(i * LadderBank::lanes + lane)] - passed) <= tolerance);
+        }
+    }
+}
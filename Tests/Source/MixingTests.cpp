@@ -0,0 +1,94 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <catch2/catch_test_macros.hpp>
+#include "Mixing.h"
+
+TEST_CASE("Linear crossfades", "[mixing]")
+{
+    constexpr int numSamples = 37;
+    std::array<float, numSamples> dry{};
+    std::array<float, numSamples> wet{};
+    std::array<float, numSamples> mixes{};
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        dry.at((size_t)i) = std::sin(0.1f * (float)i);
+        wet.at((size_t)i) = std::cos(0.3f * (float)i);
+        mixes.at((size_t)i) = (float)i / (float)(numSamples - 1);
+    }
+
+    std::array<float, numSamples> out{};
+
+    Mixing::crossfade(out.data(), dry.data(), wet.data(), 0.0f, numSamples);
+    CHECK(out == dry);
+
+    Mixing::crossfade(out.data(), dry.data(), wet.data(), 1.0f, numSamples);
+    CHECK(out == wet);
+
+    // Ramped from dry to wet, and the same in place
+    Mixing::crossfade(out.data(), dry.data(), wet.data(), mixes.data(), numSamples);
+    CHECK(out.front() == dry.front());
+    CHECK(out.back() == wet.back());
+
+    auto inPlace = dry;
+    Mixing::crossfade(inPlace.data(), wet.data(), mixes.data(), numSamples);
+    CHECK(inPlace == out);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto k = (size_t)i;
+        CHECK(std::abs(out.at(k) - (wet.at(k) * mixes.at(k) + dry.at(k) * (1.0f - mixes.at(k)))) <= 1.0e-6f);
+    }
+}
+
+TEST_CASE("Equal-power crossfades keep the power", "[mixing]")
+{
+    constexpr int numSamples = 101;
+    std::array<float, numSamples> ones{};
+    std::array<float, numSamples> zeros{};
+    std::array<float, numSamples> mixes{};
+    std::array<float, numSamples> dryGains{};
+    std::array<float, numSamples> wetGains{};
+
+    ones.fill(1.0f);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        mixes.at((size_t)i) = (float)i / (float)(numSamples - 1);
+    }
+
+    // Crossfading between one and zero gives the gain of either side
+    Mixing::equalPowerCrossfade(dryGains.data(), ones.data(), zeros.data(), mixes.data(), numSamples);
+    Mixing::equalPowerCrossfade(wetGains.data(), zeros.data(), ones.data(), mixes.data(), numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto k = (size_t)i;
+        CHECK(std::abs(dryGains.at(k) * dryGains.at(k) + wetGains.at(k) * wetGains.at(k) - 1.0f) <= 1.0e-5f);
+        CHECK(std::abs(wetGains.at(k) - std::sin(mixes.at(k) * 1.57079632679f)) <= 1.0e-5f);
+    }
+
+    // The constant mix matches the ramped one
+    std::array<float, numSamples> constant{};
+    Mixing::equalPowerCrossfade(constant.data(), ones.data(), zeros.data(), 0.25f, numSamples);
+    CHECK(constant.front() == dryGains.at(25));
+}
@@ -0,0 +1,205 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <cmath>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "ModulationMatrix.h"
+#include "RingEngine.h"
+
+// The matrix must keep its routes grouped by channel whatever order they are
+// given in, a single input route at unity weight must modulate a stage
+// exactly like the CH INPUT modulator does, and the sources must be read
+// unprocessed whether they are snapshotted or read in place
+
+TEST_CASE("Modulation matrix groups the routes by channel", "[matrix]")
+{
+    const std::vector<ModulationMatrix::Route> routes
+    {
+        {5, 1, false, 0.5f},
+        {2, 0, true, 0.25f},
+        {5, 3, true, 1.0f},
+        {0, 7, false, -1.0f}
+    };
+
+    ModulationMatrix matrix;
+    CHECK(matrix.setRoutes(routes.data(), (int)routes.size()));
+    REQUIRE(matrix.getNumRoutes() == 4);
+
+    CHECK(matrix.hasRow(0));
+    CHECK_FALSE(matrix.hasRow(1));
+    CHECK(matrix.rowEnd(5) - matrix.rowBegin(5) == 2);
+
+    // By channel, in the given order within a channel
+    const auto first = matrix.getRoute(0);
+    CHECK((first.channel == 0 && first.source == 7 && !first.oscillator && first.weight == -1.0f));
+    const auto second = matrix.getRoute(1);
+    CHECK((second.channel == 2 && second.source == 0 && second.oscillator));
+    CHECK((matrix.getRoute(2).channel == 5 && matrix.getRoute(2).source == 1));
+    CHECK((matrix.getRoute(3).channel == 5 && matrix.getRoute(3).oscillator));
+}
+
+TEST_CASE("Modulation matrix drops invalid routes", "[matrix]")
+{
+    const std::vector<ModulationMatrix::Route> invalid
+    {
+        {MAX_CHANS, 0, false, 1.0f},
+        {0, ModulationMatrix::numOscillators, true, 1.0f},
+        {1, -1, false, 1.0f},
+        {1, 2, false, 1.0f}
+    };
+
+    ModulationMatrix matrix;
+    CHECK_FALSE(matrix.setRoutes(invalid.data(), (int)invalid.size()));
+    CHECK(matrix.getNumRoutes() == 1);
+    CHECK(matrix.hasRow(1));
+
+    const std::vector<ModulationMatrix::Route> tooMany((size_t)ModulationMatrix::maxRoutes + 1, {0, 0, false, 1.0f});
+    CHECK_FALSE(matrix.setRoutes(tooMany.data(), (int)tooMany.size()));
+    CHECK(matrix.getNumRoutes() == ModulationMatrix::maxRoutes);
+}
+
+TEST_CASE("An input route modulates like the CH INPUT modulator", "[matrix]")
+{
+    constexpr int numChannels = 4;
+    constexpr int numSamples = 1000;
+    constexpr int blockSize = 256;
+
+    std::vector<std::vector<float>> direct(numChannels, std::vector<float>(numSamples));
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            direct[(size_t)ch][(size_t)i] = std::sin(0.01f * (float)((ch + 1) * i));
+        }
+    }
+    auto routed = direct;
+
+    RingEngine::Parameters parameters;
+    parameters.master.wet = 0.0f;
+    parameters.channels.at(0).wet = 100.0f;
+
+    RingEngine directEngine;
+    directEngine.prepare(48000.0, blockSize, numChannels);
+    parameters.channels.at(0).mod = 4;
+    parameters.channels.at(0).modCh = 3;
+    directEngine.setParameters(parameters);
+    directEngine.jumpToTargets();
+
+    RingEngine routedEngine;
+    routedEngine.prepare(48000.0, blockSize, numChannels);
+    parameters.channels.at(0).mod = 0;
+    parameters.channels.at(0).modCh = 1;
+    routedEngine.setParameters(parameters);
+    routedEngine.jumpToTargets();
+
+    const ModulationMatrix::Route route{0, 2, false, 1.0f};
+    ModulationMatrix matrix;
+    matrix.setRoutes(&route, 1);
+    routedEngine.setModulationMatrix(matrix);
+    routedEngine.setMatrixEnabled(true);
+
+    std::vector<float*> directPointers, routedPointers;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        directPointers.push_back(direct[(size_t)ch].data());
+        routedPointers.push_back(routed[(size_t)ch].data());
+    }
+
+    directEngine.process(directPointers.data(), numChannels, numSamples);
+    routedEngine.process(routedPointers.data(), numChannels, numSamples);
+
+    float maxError = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            maxError = std::max(maxError, std::abs(direct[(size_t)ch][(size_t)i] - routed[(size_t)ch][(size_t)i]));
+        }
+    }
+
+    CHECK(maxError < 1.0e-6f);
+}
+
+TEST_CASE("Matrix sources are read unprocessed", "[matrix]")
+{
+    constexpr int numChannels = 4;
+    constexpr int numSamples = 1000;
+    constexpr int blockSize = 256;
+
+    std::vector<std::vector<float>> input(numChannels, std::vector<float>(numSamples));
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            input[(size_t)ch][(size_t)i] = std::sin(0.01f * (float)((ch + 1) * i));
+        }
+    }
+    auto output = input;
+
+    RingEngine::Parameters parameters;
+    parameters.master.wet = 0.0f;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        parameters.channels.at((size_t)ch).wet = 100.0f;
+    }
+
+    RingEngine engine;
+    engine.prepare(48000.0, blockSize, numChannels);
+    engine.setParameters(parameters);
+    engine.jumpToTargets();
+
+    // Channel 1 is read by channel 0 only, before it is processed, so it is
+    // read in place; channels 0 and 2 are read at or after their own turn,
+    // so they are snapshotted
+    const std::vector<ModulationMatrix::Route> routes
+    {
+        {0, 1, false, 1.0f},
+        {1, 0, false, 1.0f},
+        {2, 2, false, 1.0f},
+        {3, 0, false, 1.0f}
+    };
+    const std::vector<int> sources{1, 0, 2, 0};
+
+    ModulationMatrix matrix;
+    matrix.setRoutes(routes.data(), (int)routes.size());
+    engine.setModulationMatrix(matrix);
+    engine.setMatrixEnabled(true);
+
+    std::vector<float*> pointers;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        pointers.push_back(output[(size_t)ch].data());
+    }
+
+    engine.process(pointers.data(), numChannels, numSamples);
+
+    float maxError = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const auto& source = input[(size_t)sources.at((size_t)ch)];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float expected = input[(size_t)ch][(size_t)i] * source[(size_t)i];
+            maxError = std::max(maxError, std::abs(output[(size_t)ch][(size_t)i] - expected));
+        }
+    }
+
+    CHECK(maxError < 1.0e-5f);
+}
@@ -0,0 +1,126 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include "HalfBandOversampler.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 480;
+    constexpr int numBlocks = 40;
+
+    float sine(double frequency, double rate, long n)
+    {
+        return (float)std::sin(2.0 * 3.14159265358979323846 * frequency * (double)n / rate);
+    }
+}
+
+TEST_CASE("Oversampling round trip only delays the signal", "[oversampling]")
+{
+    const int factor = GENERATE(1, 2, 4);
+    const int numChannels = GENERATE(1, 3, HalfBandOversampler::lanes);
+    INFO(factor << "x / " << numChannels << " channels");
+
+    HalfBandOversampler oversampler;
+    oversampler.prepare(blockSize);
+    oversampler.setFactor(factor);
+    const int latency = oversampler.getLatencySamples();
+
+    // A different tone per channel, well inside the passband
+    std::vector<std::vector<float>> input((size_t)numChannels), output((size_t)numChannels);
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        for (long n = 0; n < (long)(blockSize * numBlocks); ++n)
+        {
+            input[(size_t)ch].push_back(sine(500.0 + 1500.0 * ch, sampleRate, n));
+        }
+        output[(size_t)ch] = input[(size_t)ch];
+    }
+
+    std::vector<float*> channels((size_t)numChannels);
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            channels[(size_t)ch] = output[(size_t)ch].data() + block * blockSize;
+        }
+
+        oversampler.upsample(channels.data(), numChannels, 0, blockSize);
+        oversampler.downsample(channels.data(), numChannels, 0, blockSize);
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float difference = 0.0f;
+
+        for (size_t n = (size_t)blockSize; n < output[(size_t)ch].size(); ++n)
+        {
+            difference = std::max(difference, std::abs(output[(size_t)ch][n] - input[(size_t)ch][n - (size_t)latency]));
+        }
+
+        // Within the passband ripple, about -75 dB
+        CHECK(difference <= 1.0e-3f);
+    }
+}
+
+TEST_CASE("Oversampling rejects what would alias", "[oversampling]")
+{
+    const int factor = GENERATE(2, 4);
+    // Above the base Nyquist frequency, and for 4x above twice it
+    const double frequency = GENERATE(30000.0, 60000.0);
+
+    if (frequency * 2.0 >= sampleRate * factor)
+    {
+        SKIP();
+    }
+
+    INFO(factor << "x / " << frequency << " Hz");
+
+    HalfBandOversampler oversampler;
+    oversampler.prepare(blockSize);
+    oversampler.setFactor(factor);
+
+    std::vector<float> data((size_t)blockSize);
+    float* channels[] = {data.data()};
+    float peak = 0.0f;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        std::fill(data.begin(), data.end(), 0.0f);
+        float* frames = oversampler.upsample(channels, 1, 0, blockSize);
+
+        // Generated at the oversampled rate, as a saturating filter would
+        for (int i = 0; i < blockSize * factor; ++i)
+        {
+            frames[i * HalfBandOversampler::lanes] = sine(frequency, sampleRate * factor, (long)(block * blockSize * factor + i));
+        }
+
+        oversampler.downsample(channels, 1, 0, blockSize);
+
+        if (block > 0)
+        {
+            peak = std::max(peak, *std::max_element(data.begin(), data.end(), [](float a, float b) { return std::abs(a) < std::abs(b); }));
+        }
+    }
+
+    CHECK(std::abs(peak) <= 1.0e-4f);
+}
@@ -0,0 +1,330 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "PresetBank.h"
+
+// Presets are decoded with the defaults of the parameters they leave out,
+// and switching to one, or applying an edit, sets every parameter in one go.
+// The morph interpolates the parameters that differ between its scenes,
+// until they are changed.
+
+namespace
+{
+// A processor with two continuous parameters, a choice and the morph
+class BankProcessor : public juce::AudioProcessor
+{
+public:
+    BankProcessor() :
+        treeState(*this, nullptr, "PARAMETERS", createLayout())
+    {
+        level = dynamic_cast<juce::AudioParameterFloat*>(treeState.getParameter("level"));
+        mode = dynamic_cast<juce::AudioParameterFloat*>(treeState.getParameter("mode"));
+        width = dynamic_cast<juce::AudioParameterFloat*>(treeState.getParameter("width"));
+        morph = dynamic_cast<juce::AudioParameterFloat*>(treeState.getParameter(PresetBank::morphParameterID));
+    }
+
+    const juce::String getName() const override { return "BankProcessor"; }
+    void prepareToPlay(double, int) override {}
+    void releaseResources() override {}
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override {}
+    double getTailLengthSeconds() const override { return 0.0; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+    juce::AudioProcessorValueTreeState treeState;
+    juce::AudioParameterFloat* level = nullptr;
+    juce::AudioParameterFloat* mode = nullptr;
+    juce::AudioParameterFloat* width = nullptr;
+    juce::AudioParameterFloat* morph = nullptr;
+
+private:
+    static juce::AudioProcessorValueTreeState::ParameterLayout createLayout()
+    {
+        juce::AudioProcessorValueTreeState::ParameterLayout layout;
+        layout.add(std::make_unique<juce::AudioParameterFloat>("level", "Level", juce::NormalisableRange<float>(0.0f, 100.0f), 50.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>("mode", "Mode", juce::NormalisableRange<float>(0.0f, 3.0f, 1.0f), 1.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>("width", "Width", juce::NormalisableRange<float>(0.0f, 100.0f), 100.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(PresetBank::morphParameterID, "Morph", juce::NormalisableRange<float>(0.0f, 100.0f), 0.0f));
+        return layout;
+    }
+};
+
+void set(juce::AudioParameterFloat* parameter, float value)
+{
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+float read(PresetBank& bank, const juce::AudioParameterFloat* parameter)
+{
+    const PresetBank::Reader reader(bank);
+    return reader(parameter);
+}
+}
+
+TEST_CASE("Presets take the defaults of the parameters they leave out", "[presets]")
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    BankProcessor processor;
+    PresetBank bank(processor.treeState);
+
+    juce::XmlElement presetXml("PRESET");
+    auto* levelXml = presetXml.createNewChildElement("PARAM");
+    levelXml->setAttribute("id", "level");
+    levelXml->setAttribute("value", 20.0);
+
+    auto values = bank.decodeValues(presetXml);
+    REQUIRE(values.size() == 4);
+    CHECK(values[(size_t)bank.indexOf(processor.level)] == 20.0f);
+    CHECK(values[(size_t)bank.indexOf(processor.mode)] == 1.0f);
+    CHECK(values[(size_t)bank.indexOf(processor.width)] == 100.0f);
+    CHECK(values[(size_t)bank.indexOf(processor.morph)] == 0.0f);
+
+    // Values out of range are brought back into it
+    auto* modeXml = presetXml.createNewChildElement("PARAM");
+    modeXml->setAttribute("id", "mode");
+    modeXml->setAttribute("value", 7.0);
+
+    values = bank.decodeValues(presetXml);
+    CHECK(values[(size_t)bank.indexOf(processor.mode)] == 3.0f);
+}
+
+TEST_CASE("Selecting a preset sets its values", "[presets]")
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    BankProcessor processor;
+    PresetBank bank(processor.treeState);
+
+    set(processor.level, 20.0f);
+    set(processor.mode, 2.0f);
+    CHECK(bank.add("First") == 0);
+
+    set(processor.level, 80.0f);
+    set(processor.mode, 0.0f);
+    CHECK(bank.add("Second") == 1);
+    CHECK(bank.getCurrentIndex() == 1);
+    CHECK(bank.getName(0) == "First");
+
+    bank.select(0);
+    CHECK(bank.getCurrentIndex() == 0);
+    CHECK(processor.level->get() == 20.0f);
+    CHECK(processor.mode->get() == 2.0f);
+    CHECK(read(bank, processor.level) == 20.0f);
+
+    // The engines ramp to the values, unless the crossfade is off
+    CHECK_FALSE(bank.takeJump());
+    bank.setCrossfade(false);
+    bank.select(1);
+    CHECK(bank.takeJump());
+    CHECK(processor.level->get() == 80.0f);
+
+    // Indices that are not presets are ignored
+    bank.select(2);
+    bank.select(-1);
+    CHECK(bank.getCurrentIndex() == 1);
+}
+
+TEST_CASE("Applying values sets every parameter", "[presets]")
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    BankProcessor processor;
+    PresetBank bank(processor.treeState);
+
+    auto values = bank.getCurrentValues();
+    values[(size_t)bank.indexOf(processor.level)] = 10.0f;
+    values[(size_t)bank.indexOf(processor.mode)] = 3.0f;
+    bank.apply(values);
+
+    CHECK(processor.level->get() == 10.0f);
+    CHECK(processor.mode->get() == 3.0f);
+    CHECK(bank.getCurrentValues() == values);
+    CHECK_FALSE(bank.takeJump());
+
+    // Values of another layout are ignored
+    bank.apply(std::vector<float>(3, 0.0f));
+    CHECK(processor.level->get() == 10.0f);
+}
+
+TEST_CASE("The morph interpolates between the scenes", "[presets]")
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    BankProcessor processor;
+    PresetBank bank(processor.treeState);
+    bank.setDiscrete(processor.mode);
+
+    set(processor.level, 20.0f);
+    set(processor.mode, 0.0f);
+    bank.add("A");
+
+    set(processor.level, 80.0f);
+    set(processor.mode, 2.0f);
+    bank.add("B");
+
+    bank.setMorphScenes(0, 1);
+
+    // Continuous parameters move along with the morph, choices switch halfway
+    const std::vector<float> amounts{0.0f, 25.0f, 49.0f, 50.0f, 75.0f, 100.0f};
+    const std::vector<float> levels{20.0f, 35.0f, 49.4f, 50.0f, 65.0f, 80.0f};
+    const std::vector<float> modes{0.0f, 0.0f, 0.0f, 2.0f, 2.0f, 2.0f};
+
+    for (size_t i = 0; i < amounts.size(); ++i)
+    {
+        set(processor.morph, amounts.at(i));
+        CHECK(std::abs(read(bank, processor.level) - levels.at(i)) <= 1.0e-4f);
+        CHECK(read(bank, processor.mode) == modes.at(i));
+    }
+
+    // The parameters themselves do not move
+    CHECK(processor.level->get() == 80.0f);
+    CHECK(processor.mode->get() == 2.0f);
+
+    // Nor does anything once the scenes are cleared
+    bank.setMorphScenes(-1, -1);
+    CHECK(read(bank, processor.level) == 80.0f);
+}
+
+TEST_CASE("The morph leaves the parameters that are changed", "[presets]")
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    BankProcessor processor;
+    PresetBank bank(processor.treeState);
+    bank.setDiscrete(processor.mode);
+
+    set(processor.level, 20.0f);
+    set(processor.mode, 0.0f);
+    bank.add("A");
+
+    set(processor.level, 80.0f);
+    set(processor.mode, 2.0f);
+    bank.add("B");
+
+    set(processor.morph, 25.0f);
+    bank.setMorphScenes(0, 1);
+    CHECK(read(bank, processor.level) == 35.0f);
+
+    // Parameters the scenes share are not morphed
+    set(processor.width, 40.0f);
+    CHECK(read(bank, processor.width) == 40.0f);
+
+    // An edit is heard, while the other parameters keep following the morph
+    set(processor.level, 10.0f);
+    CHECK(read(bank, processor.level) == 10.0f);
+    CHECK(read(bank, processor.mode) == 0.0f);
+
+    // And stays heard when the value goes back
+    set(processor.level, 80.0f);
+    CHECK(read(bank, processor.level) == 80.0f);
+
+    // So is a preset switch
+    bank.select(0);
+    CHECK(read(bank, processor.mode) == 0.0f);
+    set(processor.morph, 100.0f);
+    CHECK(read(bank, processor.mode) == 0.0f);
+    CHECK(read(bank, processor.level) == 20.0f);
+
+    // Assigning the scenes again morphs every parameter again
+    bank.setMorphScenes(0, 1);
+    CHECK(read(bank, processor.level) == 80.0f);
+    CHECK(read(bank, processor.mode) == 2.0f);
+}
+
+TEST_CASE("Blocks ramp the parameters that changed in control steps", "[presets]")
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    BankProcessor processor;
+    PresetBank bank(processor.treeState);
+    bank.setDiscrete(processor.mode);
+
+    constexpr int interval = PresetBank::controlInterval;
+    const auto readStep = [&bank](const juce::AudioParameterFloat* parameter, int step)
+    {
+        const PresetBank::Reader reader(bank, step);
+        return reader(parameter);
+    };
+
+    // The first block, and blocks where nothing changed, take one step
+    set(processor.level, 20.0f);
+    CHECK(bank.beginRamp(4 * interval) == 1);
+    CHECK(readStep(processor.level, 0) == 20.0f);
+    CHECK(bank.beginRamp(4 * interval) == 1);
+
+    if constexpr (interval > 0)
+    {
+        // Continuous parameters move to the end of each step, choices switch
+        // at the start
+        set(processor.level, 60.0f);
+        set(processor.mode, 3.0f);
+        REQUIRE(bank.beginRamp(4 * interval) == 4);
+
+        const std::vector<float> levels{30.0f, 40.0f, 50.0f, 60.0f};
+        for (int step = 0; step < 4; ++step)
+        {
+            CHECK(std::abs(readStep(processor.level, step) - levels.at((size_t)step)) <= 1.0e-4f);
+            CHECK(readStep(processor.mode, step) == 3.0f);
+        }
+
+        // A choice alone does not split the block, nor a jump
+        set(processor.mode, 0.0f);
+        CHECK(bank.beginRamp(4 * interval) == 1);
+
+        bank.setCrossfade(false);
+        bank.add("Preset");
+        set(processor.level, 10.0f);
+        CHECK(bank.beginRamp(4 * interval) == 4);
+        bank.select(0);
+        CHECK(bank.beginRamp(4 * interval) == 1);
+        CHECK(bank.takeJump());
+        CHECK(std::abs(readStep(processor.level, 0) - 60.0f) <= 1.0e-4f);
+
+        // Blocks of a partial step end on it
+        set(processor.level, 0.0f);
+        REQUIRE(bank.beginRamp(interval + 1) == 2);
+        CHECK(readStep(processor.level, 1) == 0.0f);
+    }
+
+    // Processing a block goes through the steps in order, over its samples
+    std::vector<float> samples((size_t)(3 * std::max(interval, 1)), 0.0f);
+    float* channels[1]{samples.data()};
+    set(processor.level, 90.0f);
+
+    int numSteps = 0;
+    int numSamples = 0;
+    bank.processSteps(channels, 1, (int)samples.size(),
+        [&numSteps](int step) { CHECK(step == numSteps); },
+        [&](float* const* stepChannels, int, int stepSamples)
+        {
+            CHECK(stepChannels[0] == samples.data() + numSamples);
+            numSamples += stepSamples;
+            ++numSteps;
+        });
+
+    CHECK(numSamples == (int)samples.size());
+    CHECK(numSteps == (interval > 0 ? 3 : 1));
+}
@@ -0,0 +1,242 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "DelayLine.h"
+#include "LadderBank.h"
+#include "QualityTier.h"
+#include "RingOscillator.h"
+
+// Auto must run Standard while playing and High while rendering, and the
+// paths of High must be more accurate than those they replace: the cubic
+// delay read, the band-limited triangle and the exact saturation
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr double pi = 3.14159265358979323846;
+
+double rmsError(const std::vector<float>& output, const std::vector<double>& expected, size_t start)
+{
+    double sum = 0.0;
+
+    for (size_t i = start; i < output.size(); ++i)
+    {
+        sum += (output[i] - expected[i]) * (output[i] - expected[i]);
+    }
+
+    return std::sqrt(sum / (double)(output.size() - start));
+}
+
+// RMS level of what is left of a periodic signal once its harmonics below
+// Nyquist are taken out, increment being its frequency over the sample rate
+double measureAliases(const std::vector<float>& signal, double increment)
+{
+    std::vector<double> residual(signal.begin(), signal.end());
+    const double size = (double)signal.size();
+
+    for (int k = 1; k * increment < 0.5; ++k)
+    {
+        double real = 0.0;
+        double imaginary = 0.0;
+
+        for (size_t i = 0; i < signal.size(); ++i)
+        {
+            real += signal[i] * std::cos(2.0 * pi * k * increment * (double)i);
+            imaginary += signal[i] * std::sin(2.0 * pi * k * increment * (double)i);
+        }
+
+        for (size_t i = 0; i < signal.size(); ++i)
+        {
+            residual[i] -= 2.0 / size * (real * std::cos(2.0 * pi * k * increment * (double)i) + imaginary * std::sin(2.0 * pi * k * increment * (double)i));
+        }
+    }
+
+    double sum = 0.0;
+
+    for (const double sample : residual)
+    {
+        sum += sample * sample;
+    }
+
+    return std::sqrt(sum / size);
+}
+}
+
+TEST_CASE("Auto quality follows offline rendering", "[quality]")
+{
+    using Tier = QualityTier::Tier;
+    auto parameter = QualityTier::createParameter();
+
+    CHECK(QualityTier::isAuto(*parameter));
+    CHECK(QualityTier::resolve(*parameter, false) == Tier::standard);
+    CHECK(QualityTier::resolve(*parameter, true) == Tier::high);
+    CHECK(QualityTier::resolve(*parameter, true, 1) == Tier::standard);
+    CHECK(QualityTier::resolve(*parameter, false, 5) == Tier::eco);
+    CHECK(QualityTier::resolveLatency(*parameter) == Tier::high);
+
+    *parameter = 2.0f;
+    CHECK(QualityTier::resolve(*parameter, true) == Tier::standard);
+    CHECK(QualityTier::resolveLatency(*parameter) == Tier::standard);
+
+    *parameter = 3.0f;
+    CHECK(QualityTier::resolve(*parameter, false) == Tier::high);
+    CHECK(QualityTier::resolve(*parameter, false, 1) == Tier::standard);
+}
+
+TEST_CASE("Cubic delay read keeps the highs of a fractional time", "[quality]")
+{
+    // 10.37 samples, with a sine at a quarter of the sample rate
+    constexpr double delay = 10.37;
+    constexpr double omega = 2.0 * pi * 0.25 * 0.87;
+    constexpr int numSamples = 4800;
+
+    std::vector<double> expected((size_t)numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        expected[(size_t)i] = std::sin(omega * (i - delay));
+    }
+
+    auto render = [&](DelayLine::Interpolation interpolation)
+    {
+        DelayLine line;
+        line.prepare(sampleRate, 10.0f);
+        line.setTime((float)(delay * 1000.0 / sampleRate));
+        line.setInterpolation(interpolation);
+
+        std::vector<float> output((size_t)numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            output[(size_t)i] = line.run((float)std::sin(omega * i));
+        }
+
+        return output;
+    };
+
+    const double linearError = rmsError(render(DelayLine::Interpolation::linear), expected, 100);
+    const double cubicError = rmsError(render(DelayLine::Interpolation::cubic), expected, 100);
+
+    INFO("linear " << linearError << ", cubic " << cubicError);
+    CHECK(cubicError < 0.5 * linearError);
+}
+
+TEST_CASE("Ring oscillator triangle is band-limited", "[quality]")
+{
+    // An inharmonic frequency, so that the aliases of the naive corners fall
+    // between the harmonics
+    constexpr double frequency = 4567.0;
+    constexpr double increment = frequency / sampleRate;
+    constexpr int numSamples = 48000;
+
+    // The naive triangle the oscillator rounds off
+    std::vector<float> naive((size_t)numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double peakPhase = std::fmod(increment * i + 0.75, 1.0);
+        naive[(size_t)i] = (float)(2.0 * std::abs(2.0 * peakPhase - 1.0) - 1.0);
+    }
+
+    RingOscillator oscillator;
+    oscillator.setSampleRate(sampleRate);
+    oscillator.setFrequency((float)frequency);
+    oscillator.setWaveform(RingOscillator::Waveform::triangle);
+
+    const std::vector<float> ones((size_t)numSamples, 1.0f);
+    std::vector<float> rounded((size_t)numSamples);
+    oscillator.process(ones.data(), rounded.data(), numSamples);
+
+    const double naiveAliases = measureAliases(naive, increment);
+    const double roundedAliases = measureAliases(rounded, increment);
+
+    INFO("naive " << naiveAliases << ", rounded " << roundedAliases);
+    CHECK(roundedAliases < 0.25 * naiveAliases);
+}
+
+TEST_CASE("Exact ladder saturation stays close to the table", "[quality]")
+{
+    constexpr int numSamples = 4800;
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    std::vector<float> input((size_t)numSamples);
+
+    for (auto& sample : input)
+    {
+        sample = noise(generator);
+    }
+
+    auto render = [&](bool exact, bool grouped)
+    {
+        auto ladders = std::make_unique<LadderBank>();
+        ladders->setMode(0, LadderBank::Mode::lpf24);
+        ladders->setCutoff(0, 2000.0f);
+        ladders->setResonance(0, 0.8f);
+        ladders->setDrive(0, 8.0f);
+        ladders->setEnabled(0, true);
+        ladders->prepare(sampleRate);
+        ladders->setExactSaturation(exact);
+
+        std::vector<float> output = input;
+
+        if (grouped)
+        {
+            std::vector<float> frames((size_t)numSamples * LadderBank::lanes, 0.0f);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                frames[(size_t)i * LadderBank::lanes] = input[(size_t)i];
+            }
+
+            ladders->processGroup(0, frames.data(), numSamples, 1);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                output[(size_t)i] = frames[(size_t)i * LadderBank::lanes];
+            }
+        }
+        else
+        {
+            ladders->processChannel(0, output.data(), numSamples);
+        }
+
+        return output;
+    };
+
+    const auto table = render(false, false);
+    const auto exact = render(true, false);
+    const auto exactGrouped = render(true, true);
+
+    float tableDifference = 0.0f;
+    float groupDifference = 0.0f;
+
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        tableDifference = std::max(tableDifference, std::abs(exact[i] - table[i]));
+        groupDifference = std::max(groupDifference, std::abs(exact[i] - exactGrouped[i]));
+    }
+
+    CHECK(tableDifference > 0.0f);
+    CHECK(tableDifference < 1.0e-2f);
+    CHECK(groupDifference < 1.0e-5f);
+}
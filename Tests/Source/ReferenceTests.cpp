@@ -0,0 +1,71 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include "RenderHelpers.h"
+
+// Renders are compared against the files in Tests/References, recorded from
+// the build that introduced this suite with Tests/RecordReferences.cmake. A
+// missing reference fails: record it, or record them all again after a
+// change that is meant to alter the output, and commit the new files. The
+// references are not in the repository yet, so the comparison is marked
+// [!mayfail] and reports without failing the run until they are recorded.
+//
+// Each plugin has its own runner, built with PLUG64_SCENARIO set to its
+// scenario.
+
+using Scenario = PLUG64_SCENARIO;
+
+TEST_CASE("Renders match the stored references", "[reference][!mayfail]")
+{
+    const auto stimulus = GENERATE(Stimulus::impulse, Stimulus::sweep, Stimulus::noise, Stimulus::automation);
+    INFO(Scenario::name << " / " << getStimulusName(stimulus));
+
+    const auto render = renderScenario<Scenario>(stimulus, channelVariants, referenceBlockSize);
+    const auto path = getReferencePath(Scenario::name, stimulus);
+
+    if (shouldUpdateReferences())
+    {
+        saveReference(path, render);
+        SUCCEED("Updated " << path.string());
+        return;
+    }
+
+    const auto reference = loadReference(path);
+    if (!reference.has_value())
+    {
+        FAIL("Missing reference " << path.string() << ", record it with Tests/RecordReferences.cmake");
+    }
+
+    REQUIRE(reference->numChannels == render.numChannels);
+    REQUIRE(reference->numSamples == render.numSamples);
+    CHECK(maxDifference(render, *reference) <= Scenario::tolerance);
+}
+
+TEST_CASE("Output does not depend on the channel count", "[reference]")
+{
+    const auto stimulus = GENERATE(Stimulus::impulse, Stimulus::sweep, Stimulus::noise, Stimulus::automation);
+    const int numChannels = GENERATE(1, 2, MAX_CHANS);
+    INFO(Scenario::name << " / " << getStimulusName(stimulus) << " / " << numChannels << " channels");
+
+    const auto expected = renderScenario<Scenario>(stimulus, channelVariants, referenceBlockSize);
+    const auto render = renderScenario<Scenario>(stimulus, numChannels, referenceBlockSize);
+
+    CHECK(maxDifference(render, expected) <= Scenario::tolerance);
+}
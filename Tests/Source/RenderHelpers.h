@@ -0,0 +1,173 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Scenarios.h"
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+// Block size of the stored reference renders
+static constexpr int referenceBlockSize = 512;
+
+// Renders the stimulus through a fresh processor of the plugin the runner is
+// built for, split in host blocks of blockSize samples, as an offline render
+// so that the CPU governor stays out of the way. preparedBlockSize is the
+// size announced to prepareToPlay(), blockSize by default. With
+// Stimulus::automation the scenario ramp is applied through the parameters
+// at every control interval, so the result must not depend on blockSize.
+template <typename Scenario>
+Render renderScenario(Stimulus stimulus, int numChannels, int blockSize, int preparedBlockSize = 0, bool pipelined = false)
+{
+    Render render(numChannels, renderLength);
+    fillStimulus(render, stimulus);
+
+    std::unique_ptr<juce::AudioProcessor> processor(createPluginFilter());
+
+    auto layout = processor->getBusesLayout();
+    layout.getChannelSet(true, 0) = juce::AudioChannelSet::discreteChannels(numChannels);
+    layout.getChannelSet(false, 0) = juce::AudioChannelSet::discreteChannels(numChannels);
+    REQUIRE(processor->setBusesLayout(layout));
+
+    preparedBlockSize = preparedBlockSize > 0 ? preparedBlockSize : blockSize;
+    processor->setNonRealtime(true);
+    processor->setRateAndBufferSizeDetails(renderSampleRate, preparedBlockSize);
+
+    ParameterSetter set(*processor);
+    configureCommon(set);
+    Scenario::configure(set);
+    set.ifPresent("pipeline", pipelined ? 1.0f : 0.0f);
+
+    processor->prepareToPlay(renderSampleRate, preparedBlockSize);
+
+    std::vector<float*> pointers((size_t)numChannels);
+    juce::MidiBuffer midi;
+
+    for (int start = 0; start < render.numSamples;)
+    {
+        if (stimulus == Stimulus::automation && start % controlInterval == 0)
+        {
+            Scenario::automate(set, (float)start / (float)render.numSamples);
+        }
+
+        const int blockEnd = std::min((start / blockSize + 1) * blockSize, render.numSamples);
+        const int controlEnd = (start / controlInterval + 1) * controlInterval;
+        const int numSamples = std::min(blockEnd, controlEnd) - start;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            pointers[(size_t)ch] = render.channel(ch) + start;
+        }
+
+        juce::AudioBuffer<float> buffer(pointers.data(), numChannels, numSamples);
+        processor->processBlock(buffer, midi);
+        start += numSamples;
+    }
+
+    processor->releaseResources();
+    return render;
+}
+
+// Largest difference between every channel of actual and the channel of
+// expected with the same variant, over the first numSamples samples, after
+// skipping offset samples of actual
+inline float maxDifference(const Render& actual, const Render& expected, int offset = 0)
+{
+    float difference = 0.0f;
+    const int numSamples = std::min(actual.numSamples - offset, expected.numSamples);
+
+    for (int ch = 0; ch < actual.numChannels; ++ch)
+    {
+        const float* a = actual.channel(ch) + offset;
+        const float* e = expected.channel(ch % expected.numChannels);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            difference = std::max(difference, std::abs(a[i] - e[i]));
+        }
+    }
+
+    return difference;
+}
+
+// Reference renders are stored as "P64R", channel and sample counts as 32 bit
+// integers, then the samples of each channel in turn, all little endian
+inline std::filesystem::path getReferencePath(const char* scenario, Stimulus stimulus)
+{
+    return std::filesystem::path(PLUG64_REFERENCE_DIR) / (std::string(scenario) + "_" + getStimulusName(stimulus) + ".p64r");
+}
+
+inline bool shouldUpdateReferences()
+{
+    const char* update = std::getenv("PLUG64_UPDATE_REFERENCES");
+    return update != nullptr && std::string(update) == "1";
+}
+
+inline std::optional<Render> loadReference(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return std::nullopt;
+    }
+
+    char magic[4] = {};
+    std::int32_t numChannels = 0;
+    std::int32_t numSamples = 0;
+    file.read(magic, 4);
+    file.read(reinterpret_cast<char*>(&numChannels), sizeof(numChannels));
+    file.read(reinterpret_cast<char*>(&numSamples), sizeof(numSamples));
+
+    if (!file || std::string(magic, 4) != "P64R" || numChannels < 1 || numSamples < 1)
+    {
+        return std::nullopt;
+    }
+
+    Render render(numChannels, numSamples);
+    file.read(reinterpret_cast<char*>(render.samples.data()), (std::streamsize)(render.samples.size() * sizeof(float)));
+
+    if (!file)
+    {
+        return std::nullopt;
+    }
+
+    return render;
+}
+
+inline void saveReference(const std::filesystem::path& path, const Render& render)
+{
+    std::filesystem::create_directories(path.parent_path());
+
+    std::ofstream file(path, std::ios::binary);
+    const std::int32_t numChannels = render.numChannels;
+    const std::int32_t numSamples = render.numSamples;
+    file.write("P64R", 4);
+    file.write(reinterpret_cast<const char*>(&numChannels), sizeof(numChannels));
+    file.write(reinterpret_cast<const char*>(&numSamples), sizeof(numSamples));
+    file.write(reinterpret_cast<const char*>(render.samples.data()), (std::streamsize)(render.samples.size() * sizeof(float)));
+}
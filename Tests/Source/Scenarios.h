@@ -0,0 +1,274 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <cmath>
+#include <map>
+#include <catch2/catch_test_macros.hpp>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "Stimulus.h"
+
+// Per-plugin settings for the renders: the parameters of each channel
+// variant, the automation ramp applied with Stimulus::automation, and the
+// largest difference from a reference that is still accepted. Tolerances are
+// looser for the plugins with nonlinear or oscillator based processing.
+//
+// The settings go through the parameters of the processor, by ID and in
+// plain values, so that the renders also cover the parameter mapping of the
+// plugin wrappers.
+
+class ParameterSetter
+{
+public:
+    explicit ParameterSetter(juce::AudioProcessor& processor)
+    {
+        for (auto* parameter : processor.getParameters())
+        {
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            {
+                parameters[ranged->getParameterID()] = ranged;
+            }
+        }
+    }
+
+    void operator()(const juce::String& parameterID, float value)
+    {
+        auto* parameter = find(parameterID);
+        INFO("Parameter " << parameterID);
+        REQUIRE(parameter != nullptr);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    // For parameters added after the references were recorded, which the
+    // baseline build does not have
+    void ifPresent(const juce::String& parameterID, float value)
+    {
+        if (auto* parameter = find(parameterID))
+        {
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        }
+    }
+
+private:
+    std::map<juce::String, juce::RangedAudioParameter*> parameters;
+
+    juce::RangedAudioParameter* find(const juce::String& parameterID) const
+    {
+        const auto found = parameters.find(parameterID);
+        return found != parameters.end() ? found->second : nullptr;
+    }
+};
+
+// Settings shared by every scenario: the Standard quality tier, so that the
+// offline renders do not switch to High
+inline void configureCommon(ParameterSetter& set)
+{
+    set.ifPresent("quality", 2.0f);
+}
+
+struct DelayScenario
+{
+    static constexpr const char* name = "delay";
+    static constexpr const char* automatedParameter = "chtime";
+    static constexpr float tolerance = 1.0e-5f;
+    static constexpr bool hasPipeline = true;
+
+    static void configure(ParameterSetter& set)
+    {
+        set("mastersync", 0.0f);
+        set("mastertime", 11.0f);
+        set("masterfeedback", 20.0f);
+        set("masterwet", 30.0f);
+
+        for (int ch = 1; ch <= MAX_CHANS; ++ch)
+        {
+            const juce::String chString(ch);
+            const auto variant = (float)((ch - 1) % channelVariants);
+            set("chsync" + chString, 0.0f);
+            set("chtime" + chString, 2.0f + 3.0f * variant);
+            set("chfeedback" + chString, 30.0f + 5.0f * variant);
+            set("chwet" + chString, 50.0f);
+        }
+    }
+
+    static void automate(ParameterSetter& set, float position)
+    {
+        for (int ch = 1; ch <= MAX_CHANS; ++ch)
+        {
+            set("chtime" + juce::String(ch), 1.0f + 39.0f * position);
+        }
+    }
+};
+
+struct FilterScenario
+{
+    static constexpr const char* name = "filter";
+    static constexpr const char* automatedParameter = "chcutoff";
+    static constexpr float tolerance = 1.0e-4f;
+    static constexpr bool hasPipeline = true;
+
+    static void configure(ParameterSetter& set)
+    {
+        set("mastertype", 1.0f);
+        set("mastercutoff", 8000.0f);
+        set("masterresonance", 10.0f);
+        set("masterdrive", 0.0f);
+
+        for (int ch = 1; ch <= MAX_CHANS; ++ch)
+        {
+            const juce::String chString(ch);
+            const auto variant = (ch - 1) % channelVariants;
+            set("chtype" + chString, (float)(1 + variant % 6));
+            set("chcutoff" + chString, 250.0f * (float)(variant + 1));
+            set("chresonance" + chString, 20.0f + 5.0f * (float)variant);
+            set("chdrive" + chString, 10.0f * (float)variant);
+        }
+    }
+
+    static void automate(ParameterSetter& set, float position)
+    {
+        for (int ch = 1; ch <= MAX_CHANS; ++ch)
+        {
+            set("chcutoff" + juce::String(ch), 100.0f * std::pow(100.0f, position));
+        }
+    }
+};
+
+struct GainScenario
+{
+    static constexpr const char* name = "gain";
+    static constexpr const char* automatedParameter = "chgain";
+    static constexpr float tolerance = 1.0e-6f;
+    static constexpr bool hasPipeline = false;
+
+    static void configure(ParameterSetter& set)
+    {
+        set("mastergain", -3.0f);
+
+        for (int ch = 1; ch <= MAX_CHANS; ++ch)
+        {
+            set("chgain" + juce::String(ch), -24.0f + 6.0f * (float)((ch - 1) % channelVariants));
+        }
+    }
+
+    static void automate(ParameterSetter& set, float position)
+    {
+        for (int ch = 1; ch <= MAX_CHANS; ++ch)
+        {
+            set("chgain" + juce::String(ch), -40.0f + 46.0f * position);
+        }
+    }
+};
+
+struct RingScenario
+{
+    static constexpr const char* name = "ring";
+    static constexpr const char* automatedParameter = "chfreq";
+    static constexpr float tolerance = 1.0e-4f;
+    static constexpr bool hasPipeline = true;
+
+    static void configure(ParameterSetter& set)
+    {
+        set("mastermod", 0.0f);
+        set("masterfreq", 60.0f);
+        set("mastermodch", 1.0f);
+        set("masterwet", 50.0f);
+
+        for (int ch = 1; ch <= MAX_CHANS; ++ch)
+        {
+            const juce::String chString(ch);
+            const auto variant = (ch - 1) % channelVariants;
+
+            // CH INPUT channels are modulated by the previous channel of their
+            // group, or by themselves for the first one, so that every group
+            // renders the same
+            set("chmod" + chString, (float)(variant % 5));
+            set("chfreq" + chString, 100.0f * (float)(variant + 1));
+            set("chmodch" + chString, (float)(variant == 0 ? ch : ch - 1));
+            set("chwet" + chString, 50.0f + 5.0f * (float)variant);
+        }
+    }
+
+    static void automate(ParameterSetter& set, float position)
+    {
+        for (int ch = 1; ch <= MAX_CHANS; ++ch)
+        {
+            set("chfreq" + juce::String(ch), 50.0f + 1950.0f * position);
+        }
+    }
+};
+
+// All four stages in their default order, each channel set up as in the
+// single plugin scenarios, with the filter cutoff automated
+struct ChainScenario
+{
+    static constexpr const char* name = "chain";
+    static constexpr const char* automatedParameter = "filterchcutoff";
+    static constexpr float tolerance = 1.0e-4f;
+    static constexpr bool hasPipeline = false;
+
+    static void configure(ParameterSetter& set)
+    {
+        set("order", 0.0f);
+        set("gainon", 1.0f);
+        set("filteron", 1.0f);
+        set("ringon", 1.0f);
+        set("delayon", 1.0f);
+
+        set("gainmastergain", -3.0f);
+        set("filtermastertype", 1.0f);
+        set("filtermastercutoff", 8000.0f);
+        set("filtermasterresonance", 10.0f);
+        set("ringmastermod", 0.0f);
+        set("ringmasterfreq", 60.0f);
+        set("ringmasterwet", 20.0f);
+        set("delaymastersync", 0.0f);
+        set("delaymastertime", 11.0f);
+        set("delaymasterfeedback", 20.0f);
+        set("delaymasterwet", 30.0f);
+
+        for (int ch = 1; ch <= MAX_CHANS; ++ch)
+        {
+            const juce::String chString(ch);
+            const auto variant = (ch - 1) % channelVariants;
+            set("gainchgain" + chString, -12.0f + 3.0f * (float)variant);
+            set("filterchtype" + chString, (float)(1 + variant % 6));
+            set("filterchcutoff" + chString, 500.0f * (float)(variant + 1));
+            set("filterchresonance" + chString, 20.0f + 5.0f * (float)variant);
+            set("filterchdrive" + chString, 10.0f * (float)variant);
+
+            // Oscillators only, so that the channels do not read each other
+            set("ringchmod" + chString, (float)(variant % 4));
+            set("ringchfreq" + chString, 100.0f * (float)(variant + 1));
+            set("ringchwet" + chString, 25.0f + 5.0f * (float)variant);
+            set("delaychsync" + chString, 0.0f);
+            set("delaychtime" + chString, 2.0f + 3.0f * (float)variant);
+            set("delaychfeedback" + chString, 30.0f + 5.0f * (float)variant);
+            set("delaychwet" + chString, 50.0f);
+        }
+    }
+
+    static void automate(ParameterSetter& set, float position)
+    {
+        for (int ch = 1; ch <= MAX_CHANS; ++ch)
+        {
+            set("filterchcutoff" + juce::String(ch), 100.0f * std::pow(100.0f, position));
+        }
+    }
+};
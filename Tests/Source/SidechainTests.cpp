@@ -0,0 +1,182 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <cmath>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "RingEngine.h"
+
+// A CH INPUT modulator reading a sidechain channel must modulate exactly
+// like one reading the same signal on the main input, also when the
+// sidechain is taken over several process() calls
+
+namespace
+{
+constexpr int numChannels = 4;
+constexpr int numSamples = 1000;
+constexpr int blockSize = 256;
+
+std::vector<float> signal(int index)
+{
+    std::vector<float> data(numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        data[(size_t)i] = std::sin(0.01f * (float)((index + 1) * i));
+    }
+
+    return data;
+}
+
+std::vector<float*> pointers(std::vector<std::vector<float>>& channels, int offset)
+{
+    std::vector<float*> result;
+
+    for (auto& channel : channels)
+    {
+        result.push_back(channel.data() + offset);
+    }
+
+    return result;
+}
+}
+
+TEST_CASE("Ring sidechain modulates like the main input", "[sidechain]")
+{
+    std::vector<std::vector<float>> direct;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        direct.push_back(signal(ch));
+    }
+    auto sidechained = direct;
+
+    RingEngine::Parameters parameters;
+    parameters.master.wet = 0.0f;
+    parameters.channels.at(0).mod = 4;
+    parameters.channels.at(0).wet = 100.0f;
+    parameters.channels.at(1).mod = 4;
+    parameters.channels.at(1).wet = 50.0f;
+
+    RingEngine directEngine;
+    directEngine.prepare(48000.0, blockSize, numChannels);
+    parameters.channels.at(0).modCh = 3;
+    parameters.channels.at(1).modCh = 4;
+    directEngine.setParameters(parameters);
+    directEngine.jumpToTargets();
+
+    // The sidechain holds the third and fourth inputs, in the other order
+    const std::vector<std::vector<float>> sidechain{signal(3), signal(2)};
+    const std::vector<const float*> sidechainPointers{sidechain[0].data(), sidechain[1].data()};
+
+    RingEngine sidechainEngine;
+    sidechainEngine.prepare(48000.0, blockSize, numChannels, 2);
+    parameters.channels.at(0).modCh = 2;
+    parameters.channels.at(0).sidechain = true;
+    parameters.channels.at(1).modCh = 1;
+    parameters.channels.at(1).sidechain = true;
+    sidechainEngine.setParameters(parameters);
+    sidechainEngine.jumpToTargets();
+
+    auto directPointers = pointers(direct, 0);
+    directEngine.process(directPointers.data(), numChannels, numSamples);
+
+    // Taken in order over two calls, the second one split into chunks
+    sidechainEngine.setSidechain(sidechainPointers.data(), 2);
+    auto first = pointers(sidechained, 0);
+    sidechainEngine.process(first.data(), numChannels, 300);
+    auto second = pointers(sidechained, 300);
+    sidechainEngine.process(second.data(), numChannels, numSamples - 300);
+
+    float maxError = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            maxError = std::max(maxError, std::abs(direct[(size_t)ch][(size_t)i] - sidechained[(size_t)ch][(size_t)i]));
+        }
+    }
+
+    CHECK(maxError < 1.0e-6f);
+}
+
+TEST_CASE("Ring sidechain channels beyond the prepared ones are silent", "[sidechain]")
+{
+    auto channels = std::vector<std::vector<float>>{signal(0)};
+    const auto modulator = signal(1);
+    const std::vector<const float*> sidechainPointers{modulator.data(), modulator.data()};
+
+    RingEngine::Parameters parameters;
+    parameters.master.wet = 0.0f;
+    parameters.channels.at(0).mod = 4;
+    parameters.channels.at(0).modCh = 2;
+    parameters.channels.at(0).sidechain = true;
+    parameters.channels.at(0).wet = 100.0f;
+
+    RingEngine engine;
+    engine.prepare(48000.0, blockSize, 1, 1);
+    engine.setParameters(parameters);
+    engine.jumpToTargets();
+    engine.setSidechain(sidechainPointers.data(), 2);
+
+    auto channelPointers = pointers(channels, 0);
+    engine.process(channelPointers.data(), 1, numSamples);
+
+    float peak = 0.0f;
+    for (const float sample : channels[0])
+    {
+        peak = std::max(peak, std::abs(sample));
+    }
+
+    CHECK(peak == 0.0f);
+}
+
+TEST_CASE("Ring stages choose the main input or the sidechain", "[sidechain]")
+{
+    std::vector<std::vector<float>> channels{signal(0), signal(1)};
+    const auto input = channels;
+    const auto modulator = signal(5);
+    const std::vector<const float*> sidechainPointers{modulator.data()};
+
+    // Both read their first channel, of the sidechain and of the main input
+    RingEngine::Parameters parameters;
+    parameters.master.wet = 0.0f;
+    parameters.channels.at(0).mod = 4;
+    parameters.channels.at(0).modCh = 1;
+    parameters.channels.at(0).sidechain = true;
+    parameters.channels.at(0).wet = 100.0f;
+    parameters.channels.at(1).mod = 4;
+    parameters.channels.at(1).modCh = 1;
+    parameters.channels.at(1).wet = 100.0f;
+
+    RingEngine engine;
+    engine.prepare(48000.0, blockSize, 2, 1);
+    engine.setParameters(parameters);
+    engine.jumpToTargets();
+    engine.setSidechain(sidechainPointers.data(), 1);
+
+    auto channelPointers = pointers(channels, 0);
+    engine.process(channelPointers.data(), 2, numSamples);
+
+    float maxError = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        maxError = std::max(maxError, std::abs(channels[0][(size_t)i] - input[0][(size_t)i] * modulator[(size_t)i]));
+        maxError = std::max(maxError, std::abs(channels[1][(size_t)i] - input[1][(size_t)i] * input[0][(size_t)i]));
+    }
+
+    CHECK(maxError < 1.0e-5f);
+}
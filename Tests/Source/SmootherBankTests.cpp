@@ -0,0 +1,117 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "SmootherBank.h"
+
+// The bank replaces juce::SmoothedValue in the engines, so it must follow the
+// same linear ramps whatever the block size it is rendered with
+
+TEST_CASE("Smoother bank follows juce::SmoothedValue", "[smoothers]")
+{
+    constexpr int numSmoothers = 70;
+    constexpr int maxBlockSize = 256;
+    constexpr double sampleRate = 48000.0;
+    constexpr double rampSeconds = 0.05;
+
+    const int blockSize = GENERATE(1, 31, 256);
+    INFO(blockSize << " samples");
+
+    SmootherBank bank;
+    bank.prepare(numSmoothers, maxBlockSize, sampleRate, rampSeconds);
+
+    std::array<juce::SmoothedValue<float>, numSmoothers> references;
+    for (int i = 0; i < numSmoothers; ++i)
+    {
+        references.at((size_t)i).reset(sampleRate, rampSeconds);
+        references.at((size_t)i).setCurrentAndTargetValue((float)i);
+        bank.setCurrentAndTarget(i, (float)i);
+    }
+
+    juce::Random random(0x5eed);
+    float maxError = 0.0f;
+
+    for (int position = 0; position < 48000; position += blockSize)
+    {
+        // Every 1000 samples, a third of the smoothers get a new target
+        if (position / 1000 != (position + blockSize) / 1000)
+        {
+            for (int i = random.nextInt(3); i < numSmoothers; i += 3)
+            {
+                const float target = random.nextFloat() * 100.0f;
+                references.at((size_t)i).setTargetValue(target);
+                bank.setTarget(i, target);
+            }
+        }
+
+        bank.render(numSmoothers, blockSize);
+
+        for (int i = 0; i < numSmoothers; ++i)
+        {
+            const float* ramp = bank.getRamp(i);
+
+            for (int k = 0; k < blockSize; ++k)
+            {
+                const float expected = references.at((size_t)i).getNextValue();
+                const float actual = ramp != nullptr ? ramp[k] : bank.getCurrentValue(i);
+                maxError = std::max(maxError, std::abs(actual - expected));
+            }
+
+            REQUIRE(bank.isSmoothing(i) == references.at((size_t)i).isSmoothing());
+        }
+    }
+
+    // SmoothedValue accumulates its steps while the bank computes them in
+    // closed form, so they only part by float rounding
+    CHECK(maxError <= 1.0e-2f);
+}
+
+TEST_CASE("Settled smoothers are skipped", "[smoothers]")
+{
+    SmootherBank bank;
+    bank.prepare(130, 64, 48000.0, 0.001);
+
+    bank.setTarget(3, 1.0f);
+    bank.setTarget(129, -1.0f);
+    bank.render(130, 64);
+
+    for (int i = 0; i < 130; ++i)
+    {
+        CHECK((bank.getRamp(i) != nullptr) == (i == 3 || i == 129));
+    }
+
+    // 48 samples of ramp, then the target until the end of the block
+    CHECK(bank.getRamp(3)[47] == 1.0f);
+    CHECK(bank.getRamp(129)[63] == -1.0f);
+    CHECK(!bank.isSmoothing(3));
+
+    // Nothing moves once the targets are reached
+    bank.render(130, 64);
+
+    for (int i = 0; i < 130; ++i)
+    {
+        CHECK(bank.getRamp(i) == nullptr);
+    }
+
+    CHECK(bank.getCurrentValue(3) == 1.0f);
+}
@@ -0,0 +1,138 @@
+/******************************************************************************
+This file is part of Plug64.
+Copyright 2024-2025 Valerio Orlandini <valeriorlandini@gmail.com>.
+
+Plug64 is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+
+Plug64 is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+Plug64. If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "PresetBank.h"
+
+// Fixed test signals. Everything is generated with plain arithmetic and a
+// local xorshift generator, so the stimulus is identical on every platform
+// and standard library.
+
+enum class Stimulus
+{
+    impulse,
+    sweep,
+    noise,
+    automation
+};
+
+inline const char* getStimulusName(Stimulus stimulus)
+{
+    switch (stimulus)
+    {
+        case Stimulus::impulse:
+            return "impulse";
+        case Stimulus::sweep:
+            return "sweep";
+        case Stimulus::noise:
+            return "noise";
+        case Stimulus::automation:
+            return "automation";
+    }
+
+    return "";
+}
+
+// Channels are configured in groups of this size, so that a channel renders
+// the same whatever the total channel count
+static constexpr int channelVariants = 8;
+
+static constexpr double pi = 3.14159265358979323846;
+static constexpr double renderSampleRate = 48000.0;
+static constexpr int renderLength = 4096;
+
+// Automation is applied every controlInterval samples, independently of the
+// host block size, and no more often than the plugins read the parameters
+// within a block, so that the blocks never ramp them
+static constexpr int controlInterval = PresetBank::controlInterval > 0 ? PresetBank::controlInterval : 64;
+
+struct Render
+{
+    int numChannels = 0;
+    int numSamples = 0;
+    std::vector<float> samples;
+
+    Render(int channels, int length) :
+        numChannels(channels),
+        numSamples(length),
+        samples((size_t)channels * (size_t)length, 0.0f)
+    {
+    }
+
+    float* channel(int ch)
+    {
+        return samples.data() + (size_t)ch * (size_t)numSamples;
+    }
+
+    const float* channel(int ch) const
+    {
+        return samples.data() + (size_t)ch * (size_t)numSamples;
+    }
+};
+
+inline void fillStimulus(Render& render, Stimulus stimulus)
+{
+    for (int ch = 0; ch < render.numChannels; ++ch)
+    {
+        const int variant = ch % channelVariants;
+        float* data = render.channel(ch);
+
+        switch (stimulus)
+        {
+            case Stimulus::impulse:
+                data[16 * variant] = 1.0f;
+                break;
+
+            case Stimulus::sweep:
+            {
+                // Exponential sine sweep from 20 Hz to 20 kHz
+                const double ratio = std::log(1000.0);
+                const double duration = (double)render.numSamples / renderSampleRate;
+                const double phaseOffset = 0.25 * (double)variant;
+
+                for (int i = 0; i < render.numSamples; ++i)
+                {
+                    const double t = (double)i / renderSampleRate;
+                    const double phase = 2.0 * pi * 20.0 * duration / ratio * (std::exp(t / duration * ratio) - 1.0);
+                    data[i] = 0.5f * (float)std::sin(phase + phaseOffset);
+                }
+                break;
+            }
+
+            case Stimulus::noise:
+            case Stimulus::automation:
+            {
+                std::uint32_t state = 0x9e3779b9u + (std::uint32_t)variant;
+
+                for (int i = 0; i < render.numSamples; ++i)
+                {
+                    state ^= state << 13;
+                    state ^= state >> 17;
+                    state ^= state << 5;
+                    data[i] = (float)((double)state / 4294967295.0 - 0.5);
+                }
+                break;
+            }
+        }
+    }
+}